@@ -6,7 +6,7 @@ find_path(FFTW_INCLUDE_DIR
     )
 
 find_library(FFTW_LIBRARIES
-    NAMES fftw3
+    NAMES ${FFTW_MODULE}
     PATHS ${FFTW_LIBRARY_DIRS}
     )
 
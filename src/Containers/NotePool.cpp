@@ -331,7 +331,9 @@ void NotePool::kill(NoteDescriptor &d)
 void NotePool::kill(SynthDescriptor &s)
 {
     //printf("Kill synth...\n");
-    s.note->memory.dealloc(s.note);
+    const uint64_t t = NoteStats::ticks();
+    SynthNote::destroy(s.note);
+    stats.add(NoteStats::Kill, NoteStats::ticks() - t);
     needs_cleaning = true;
 }
 
@@ -13,6 +13,7 @@
 #include <stdint.h>
 #include <functional>
 #include "../globals.h"
+#include "../Misc/NoteStats.h"
 
 //Expected upper bound of synths given that max polyphony is hit
 #define EXPECTED_USAGE 3
@@ -58,6 +59,7 @@ class NotePool
             SynthNote *note;
             uint8_t type;
             uint8_t kit;
+            bool    rendered; //noteout() was called at least once
         };
 
 
@@ -66,6 +68,9 @@ class NotePool
         SynthDescriptor  sdesc[POLYPHONY*EXPECTED_USAGE];
         bool             needs_cleaning;
 
+        //Cost of creating, first rendering and killing the notes
+        NoteStats        stats;
+
 
         //Iterators
         struct activeNotesIter {
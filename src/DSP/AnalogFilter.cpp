@@ -19,9 +19,13 @@
 
 #include "../Misc/Util.h"
 #include "AnalogFilter.h"
+#include "AnalogKernels.h"
 
 namespace zyn {
 
+//Picked at startup
+static const AnalogLanes analogLanes = analogLanesKernel();
+
 AnalogFilter::AnalogFilter(unsigned char Ftype,
                            float Ffreq,
                            float Fq,
@@ -63,17 +67,15 @@ void AnalogFilter::cleanup()
     needsinterpolation = false;
 }
 
-AnalogFilter::Coeff AnalogFilter::computeCoeff(int type, float cutoff, float q,
-        int stages, float gain, float fs, int &order)
+//Keeps the cutoff below nyquist, the filter lets everything (or nothing)
+//through past it
+static float limitCutoff(float cutoff, float fs, bool &zerocoefs)
 {
-    AnalogFilter::Coeff coeff;
-    bool  zerocoefs = false; //this is used if the freq is too high
-
-    const float samplerate_f = fs;
     const float halfsamplerate_f = fs/2;
 
     //do not allow frequencies bigger than samplerate/2
     float freq = cutoff;
+    zerocoefs = false;
     if(freq > (halfsamplerate_f - 500.0f)) {
         freq      = halfsamplerate_f - 500.0f;
         zerocoefs = true;
@@ -81,28 +83,36 @@ AnalogFilter::Coeff AnalogFilter::computeCoeff(int type, float cutoff, float q,
 
     if(freq < 0.1f)
         freq = 0.1f;
+    return freq;
+}
 
-    //do not allow bogus Q
-    if(q < 0.0f)
-        q = 0.0f;
+//The q of each stage
+static float stageq(float q, int stages)
+{
+    if(stages == 0 || q <= 1.0f)
+        return q;
+    return powf(q, 1.0f / (stages + 1));
+}
 
+//The gain of each stage
+static float stagegain(float gain, int stages)
+{
+    if(stages == 0)
+        return gain;
+    return powf(gain, 1.0f / (stages + 1));
+}
 
-    float tmpq, tmpgain;
-    if(stages == 0) {
-        tmpq    = q;
-        tmpgain = gain;
-    } else {
-        tmpq    = (q > 1.0f) ? powf(q, 1.0f / (stages + 1)) : q;
-        tmpgain = powf(gain, 1.0f / (stages + 1));
-    }
+static AnalogFilter::Coeff designCoeff(int type, bool zerocoefs, float tmpq,
+        float tmpgain, const FilterTrig &trig, int &order)
+{
+    AnalogFilter::Coeff coeff;
 
     //Alias Terms
     float *c = coeff.c;
     float *d = coeff.d;
 
     //General Constants
-    const float omega = 2 * PI * freq / samplerate_f;
-    const float sn    = sinf(omega), cs = cosf(omega);
+    const float sn = trig.sn, cs = trig.cs;
     float       alpha, beta;
 
     //most of theese are implementations of
@@ -115,7 +125,7 @@ AnalogFilter::Coeff AnalogFilter::computeCoeff(int type, float cutoff, float q,
     switch(type) {
         case 0: //LPF 1 pole
             if(!zerocoefs)
-                tmp = expf(-2.0f * PI * freq / samplerate_f);
+                tmp = trig.ex;
             else
                 tmp = 0.0f;
             c[0]  = 1.0f - tmp;
@@ -127,7 +137,7 @@ AnalogFilter::Coeff AnalogFilter::computeCoeff(int type, float cutoff, float q,
             break;
         case 1: //HPF 1 pole
             if(!zerocoefs)
-                tmp = expf(-2.0f * PI * freq / samplerate_f);
+                tmp = trig.ex;
             else
                 tmp = 0.0f;
             c[0]  = (1.0f + tmp) / 2.0f;
@@ -260,10 +270,37 @@ AnalogFilter::Coeff AnalogFilter::computeCoeff(int type, float cutoff, float q,
     return coeff;
 }
 
+AnalogFilter::Coeff AnalogFilter::computeCoeff(int type, float cutoff, float q,
+        int stages, float gain, float fs, int &order)
+{
+    bool zerocoefs;
+    const float freq = limitCutoff(cutoff, fs, zerocoefs);
+
+    //do not allow bogus Q
+    if(q < 0.0f)
+        q = 0.0f;
+
+    return designCoeff(type, zerocoefs, stageq(q, stages),
+                       stagegain(gain, stages), filterTrigExact(freq, fs),
+                       order);
+}
+
+//Same as computeCoeff(), with the trigonometry from the shared table and the
+//roots kept until q, gain or the stages change
 void AnalogFilter::computefiltercoefs(void)
 {
-    coeff = AnalogFilter::computeCoeff(type, freq, q, stages, gain,
-            samplerate_f, order);
+    bool zerocoefs;
+    const float f  = limitCutoff(freq, samplerate_f, zerocoefs);
+    const float q_ = q < 0.0f ? 0.0f : q;
+
+    const float tmpq    = qcache.get(q_, stages, [&]() {
+            return stageq(q_, stages);
+        });
+    const float tmpgain = gaincache.get(gain, stages, [&]() {
+            return stagegain(gain, stages);
+        });
+    coeff = designCoeff(type, zerocoefs, tmpq, tmpgain,
+                        filterTrig(f, samplerate_f), order);
 }
 
 
@@ -383,19 +420,23 @@ void AnalogFilter::singlefilterout(float *smp, fstage &hist,
     }
 }
 
-void AnalogFilter::filterout(float *smp)
+void AnalogFilter::filterchains(const AnalogChain *chains, int nchains)
 {
-    for(int i = 0; i < stages + 1; ++i)
-        singlefilterout(smp, history[i], coeff);
+    //With a single stage the lanes have too little to overlap to beat the
+    //scalar loop, even for both channels
+    if(analogLanes && (order == 1 || order == 2) && stages > 0)
+        analogLanes(chains, nchains, stages + 1, order, buffersize);
+    else
+        for(int k = 0; k < nchains; ++k)
+            for(int i = 0; i < stages + 1; ++i)
+                singlefilterout(chains[k].smp, chains[k].hist[i],
+                                *chains[k].coeff);
+}
 
+void AnalogFilter::finishout(float *smp, const float *ismp)
+{
     if(needsinterpolation) {
         //Merge Filter at old coeff with new coeff
-        float ismp[buffersize];
-        memcpy(ismp, smp, bufferbytes);
-
-        for(int i = 0; i < stages + 1; ++i)
-            singlefilterout(ismp, oldHistory[i], oldCoeff);
-
         for(int i = 0; i < buffersize; ++i) {
             float x = (float)i / buffersize_f;
             smp[i] = ismp[i] * (1.0f - x) + smp[i] * x;
@@ -407,6 +448,53 @@ void AnalogFilter::filterout(float *smp)
         smp[i] *= outgain;
 }
 
+void AnalogFilter::filterout(float *smp)
+{
+    AnalogChain chain = {smp, &coeff, history};
+    filterchains(&chain, 1);
+
+    //The filter at the old coeff runs on a copy of the output at the new one
+    float ismp[buffersize];
+    if(needsinterpolation) {
+        memcpy(ismp, smp, bufferbytes);
+        AnalogChain old = {ismp, &oldCoeff, oldHistory};
+        filterchains(&old, 1);
+    }
+    finishout(smp, ismp);
+}
+
+void AnalogFilter::filterout_stereo(float *smpl, Filter &right, float *smpr)
+{
+    AnalogFilter *r = dynamic_cast<AnalogFilter *>(&right);
+    if(!r || r->stages != stages || r->order != order
+       || r->buffersize != buffersize) {
+        Filter::filterout_stereo(smpl, right, smpr);
+        return;
+    }
+
+    //Both channels side by side, then (like filterout()) the filters at the
+    //old coeffs on copies of their output
+    AnalogChain chains[2] = {{smpl, &coeff, history},
+                             {smpr, &r->coeff, r->history}};
+    filterchains(chains, 2);
+
+    float ismpl[buffersize], ismpr[buffersize];
+    int   nold = 0;
+    if(needsinterpolation) {
+        memcpy(ismpl, smpl, bufferbytes);
+        chains[nold++] = {ismpl, &oldCoeff, oldHistory};
+    }
+    if(r->needsinterpolation) {
+        memcpy(ismpr, smpr, bufferbytes);
+        chains[nold++] = {ismpr, &r->oldCoeff, r->oldHistory};
+    }
+    if(nold)
+        filterchains(chains, nold);
+
+    finishout(smpl, ismpl);
+    r->finishout(smpr, ismpr);
+}
+
 float AnalogFilter::H(float freq)
 {
     float fr = freq / samplerate_f * PI * 2.0f;
@@ -18,9 +18,12 @@
 
 #include "../globals.h"
 #include "Filter.h"
+#include "FilterTables.h"
 
 namespace zyn {
 
+struct AnalogChain;
+
 /**Implementation of Several analog filters (lowpass, highpass...)
  * Implemented with IIR filters
  * Coefficients generated with "Cookbook formulae for audio EQ"*/
@@ -31,6 +34,7 @@ class AnalogFilter:public Filter
                      unsigned char Fstages, unsigned int srate, int bufsize);
         ~AnalogFilter();
         void filterout(float *smp);
+        void filterout_stereo(float *smpl, Filter &right, float *smpr);
         void setfreq(float frequency);
         void setfreq_and_q(float frequency, float q_);
         void setq(float q_);
@@ -51,16 +55,22 @@ class AnalogFilter:public Filter
         static Coeff computeCoeff(int type, float cutoff, float q, int stages,
                 float gain, float fs, int &order);
 
-    private:
         struct fstage {
             float x1, x2; //Input History
             float y1, y2; //Output History
-        } history[MAX_FILTER_STAGES + 1], oldHistory[MAX_FILTER_STAGES + 1];
+        };
+
+    private:
+        fstage history[MAX_FILTER_STAGES + 1], oldHistory[MAX_FILTER_STAGES + 1];
 
         //old coeffs are used for interpolation when paremeters change quickly
 
         //Apply IIR filter to Samples, with coefficients, and past history
         void singlefilterout(float *smp, fstage &hist, const Coeff &coeff);
+        //Filter the chains (see AnalogKernels.h) through all stages
+        void filterchains(const AnalogChain *chains, int nchains);
+        //Mix in the output at the old coeffs (if any) and apply the gain
+        void finishout(float *smp, const float *ismp);
         //Update coeff and order
         void computefiltercoefs(void);
 
@@ -72,6 +82,8 @@ class AnalogFilter:public Filter
 
         int order; //the order of the filter (number of poles)
 
+        StageCache qcache, gaincache; //q and gain of each stage
+
         bool needsinterpolation,      //Interpolation between coeff changes
              firsttime;               //First Iteration of filter
         bool abovenq,                 //if the frequency is above the nyquist
@@ -0,0 +1,150 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  AnalogKernels.cpp - Vectorized Stage Cascades For AnalogFilter
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <climits>
+#include <cstddef>
+#include "AnalogKernels.h"
+#include "../Misc/Simd.h"
+
+namespace zyn {
+
+#if defined(ZYN_SIMD_AVX2) && defined(ZYN_SIMD_VECTOR)
+
+static_assert(ANALOG_LANES == 8, "the lanes are a vfloat8");
+
+//Output of the stage before each lane
+static ZYN_KERNEL void previous(const vfloat8 &y, vfloat8 *out)
+{
+#ifdef __clang__
+    *out = __builtin_shufflevector(y, y, 0, 0, 1, 2, 3, 4, 5, 6);
+#else
+    *out = __builtin_shuffle(y, (vint8){0, 0, 1, 2, 3, 4, 5, 6});
+#endif
+}
+
+/*
+ * Step t of the wavefront. Lanes are only partially active while the
+ * wavefront enters and leaves the buffer (Masked); in between every lane
+ * takes its sample.
+ */
+template<bool Masked>
+static ZYN_KERNEL void analogStep(const AnalogChain *chains, int nchains,
+                                  int nstages, int n, int t,
+                                  const vfloat8 *c, const vfloat8 &later,
+                                  const vint8 &lo, const vint8 &hi,
+                                  vfloat8 &x1, vfloat8 &x2,
+                                  vfloat8 &y1, vfloat8 &y2)
+{
+    vfloat8 in = {0, 0, 0, 0, 0, 0, 0, 0};
+    if(!Masked || t < n)
+        for(int k = 0; k < nchains; ++k)
+            in[k * nstages] = chains[k].smp[t];
+
+    vfloat8 prev;
+    previous(y1, &prev);
+    const vfloat8 x = in + later * prev;
+    const vfloat8 y = x * c[0] + x1 * c[1] + x2 * c[2] + y1 * c[3]
+                      + y2 * c[4];
+    if(Masked) {
+        const vint8 tv = {t, t, t, t, t, t, t, t};
+        const vint8 on = (tv >= lo) & (tv < hi);
+        vselect(on, x1, &x2);
+        vselect(on, x, &x1);
+        vselect(on, y1, &y2);
+        vselect(on, y, &y1);
+    }
+    else {
+        x2 = x1;
+        x1 = x;
+        y2 = y1;
+        y1 = y;
+    }
+
+    if(t >= nstages - 1)
+        for(int k = 0; k < nchains; ++k)
+            chains[k].smp[t - nstages + 1] = y1[k * nstages + nstages - 1];
+}
+
+static ZYN_KERNEL void analogBody(const AnalogChain *chains, int nchains,
+                                  int nstages, int order, int n)
+{
+    vfloat8 c[5], later, x1, x2, y1, y2;
+    vint8   lo, hi;
+    for(int l = 0; l < ANALOG_LANES; ++l) {
+        const int k = l / nstages, s = l % nstages;
+        if(k < nchains) {
+            const AnalogFilter::Coeff  &co = *chains[k].coeff;
+            const AnalogFilter::fstage &h  = chains[k].hist[s];
+            c[0][l] = co.c[0];
+            c[1][l] = co.c[1];
+            c[2][l] = order == 2 ? co.c[2] : 0.0f;
+            c[3][l] = co.d[1];
+            c[4][l] = order == 2 ? co.d[2] : 0.0f;
+            x1[l] = h.x1;
+            x2[l] = h.x2;
+            y1[l] = h.y1;
+            y2[l] = h.y2;
+            lo[l] = s;
+            hi[l] = n + s;
+        }
+        else { //idle
+            for(int i = 0; i < 5; ++i)
+                c[i][l] = 0.0f;
+            x1[l] = x2[l] = y1[l] = y2[l] = 0.0f;
+            lo[l] = INT_MAX;
+            hi[l] = 0;
+        }
+        later[l] = s != 0;
+    }
+
+    int t = 0;
+    for(; t < nstages - 1; ++t)
+        analogStep<true>(chains, nchains, nstages, n, t, c, later, lo, hi,
+                         x1, x2, y1, y2);
+    for(; t < n; ++t)
+        analogStep<false>(chains, nchains, nstages, n, t, c, later, lo, hi,
+                          x1, x2, y1, y2);
+    for(; t < n + nstages - 1; ++t)
+        analogStep<true>(chains, nchains, nstages, n, t, c, later, lo, hi,
+                         x1, x2, y1, y2);
+
+    for(int k = 0; k < nchains; ++k)
+        for(int s = 0; s < nstages; ++s) {
+            const int l = k * nstages + s;
+            AnalogFilter::fstage &h = chains[k].hist[s];
+            h.x1 = x1[l];
+            h.x2 = x2[l];
+            h.y1 = y1[l];
+            h.y2 = y2[l];
+        }
+}
+
+ZYN_TARGET_AVX2
+static void analogLanesAVX2(const AnalogChain *chains, int nchains,
+                            int nstages, int order, int n)
+{
+    const int group = ANALOG_LANES / nstages;
+    for(int k = 0; k < nchains; k += group)
+        analogBody(chains + k, nchains - k < group ? nchains - k : group,
+                   nstages, order, n);
+}
+#endif
+
+AnalogLanes analogLanesKernel(void)
+{
+#if defined(ZYN_SIMD_AVX2) && defined(ZYN_SIMD_VECTOR)
+    if(cpuHasAVX2())
+        return analogLanesAVX2;
+#endif
+    return NULL;
+}
+
+}
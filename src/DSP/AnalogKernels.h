@@ -0,0 +1,43 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  AnalogKernels.h - Vectorized Stage Cascades For AnalogFilter
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include "AnalogFilter.h"
+
+namespace zyn {
+
+//Stages (of all chains) filtered side by side by the kernel
+#define ANALOG_LANES 8
+
+/**
+ * The stage cascade of an AnalogFilter over one buffer
+ */
+struct AnalogChain
+{
+    float *smp; //filtered in place
+    const AnalogFilter::Coeff *coeff;
+    AnalogFilter::fstage *hist; //one per stage
+};
+
+/**
+ * Filters every chain through nstages stages of the given order.
+ *
+ * Each stage of each chain takes a lane; stage s works on sample t - s while
+ * the first one reads sample t, so all stages advance together.
+ */
+typedef void (*AnalogLanes)(const AnalogChain *chains, int nchains,
+                            int nstages, int order, int n);
+
+//Kernel for this CPU, or NULL where one stage at a time is faster (the
+//lanes only pay off with AVX2)
+AnalogLanes analogLanesKernel(void);
+
+}
@@ -14,84 +14,198 @@
 #include <cmath>
 #include <cassert>
 #include <cstring>
-#include <pthread.h>
+#include <map>
+#include <mutex>
 #include "FFTwrapper.h"
+#include "../Misc/RenderPool.h"
 
 namespace zyn {
 
-static pthread_mutex_t *mutex = NULL;
+//Plans of one size, shared by every FFTwrapper of that size. A wrapper runs
+//them on its own buffers, which are aligned like the ones planned with
+struct FFTplans {
+    FFTW(plan) forward, inverse;
+};
 
-FFTwrapper::FFTwrapper(int fftsize_)
-{
-    //first one will spawn the mutex (yeah this may be a race itself)
-    if(!mutex) {
-        mutex = new pthread_mutex_t;
-        pthread_mutex_init(mutex, NULL);
-    }
+//The planner (unlike the execution of plans) is not thread safe
+static std::mutex              planLock;
+static std::map<int, FFTplans> plans;
+static bool                    measure = false;
 
+static FFTplans getPlans(int size)
+{
+    std::lock_guard<std::mutex> guard(planLock);
+    auto itr = plans.find(size);
+    if(itr != plans.end())
+        return itr->second;
+
+    //FFTW_MEASURE overwrites the arrays while planning
+    fftw_real     *time = (fftw_real *)FFTW(malloc)(size * sizeof(fftw_real));
+    FFTW(complex) *fft  = (FFTW(complex) *)FFTW(malloc)((size / 2 + 1)
+                                                        * sizeof(FFTW(complex)));
+    const unsigned flags = measure ? FFTW_MEASURE : FFTW_ESTIMATE;
+    FFTplans p;
+    p.forward = FFTW(plan_dft_r2c_1d)(size, time, fft, flags);
+    p.inverse = FFTW(plan_dft_c2r_1d)(size, fft, time, flags);
+    FFTW(free)(time);
+    FFTW(free)(fft);
+    plans[size] = p;
+    return p;
+}
 
+FFTwrapper::FFTwrapper(int fftsize_)
+{
     fftsize  = fftsize_;
-    time     = new fftw_real[fftsize];
-    fft      = new fftw_complex[fftsize + 1];
-    pthread_mutex_lock(mutex);
-    planfftw = fftw_plan_dft_r2c_1d(fftsize,
-                                    time,
-                                    fft,
-                                    FFTW_ESTIMATE);
-    planfftw_inv = fftw_plan_dft_c2r_1d(fftsize,
-                                        fft,
-                                        time,
-                                        FFTW_ESTIMATE);
-    pthread_mutex_unlock(mutex);
+    scratch  = new Scratch[1];
+    scratch[0] = newScratch();
+    nscratch = 1;
+    shared   = false;
+    const FFTplans p = getPlans(fftsize);
+    planfftw     = p.forward;
+    planfftw_inv = p.inverse;
 }
 
 FFTwrapper::~FFTwrapper()
 {
-    pthread_mutex_lock(mutex);
-    fftw_destroy_plan(planfftw);
-    fftw_destroy_plan(planfftw_inv);
-    pthread_mutex_unlock(mutex);
+    for(int i = 0; i < nscratch; ++i)
+        deleteScratch(scratch[i]);
+    delete [] scratch;
+}
+
+FFTwrapper::Scratch FFTwrapper::newScratch(void) const
+{
+    Scratch s;
+    s.time = (fftw_real *)FFTW(malloc)(fftsize * sizeof(fftw_real));
+    s.fft  = (FFTW(complex) *)FFTW(malloc)((fftsize / 2 + 1)
+                                           * sizeof(FFTW(complex)));
+    return s;
+}
+
+void FFTwrapper::deleteScratch(Scratch &s)
+{
+    FFTW(free)(s.time);
+    FFTW(free)(s.fft);
+}
+
+void FFTwrapper::shareWithRenderThreads(int workers)
+{
+    for(int i = 1; i < nscratch; ++i)
+        deleteScratch(scratch[i]);
+    Scratch *s = new Scratch[workers + 1];
+    s[0] = scratch[0];
+    for(int i = 1; i <= workers; ++i)
+        s[i] = newScratch();
+    delete [] scratch;
+    scratch  = s;
+    nscratch = workers + 1;
+    shared   = true;
+}
 
-    delete [] time;
-    delete [] fft;
+FFTwrapper::Scratch *FFTwrapper::scratchOf(void)
+{
+    if(!shared)
+        return scratch;
+    const int t = RenderPool::current();
+    return t < 0 ? NULL : scratch + (t < nscratch ? t : 0);
 }
 
 void FFTwrapper::smps2freqs(const float *smps, fft_t *freqs)
 {
-    //Load data
-    for(int i = 0; i < fftsize; ++i)
-        time[i] = static_cast<double>(smps[i]);
+    Scratch *s = scratchOf();
+    if(s) {
+        smps2freqs(*s, smps, freqs);
+        return;
+    }
+    Scratch tmp = newScratch();
+    smps2freqs(tmp, smps, freqs);
+    deleteScratch(tmp);
+}
+
+void FFTwrapper::freqs2smps(const fft_t *freqs, float *smps)
+{
+    Scratch *s = scratchOf();
+    if(s) {
+        freqs2smps(*s, freqs, smps);
+        return;
+    }
+    Scratch tmp = newScratch();
+    freqs2smps(tmp, freqs, smps);
+    deleteScratch(tmp);
+}
 
-    //DFT
-    fftw_execute(planfftw);
+void FFTwrapper::smps2freqs(Scratch &s, const float *smps, fft_t *freqs)
+{
+#ifdef FFTW_SINGLE_PRECISION
+    //DFT straight from the samples (the plan leaves its input alone)
+    if(FFTW(alignment_of)((float *)smps) == FFTW(alignment_of)(s.time))
+        FFTW(execute_dft_r2c)(planfftw, (float *)smps, s.fft);
+    else
+#endif
+    {
+        //Load data
+        for(int i = 0; i < fftsize; ++i)
+            s.time[i] = static_cast<fftw_real>(smps[i]);
+
+        //DFT
+        FFTW(execute_dft_r2c)(planfftw, s.time, s.fft);
+    }
 
     //Grab data
-    memcpy((void *)freqs, (const void *)fft, fftsize * sizeof(double));
+    memcpy((void *)freqs, (const void *)s.fft, fftsize / 2 * sizeof(fft_t));
 }
 
-void FFTwrapper::freqs2smps(const fft_t *freqs, float *smps)
+void FFTwrapper::freqs2smps(Scratch &s, const fft_t *freqs, float *smps)
 {
-    //Load data
-    memcpy((void *)fft, (const void *)freqs, fftsize * sizeof(double));
+    //Load data (the inverse transform overwrites its input)
+    memcpy((void *)s.fft, (const void *)freqs, fftsize / 2 * sizeof(fft_t));
 
     //clear unused freq channel
-    fft[fftsize / 2][0] = 0.0f;
-    fft[fftsize / 2][1] = 0.0f;
+    s.fft[fftsize / 2][0] = 0.0f;
+    s.fft[fftsize / 2][1] = 0.0f;
+
+#ifdef FFTW_SINGLE_PRECISION
+    //IDFT straight into the samples
+    if(FFTW(alignment_of)(smps) == FFTW(alignment_of)(s.time)) {
+        FFTW(execute_dft_c2r)(planfftw_inv, s.fft, smps);
+        return;
+    }
+#endif
 
     //IDFT
-    fftw_execute(planfftw_inv);
+    FFTW(execute_dft_c2r)(planfftw_inv, s.fft, s.time);
 
     //Grab data
     for(int i = 0; i < fftsize; ++i)
-        smps[i] = static_cast<float>(time[i]);
+        smps[i] = static_cast<float>(s.time[i]);
+}
+
+void FFT_setMeasure(bool measure_)
+{
+    std::lock_guard<std::mutex> guard(planLock);
+    measure = measure_;
+}
+
+bool FFT_loadWisdom(const std::string &filename)
+{
+    std::lock_guard<std::mutex> guard(planLock);
+    return FFTW(import_wisdom_from_filename)(filename.c_str());
+}
+
+bool FFT_saveWisdom(const std::string &filename)
+{
+    std::lock_guard<std::mutex> guard(planLock);
+    return FFTW(export_wisdom_to_filename)(filename.c_str());
 }
 
 void FFT_cleanup()
 {
-    fftw_cleanup();
-    pthread_mutex_destroy(mutex);
-    delete mutex;
-    mutex = NULL;
+    std::lock_guard<std::mutex> guard(planLock);
+    for(auto &p: plans) {
+        FFTW(destroy_plan)(p.second.forward);
+        FFTW(destroy_plan)(p.second.inverse);
+    }
+    plans.clear();
+    FFTW(cleanup)();
 }
 
 }
@@ -15,11 +15,29 @@
 #define FFT_WRAPPER_H
 #include <fftw3.h>
 #include <complex>
+#include <string>
 #include "../globals.h"
 
+//FFTW API of the precision fftw_real is built with
+#ifdef FFTW_SINGLE_PRECISION
+#define FFTW(name) fftwf_ ## name
+#else
+#define FFTW(name) fftw_ ## name
+#endif
+
 namespace zyn {
 
-/**A wrapper for the FFTW library (Fast Fourier Transforms)*/
+/**A wrapper for the FFTW library (Fast Fourier Transforms)
+ *
+ * Wrappers of the same size share their plans, which are made once per
+ * process (or loaded from the wisdom, see FFT_loadWisdom()).
+ *
+ * The transforms run in the precision of fftw_real. In the single precision
+ * build, samples which are aligned like the internal buffer are transformed
+ * in place of a copy to and from double.
+ *
+ * A wrapper is used by one thread at a time, unless it is shared with the
+ * render threads (see shareWithRenderThreads()).*/
 class FFTwrapper
 {
     public:
@@ -33,11 +51,32 @@ class FFTwrapper
          * @param freqs Structure FFTFREQS which stores the frequencies*/
         void smps2freqs(const float *smps, fft_t *freqs);
         void freqs2smps(const fft_t *freqs, float *smps);
+
+        /**Give each render thread buffers of its own (see
+         * RenderPool::current()), as the master instance is used by every
+         * part. Other threads then transform with temporary buffers, so that
+         * they never get in the way of the audio thread.
+         * Only before the render threads use the wrapper.
+         * @param workers helper threads of the RenderPool*/
+        void shareWithRenderThreads(int workers) NONREALTIME;
     private:
+        //Buffers the plans are executed on
+        struct Scratch {
+            fftw_real     *time;
+            FFTW(complex) *fft;
+        };
+        Scratch newScratch(void) const;
+        static void deleteScratch(Scratch &s);
+        //The buffers of the calling thread or NULL for temporary ones
+        Scratch *scratchOf(void);
+        void smps2freqs(Scratch &s, const float *smps, fft_t *freqs);
+        void freqs2smps(Scratch &s, const fft_t *freqs, float *smps);
+
         int fftsize;
-        fftw_real    *time;
-        fftw_complex *fft;
-        fftw_plan     planfftw, planfftw_inv;
+        Scratch        *scratch;  //nscratch, the first for the audio thread
+        int             nscratch;
+        bool            shared;
+        FFTW(plan)      planfftw, planfftw_inv;
 };
 
 /*
@@ -59,6 +98,14 @@ FFTpolar(const _Tp& __rho, const _Tp& __theta = _Tp(0))
         return std::complex<_Tp>(__x, __y);
 }
 
+/**Plan the sizes not seen yet with FFTW_MEASURE (slow, but gives faster
+ * transforms) instead of FFTW_ESTIMATE*/
+void FFT_setMeasure(bool measure);
+/**Load/save the FFTW wisdom (the plans measured so far) from/to a file
+ * @return whether the file could be read/written*/
+bool FFT_loadWisdom(const std::string &filename);
+bool FFT_saveWisdom(const std::string &filename);
+/**Release the plans of all sizes; no FFTwrapper may be left*/
 void FFT_cleanup();
 
 }
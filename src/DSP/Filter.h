@@ -28,6 +28,12 @@ class Filter
         Filter(unsigned int srate, int bufsize);
         virtual ~Filter() {}
         virtual void filterout(float *smp)    = 0;
+        //Filters smpl and, with right (of the same parameters), smpr
+        virtual void filterout_stereo(float *smpl, Filter &right, float *smpr)
+        {
+            filterout(smpl);
+            right.filterout(smpr);
+        }
         virtual void setfreq(float frequency) = 0;
         virtual void setfreq_and_q(float frequency, float q_) = 0;
         virtual void setq(float q_) = 0;
@@ -0,0 +1,80 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  FilterTables.cpp - Coefficient Tables Shared By The Filters
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cmath>
+#include <cstring> //memcpy
+#include <stdint.h>
+#include "FilterTables.h"
+#include "../globals.h"
+
+namespace zyn {
+
+//freq / fs from 2^-21 up to 2^-1 (nyquist)
+#define TRIG_OCTAVES 20
+#define TRIG_BITS    7 //of the mantissa, picking the point in the octave
+#define TRIG_STEPS   (1 << TRIG_BITS)
+
+struct TrigTable
+{
+    FilterTrig point[TRIG_OCTAVES * TRIG_STEPS + 1];
+
+    TrigTable(void) {
+        for(int i = 0; i <= TRIG_OCTAVES * TRIG_STEPS; ++i) {
+            const int    octave = i / TRIG_STEPS, step = i % TRIG_STEPS;
+            const double omega  = 2.0 * M_PI
+                                  * ldexp(1.0 + step / (double)TRIG_STEPS,
+                                          octave - TRIG_OCTAVES - 1);
+            point[i].sn = sin(omega);
+            point[i].cs = cos(omega);
+            point[i].ex = exp(-omega);
+        }
+    }
+};
+
+//Built with the other statics at startup, never by the first (audio thread)
+//caller of filterTrig()
+static const TrigTable trigTable;
+
+FilterTrig filterTrigExact(float freq, float fs)
+{
+    const float omega = 2 * PI * freq / fs;
+    FilterTrig  trig;
+    trig.sn = sinf(omega);
+    trig.cs = cosf(omega);
+    trig.ex = expf(-omega);
+    return trig;
+}
+
+FilterTrig filterTrig(float freq, float fs)
+{
+    const float w = freq / fs;
+    uint32_t    bits;
+    memcpy(&bits, &w, sizeof(bits));
+    //the exponent picks the octave, the top of the mantissa the point
+    const int octave = (int)(bits >> 23) - 127 + TRIG_OCTAVES + 1;
+    if(octave < 0 || octave >= TRIG_OCTAVES)
+        return filterTrigExact(freq, fs);
+
+    const uint32_t    mantissa = bits & 0x7fffff;
+    const FilterTrig &a = trigTable.point[octave * TRIG_STEPS
+                                          + (mantissa >> (23 - TRIG_BITS))];
+    const FilterTrig &b = (&a)[1];
+    const float       t = (mantissa & ((1 << (23 - TRIG_BITS)) - 1))
+                          * (1.0f / (1 << (23 - TRIG_BITS)));
+
+    FilterTrig trig;
+    trig.sn = a.sn + (b.sn - a.sn) * t;
+    trig.cs = a.cs + (b.cs - a.cs) * t;
+    trig.ex = a.ex + (b.ex - a.ex) * t;
+    return trig;
+}
+
+}
@@ -0,0 +1,63 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  FilterTables.h - Coefficient Tables Shared By The Filters
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+
+namespace zyn {
+
+/**
+ * sin, cos and exp(-x) of omega = 2 * PI * freq / fs
+ */
+struct FilterTrig
+{
+    float sn, cs, ex;
+};
+
+//Computed with sinf, cosf and expf
+FilterTrig filterTrigExact(float freq, float fs);
+
+/**
+ * Interpolated from a table of 128 points per octave of freq / fs (within
+ * 2e-5 of the exact values).
+ *
+ * The points are spaced relative to the frequency, so 1 - cos keeps its
+ * relative accuracy at low cutoffs. Frequencies below the table (under 2^-21
+ * of the samplerate) are computed exactly.
+ */
+FilterTrig filterTrig(float freq, float fs);
+
+/**
+ * Remembers a value derived from a filter parameter and the number of
+ * stages (usually the root taken for every stage), as the cutoff changes far
+ * more often than either.
+ */
+class StageCache
+{
+    public:
+        StageCache(void):x(0.0f), stages(-1), value(0.0f) {}
+
+        template<class F>
+        float get(float x_, int stages_, F compute) {
+            if(x_ != x || stages_ != stages) {
+                x      = x_;
+                stages = stages_;
+                value  = compute();
+            }
+            return value;
+        }
+
+    private:
+        float x;
+        int   stages;
+        float value;
+};
+
+}
@@ -113,8 +113,11 @@ void SVFilter::computefiltercoefs(void)
     par.f = freq / samplerate_f * 4.0f;
     if(par.f > 0.99999f)
         par.f = 0.99999f;
-    par.q      = 1.0f - atanf(sqrtf(q)) * 2.0f / PI;
-    par.q      = powf(par.q, 1.0f / (stages + 1));
+    //the cutoff moves with the envelopes, q and the stages rarely do
+    par.q      = qcache.get(q, stages, [this]() {
+            return powf(1.0f - atanf(sqrtf(q)) * 2.0f / PI,
+                        1.0f / (stages + 1));
+        });
     par.q_sqrt = sqrtf(par.q);
 }
 
@@ -16,6 +16,7 @@
 
 #include "../globals.h"
 #include "Filter.h"
+#include "FilterTables.h"
 
 namespace zyn {
 
@@ -65,6 +66,7 @@ class SVFilter:public Filter
         float freq; // Frequency given in Hz
         float q;    // Q factor (resonance or Q factor)
         float gain; // the gain of the filter (if are shelf/peak) filters
+        StageCache qcache; // par.q for q and the stages
 
         bool abovenq,   //if the frequency is above the nyquist
              oldabovenq;
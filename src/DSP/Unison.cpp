@@ -15,6 +15,7 @@
 #include <cstring>
 
 #include "../Misc/Allocator.h"
+#include "../Misc/Util.h"
 #include "Unison.h"
 #include "globals.h"
 
@@ -92,12 +93,15 @@ void Unison::updateParameters(void)
     float increments_per_second = samplerate_f
                                   / (float) update_period_samples;
 //	printf("#%g, %g\n",increments_per_second,base_freq);
+    //amplitude and direction of each voice
+    float noise[2 * unison_size];
+    RandomStream::global().fill(noise, 2 * unison_size);
     for(int i = 0; i < unison_size; ++i) {
-        float base = powf(UNISON_FREQ_SPAN, SYNTH_T::numRandom() * 2.0f - 1.0f);
+        float base = powf(UNISON_FREQ_SPAN, noise[2 * i] * 2.0f - 1.0f);
         uv[i].relative_amplitude = base;
         float period = base / base_freq;
         float m      = 4.0f / (period * increments_per_second);
-        if(SYNTH_T::numRandom() < 0.5f)
+        if(noise[2 * i + 1] < 0.5f)
             m = -m;
         uv[i].step = m;
 //		printf("%g %g\n",uv[i].relative_amplitude,period);
@@ -14,8 +14,11 @@
 #include <cassert>
 #include <utility>
 #include <cstdio>
+#include <stdint.h>
+#include <mutex>
 #include "../../tlsf/tlsf.h"
 #include "Allocator.h"
+#include "SpinLock.h"
 
 namespace zyn {
 
@@ -44,6 +47,10 @@ struct AllocatorImpl
     //nice values
     next_t *pools = 0;
     unsigned long long totalAlloced = 0;
+
+    //tlsf is not threadsafe and notes may be freed from any of the
+    //parallel part render threads (see Allocator::setThreadSafe())
+    OptionalSpinLock lock;
 };
 
 Allocator::Allocator(void) : transaction_active()
@@ -59,8 +66,14 @@ Allocator::Allocator(void) : transaction_active()
     //printf("Allocator(%p)\n", impl);
 }
 
+Allocator::Allocator(std::nullptr_t) : impl(nullptr), transaction_active()
+{
+}
+
 Allocator::~Allocator(void)
 {
+    if(!impl)
+        return;
     next_t *n = impl->pools;
     while(n) {
         next_t *nn = n->next;
@@ -72,6 +85,7 @@ Allocator::~Allocator(void)
 
 void *AllocatorClass::alloc_mem(size_t mem_size)
 {
+    std::lock_guard<OptionalSpinLock> guard(impl->lock);
     impl->totalAlloced += mem_size;
     void *mem = tlsf_malloc(impl->tlsf, mem_size);
     //printf("Allocator.malloc(%p, %d) = %p\n", impl, mem_size, mem);
@@ -82,6 +96,7 @@ void *AllocatorClass::alloc_mem(size_t mem_size)
 void AllocatorClass::dealloc_mem(void *memory)
 {
     //printf("dealloc_mem(%d)\n", tlsf_block_size(memory));
+    std::lock_guard<OptionalSpinLock> guard(impl->lock);
     tlsf_free(impl->tlsf, memory);
     //free(memory);
 }
@@ -90,6 +105,7 @@ bool AllocatorClass::lowMemory(unsigned n, size_t chunk_size) const
 {
     //This should stay on the stack
     void *buf[n];
+    std::lock_guard<OptionalSpinLock> guard(impl->lock);
     for(unsigned i=0; i<n; ++i)
         buf[i] = tlsf_malloc(impl->tlsf, chunk_size);
     bool outOfMem = false;
@@ -105,6 +121,7 @@ bool AllocatorClass::lowMemory(unsigned n, size_t chunk_size) const
 
 void AllocatorClass::addMemory(void *v, size_t mem_size)
 {
+    std::lock_guard<OptionalSpinLock> guard(impl->lock);
     next_t *n = impl->pools;
     while(n->next) n = n->next;
     n->next = (next_t*)v;
@@ -120,6 +137,62 @@ void AllocatorClass::addMemory(void *v, size_t mem_size)
         printf("FAILED TO INSERT MEMORY POOL\n");
 };//{(void)mem_size;};
 
+//Alignment of the memory handed out by a NoteArena
+static const size_t arena_align = 16;
+
+static uintptr_t arenaRound(uintptr_t size)
+{
+    return (size + arena_align - 1) & ~(arena_align - 1);
+}
+
+NoteArena::NoteArena(Allocator &parent_, char *begin_, size_t size)
+    :Allocator(nullptr), parent(parent_), begin(begin_), pos(begin_),
+    end(begin_ + size), requested(0)
+{
+}
+
+NoteArena *NoteArena::create(Allocator &parent, size_t size)
+{
+    size = arenaRound(size);
+    char *block = (char*)parent.alloc_mem(sizeof(NoteArena) + arena_align + size);
+    if(!block)
+        return nullptr;
+    char *begin = (char*)arenaRound((uintptr_t)(block + sizeof(NoteArena)));
+    return new (block) NoteArena(parent, begin, size);
+}
+
+void NoteArena::destroy(NoteArena *arena)
+{
+    if(!arena)
+        return;
+    Allocator &parent = arena->parent;
+    arena->~NoteArena();
+    parent.dealloc_mem(arena);
+}
+
+void *NoteArena::alloc_mem(size_t mem_size)
+{
+    mem_size   = arenaRound(mem_size);
+    requested += mem_size;
+    if(mem_size <= (size_t)(end - pos)) {
+        void *mem = pos;
+        pos += mem_size;
+        return mem;
+    }
+    return parent.alloc_mem(mem_size);
+}
+
+void NoteArena::dealloc_mem(void *memory)
+{
+    if(memory < (void*)begin || memory >= (void*)end)
+        parent.dealloc_mem(memory);
+}
+
+bool NoteArena::lowMemory(unsigned n, size_t chunk_size) const
+{
+    return parent.lowMemory(n, chunk_size);
+}
+
 #ifndef INCLUDED_tlsfbits
 //From tlsf internals
 typedef struct block_header_t
@@ -195,6 +268,12 @@ int Allocator::freePools() const
 }
 
 
+void Allocator::setThreadSafe(bool on)
+{
+    if(impl)
+        impl->lock.enable(on);
+}
+
 unsigned long long Allocator::totalAlloced() const
 {
     return impl->totalAlloced;
@@ -11,6 +11,7 @@
 */
 #pragma once
 #include <cstdlib>
+#include <cstddef>
 #include <utility>
 #include <new>
 
@@ -120,8 +121,17 @@ class Allocator
 
     unsigned long long totalAlloced() const;
 
+    //Lock the pool around each allocation, which is only needed once the
+    //parts render in parallel (see RenderPool). Not to be changed while
+    //other threads use the allocator
+    void setThreadSafe(bool on);
+
     struct AllocatorImpl *impl;
 
+protected:
+    //For allocators without a memory pool of their own
+    explicit Allocator(std::nullptr_t);
+
 private:
     const static size_t max_transaction_length = 256;
 
@@ -176,6 +186,56 @@ public:
 
 extern DummyAllocator DummyAlloc;
 
+/**
+ * Size of the block the notes of one parameter object are built in.
+ *
+ * The size depends upon the parameters in ways which are not worth
+ * mirroring (filter types, unison sizes, enabled envelopes and so on), so it
+ * is learnt from a note built outside of the realtime thread when the
+ * parameters are applied (see SynthNote::measure()) and grown by the notes
+ * which are created with the parameters after later edits.
+ */
+struct NoteLayout
+{
+    NoteLayout(void) :size(0) {}
+
+    //Grow the layout to hold a note which needed used bytes
+    void record(size_t used) { if(used > size) size = used; }
+
+    size_t size;
+};
+
+//! bump allocator placing everything allocated for one note in a single
+//! block of its parent allocator
+class NoteArena : public Allocator
+{
+    public:
+        /**
+         * Allocates an arena with room for size bytes in a single block
+         * @return the arena or NULL if the parent is out of memory
+         */
+        static NoteArena *create(Allocator &parent, size_t size);
+        /**Returns the arena and everything placed inside it to the parent*/
+        static void destroy(NoteArena *arena);
+
+        //Allocations which do not fit in the arena are passed to the parent
+        void *alloc_mem(size_t mem_size);
+        //Memory within the arena is only freed along with the arena
+        void dealloc_mem(void *memory);
+        void addMemory(void *, size_t ) {}
+        bool lowMemory(unsigned n, size_t chunk_size) const;
+
+        //Bytes requested so far, including those which did not fit
+        size_t used(void) const { return requested; }
+
+        Allocator &parent;
+    private:
+        NoteArena(Allocator &parent, char *begin, size_t size);
+
+        char  *begin, *pos, *end;
+        size_t requested;
+};
+
 /**
  * General notes on Memory Allocation Within ZynAddSubFX
  * -----------------------------------------------------
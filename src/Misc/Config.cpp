@@ -50,6 +50,17 @@ static const rtosc::Ports ports = {
     rToggle(cfg.BankUIAutoClose, "Automatic Closing of BackUI After Patch Selection"),
     rParamI(cfg.GzipCompression, "Level of Gzip Compression For Save Files"),
     rParamI(cfg.Interpolation, "Level of Interpolation, Linear/Cubic"),
+    rParamI(cfg.RenderThreads, rLinear(0, 32),
+            "Helper threads used to render parts in parallel (0 = off)"),
+    rToggle(cfg.RenderNotes, "Spread the notes of each part over the render threads"),
+    rToggle(cfg.RandomStreams, "Independent random numbers per part and note "
+            "(always used with render threads)"),
+    rParamI(cfg.PADCacheSize, rLinear(0, 65536),
+            "MiB of PADsynth samples kept on disk (0 = off)"),
+    rToggle(cfg.PADLockSamples, "Lock the PADsynth samples into RAM"),
+    rToggle(cfg.PADHugePages, "Put the PADsynth samples on huge pages"),
+    rToggle(cfg.FFTMeasure, "Measure the fastest FFT plans "
+            "(slower the first time, kept on disk)"),
     {"cfg.presetsDirList", rDoc("list of preset search directories"), 0,
         [](const char *msg, rtosc::RtData &d)
         {
@@ -207,7 +218,14 @@ void Config::init()
     cfg.GzipCompression = 3;
 
     cfg.Interpolation = 0;
+    cfg.RenderThreads = 0;
+    cfg.RenderNotes   = 0;
+    cfg.RandomStreams = 0;
     cfg.CheckPADsynth = 1;
+    cfg.PADCacheSize  = 0; //writes to the user's cache dir, so opt in
+    cfg.PADLockSamples = 1;
+    cfg.PADHugePages   = 0;
+    cfg.FFTMeasure     = 0;
     cfg.IgnoreProgramChange = 0;
 
     cfg.UserInterfaceMode = 0;
@@ -336,11 +354,46 @@ void Config::readConfig(const char *filename)
                                            0,
                                            1);
 
+        cfg.RenderThreads  = xmlcfg.getpar("render_threads",
+                                           cfg.RenderThreads,
+                                           0,
+                                           32);
+
+        cfg.RenderNotes    = xmlcfg.getpar("render_notes",
+                                           cfg.RenderNotes,
+                                           0,
+                                           1);
+
+        cfg.RandomStreams  = xmlcfg.getpar("random_streams",
+                                           cfg.RandomStreams,
+                                           0,
+                                           1);
+
         cfg.CheckPADsynth = xmlcfg.getpar("check_pad_synth",
                                           cfg.CheckPADsynth,
                                           0,
                                           1);
 
+        cfg.PADCacheSize  = xmlcfg.getpar("pad_cache_size",
+                                          cfg.PADCacheSize,
+                                          0,
+                                          65536);
+
+        cfg.PADLockSamples = xmlcfg.getpar("pad_lock_samples",
+                                           cfg.PADLockSamples,
+                                           0,
+                                           1);
+
+        cfg.PADHugePages   = xmlcfg.getpar("pad_huge_pages",
+                                           cfg.PADHugePages,
+                                           0,
+                                           1);
+
+        cfg.FFTMeasure     = xmlcfg.getpar("fft_measure",
+                                           cfg.FFTMeasure,
+                                           0,
+                                           1);
+
         cfg.IgnoreProgramChange = xmlcfg.getpar("ignore_program_change",
                                           cfg.IgnoreProgramChange,
                                           0,
@@ -416,6 +469,10 @@ void Config::saveConfig(const char *filename) const
     xmlcfg->addpar("gzip_compression", cfg.GzipCompression);
 
     xmlcfg->addpar("check_pad_synth", cfg.CheckPADsynth);
+    xmlcfg->addpar("pad_cache_size", cfg.PADCacheSize);
+    xmlcfg->addpar("pad_lock_samples", cfg.PADLockSamples);
+    xmlcfg->addpar("pad_huge_pages", cfg.PADHugePages);
+    xmlcfg->addpar("fft_measure", cfg.FFTMeasure);
     xmlcfg->addpar("ignore_program_change", cfg.IgnoreProgramChange);
 
     xmlcfg->addparstr("bank_current", cfg.currentBankDir);
@@ -446,6 +503,9 @@ void Config::saveConfig(const char *filename) const
         }
 
     xmlcfg->addpar("interpolation", cfg.Interpolation);
+    xmlcfg->addpar("render_threads", cfg.RenderThreads);
+    xmlcfg->addpar("render_notes", cfg.RenderNotes);
+    xmlcfg->addpar("random_streams", cfg.RandomStreams);
 
     //linux stuff
     xmlcfg->addparstr("linux_oss_wave_out_dev", cfg.oss_devs.linux_wave_out);
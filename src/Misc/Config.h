@@ -46,10 +46,17 @@ class Config
             int   BankUIAutoClose;
             int   GzipCompression;
             int   Interpolation;
+            int   RenderThreads;
+            int   RenderNotes;
+            int   RandomStreams;
             std::string bankRootDirList[MAX_BANK_ROOT_DIRS], currentBankDir;
             std::string presetsDirList[MAX_BANK_ROOT_DIRS];
             std::string favoriteList[MAX_BANK_ROOT_DIRS];
             int CheckPADsynth;
+            int PADCacheSize; //MiB of PADsynth samples cached on disk
+            int PADLockSamples; //mlock() the PADsynth samples
+            int PADHugePages; //back the PADsynth samples with huge pages
+            int FFTMeasure; //measure FFTW plans (kept in the wisdom file)
             int IgnoreProgramChange;
             int UserInterfaceMode;
             int VirKeybLayout;
@@ -23,6 +23,8 @@
 #include "../Effects/EffectMgr.h"
 #include "../DSP/FFTwrapper.h"
 #include "../Misc/Allocator.h"
+#include "../Misc/RenderPool.h"
+#include "../Synth/SynthNote.h"
 #include "../Containers/ScratchString.h"
 #include "../Nio/Nio.h"
 #include "PresetExtractor.h"
@@ -45,6 +47,10 @@ using namespace rtosc;
 
 namespace zyn {
 
+//Upper bound on notes rendered ahead of their part per buffer
+//(any notes beyond this are rendered within their part's job)
+#define MAX_NOTE_JOBS (POLYPHONY * EXPECTED_USAGE)
+
 #define rObject Master
 
 static const Ports sysefxPort =
@@ -409,6 +415,7 @@ static const Ports master_ports = {
        m->part[i]->kill_rt();
        d.reply("/free", "sb", "Part", sizeof(void*), &m->part[i]);
        m->part[i] = p;
+       p->rng = m->rng.split();
        p->initialize_rt();
        for(int i=0; i<128; ++i)
            m->activeNotes[i] = 0;
@@ -733,6 +740,25 @@ Master::Master(const SYNTH_T &synth_, Config* config)
     last_xmz[0] = 0;
     fft = new FFTwrapper(synth.oscilsize);
 
+    renderer    = NULL;
+    noteJobs    = NULL;
+    noteScratch = NULL;
+    if(config->cfg.RenderThreads > 0) {
+        renderer = new RenderPool(config->cfg.RenderThreads);
+        //Without workers nothing but the audio thread renders
+        memory->setThreadSafe(renderer->workers() > 0);
+        if(config->cfg.RenderNotes) {
+            noteJobs    = new NoteRenderJob[MAX_NOTE_JOBS];
+            noteScratch = new float[2 * MAX_NOTE_JOBS * synth.buffersize];
+            for(int i = 0; i < MAX_NOTE_JOBS; ++i) {
+                noteJobs[i].note = NULL;
+                noteJobs[i].outl = noteScratch + (2 * i) * synth.buffersize;
+                noteJobs[i].outr = noteScratch + (2 * i + 1) * synth.buffersize;
+            }
+        }
+    }
+    fft->shareWithRenderThreads(renderer ? renderer->workers() : 0);
+
     shutup = 0;
     for(int npart = 0; npart < NUM_MIDI_PARTS; ++npart) {
         vuoutpeakpart[npart] = 1e-9;
@@ -745,6 +771,13 @@ Master::Master(const SYNTH_T &synth_, Config* config)
                                config->cfg.Interpolation, &microtonal, fft, &watcher,
                                (ss+"/part"+npart+"/").c_str);
 
+    if(config->cfg.RandomStreams || renderer) {
+        rng = RandomStream(prng());
+        for(int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
+            part[npart]->rng = rng.split();
+    } else
+        rng = RandomStream::global();
+
     //Insertion Effects init
     for(int nefx = 0; nefx < NUM_INS_EFX; ++nefx)
         insefx[nefx] = new EffectMgr(*memory, synth, 1, &time);
@@ -1132,11 +1165,71 @@ bool Master::runOSC(float *outl, float *outr, bool offline)
     return true;
 }
 
+struct PartRenderJob {
+    Part                *part;
+    const NoteRenderJob *jobs;
+    int                  njobs;
+};
+
+/*
+ * Parts are independent up to the insertion effects, so they may be rendered
+ * by the helper threads. Everything after this point is mixed in a fixed
+ * order, so the output does not depend upon which thread computed what.
+ */
+void Master::computeParts(void)
+{
+    Part *active[NUM_MIDI_PARTS];
+    int   nactive = 0;
+    for(int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
+        if(part[npart]->Penabled)
+            active[nactive++] = part[npart];
+
+    if(!renderer) {
+        for(int i = 0; i < nactive; ++i)
+            active[i]->ComputePartSmps();
+        return;
+    }
+
+    if(!noteJobs) {
+        renderer->run([](void *data, int idx) {
+                ((Part**)data)[idx]->ComputePartSmps();
+                }, active, nactive);
+        return;
+    }
+
+    //A single busy part can saturate a core on its own, so first every note
+    //(of every part) is rendered into its own buffer...
+    PartRenderJob parts[NUM_MIDI_PARTS];
+    int njobs = 0;
+    for(int i = 0; i < nactive; ++i) {
+        parts[i].part  = active[i];
+        parts[i].jobs  = noteJobs + njobs;
+        parts[i].njobs = active[i]->gatherNotes(noteJobs + njobs,
+                                                MAX_NOTE_JOBS - njobs);
+        njobs += parts[i].njobs;
+    }
+    renderer->run([](void *data, int idx) {
+            NoteRenderJob &job = ((NoteRenderJob*)data)[idx];
+            const uint64_t t = NoteStats::ticks();
+            job.note->noteout(job.outl, job.outr);
+            job.ticks = NoteStats::ticks() - t;
+            }, noteJobs, njobs);
+
+    //...then each part sums its notes in order and runs its effects
+    renderer->run([](void *data, int idx) {
+            PartRenderJob &job = ((PartRenderJob*)data)[idx];
+            job.part->ComputePartSmps(job.jobs, job.njobs);
+            }, parts, nactive);
+}
+
 /*
  * Master audio out (the final sound)
  */
 bool Master::AudioOut(float *outr, float *outl)
 {
+    //The shared FFTwrapper hands this thread the buffers of the audio thread
+    RenderPool::audiothread();
+
     //Danger Limits
     if(memory->lowMemory(2,1024*1024))
         printf("QUITE LOW MEMORY IN THE RT POOL BE PREPARED FOR WEIRD BEHAVIOR!!\n");
@@ -1167,9 +1260,7 @@ bool Master::AudioOut(float *outr, float *outl)
     memset(outr, 0, synth.bufferbytes);
 
     //Compute part samples and store them part[npart]->partoutl,partoutr
-    for(int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
-        if(part[npart]->Penabled)
-            part[npart]->ComputePartSmps();
+    computeParts();
 
     //Insertion effects
     for(int nefx = 0; nefx < NUM_INS_EFX; ++nefx)
@@ -1366,6 +1457,9 @@ void Master::GetAudioOutSamples(size_t nsamples,
 
 Master::~Master()
 {
+    delete renderer;
+    delete []noteJobs;
+    delete []noteScratch;
     delete []bufl;
     delete []bufr;
 
@@ -1442,10 +1536,10 @@ void Master::vuresetpeaks()
     vu.clipped     = 0;
 }
 
-void Master::applyparameters(void)
+void Master::applyparameters(PADpool *pool, bool lazy)
 {
     for(int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
-        part[npart]->applyparameters();
+        part[npart]->applyparameters([]{return false;}, pool, lazy);
 }
 
 void Master::initialize_rt(void)
@@ -20,6 +20,7 @@
 #include <rtosc/savefile.h>
 
 #include "Time.h"
+#include "Util.h"
 #include "Bank.h"
 #include "Recorder.h"
 
@@ -90,7 +91,8 @@ class Master
 
         /**Regenerate PADsynth and other non-RT parameters
          * It is NOT SAFE to call this from a RT context*/
-        void applyparameters(void) NONREALTIME;
+        void applyparameters(PADpool *pool = NULL,
+                             bool lazy = false) NONREALTIME;
 
         //This must be called prior-to/at-the-time-of RT insertion
         void initialize_rt(void) REALTIME;
@@ -184,6 +186,15 @@ class Master
 
         class FFTwrapper * fft;
 
+        //Optional helper threads for rendering parts in parallel
+        //(NULL when disabled via Config::cfg.RenderThreads)
+        class RenderPool * renderer;
+
+        //Random numbers for the parts (and their notes)
+        //Bound to the global generator unless Config::cfg.RandomStreams is
+        //set, or parts are rendered by several threads
+        RandomStream rng;
+
         static const rtosc::Ports &ports;
         float  volume;
 
@@ -216,6 +227,14 @@ class Master
         float  sysefxsend[NUM_SYS_EFX][NUM_SYS_EFX];
         int    keyshift;
 
+        //Compute all enabled parts (serially or via renderer)
+        void computeParts(void) REALTIME;
+
+        //Notes rendered ahead of their part, one scratch buffer per job
+        //(only allocated when Config::cfg.RenderNotes is set)
+        struct NoteRenderJob *noteJobs;
+        float *noteScratch;
+
         //information relevent to generating plugin audio samples
         float *bufl;
         float *bufr;
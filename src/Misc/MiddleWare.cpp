@@ -14,6 +14,7 @@
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <dirent.h>
@@ -37,6 +38,9 @@
 #include "Master.h"
 #include "Part.h"
 #include "PresetExtractor.h"
+#include "PADcache.h"
+#include "PADpool.h"
+#include "SampleMemory.h"
 #include "../Containers/MultiPseudoStack.h"
 #include "../Params/PresetsStore.h"
 #include "../Params/ADnoteParameters.h"
@@ -166,54 +170,88 @@ void deallocate(const char *str, void *v)
         delete (Master*)v;
     else if(!strcmp(str, "fft_t"))
         delete[] (fft_t*)v;
+    else if(!strcmp(str, "OscilTables"))
+        delete (OscilTables*)v;
     else if(!strcmp(str, "KbmInfo"))
         delete (KbmInfo*)v;
     else if(!strcmp(str, "SclInfo"))
         delete (SclInfo*)v;
     else if(!strcmp(str, "Microtonal"))
         delete (Microtonal*)v;
+    else if(!strcmp(str, "PADsample"))
+        SampleMemory::dealloc((float*)v);
     else
         fprintf(stderr, "Unknown type '%s', leaking pointer %p!!\n", str, v);
 }
 
 
+/*****************************************************************************
+ *                    FFTW Wisdom                                            *
+ *****************************************************************************/
+static std::string wisdomDirectory(void)
+{
+    return os_cache_dir();
+}
+
+//Wisdom depends on the precision, so each one gets a file of its own
+static std::string wisdomFile(void)
+{
+#ifdef FFTW_SINGLE_PRECISION
+    return wisdomDirectory() + "/fftwf.wisdom";
+#else
+    return wisdomDirectory() + "/fftw.wisdom";
+#endif
+}
+
+
 /*****************************************************************************
  *                    PadSynth Setup                                         *
  *****************************************************************************/
 
-void preparePadSynth(string path, PADnoteParameters *p, rtosc::RtData &d)
+void preparePadSynth(string path, PADnoteParameters *p, rtosc::RtData &d,
+                     PADpool *pool)
 {
     //printf("preparing padsynth parameters\n");
     assert(!path.empty());
     path += "sample";
 
+    //Samples which are unchanged stay with the backend
+    uint64_t current[PAD_MAX_SAMPLES];
+    for(int i = 0; i < PAD_MAX_SAMPLES; ++i)
+        current[i] = p->sample[i].key;
+
 #ifdef WIN32
-    unsigned num = p->sampleGenerator([&path,&d]
+    unsigned num = p->sampleGenerator([&path,&d,p]
                        (unsigned N, PADnoteParameters::Sample &s)
                        {
                            //printf("sending info to '%s'\n",
                            //       (path+to_s(N)).c_str());
-                           d.chain((path+to_s(N)).c_str(), "ifb",
-                                   s.size, s.basefreq, sizeof(float*), &s.smp);
-                       }, []{return false;}, 1);
+                           d.chain((path+to_s(N)).c_str(), "ifbi",
+                                   s.size, s.basefreq, sizeof(float*), &s.smp,
+                                   s.format);
+                           p->sample[N].key = s.key;
+                       }, []{return false;}, 1, pool, current);
 #else
     std::mutex rtdata_mutex;
-    unsigned num = p->sampleGenerator([&rtdata_mutex, &path,&d]
+    unsigned num = p->sampleGenerator([&rtdata_mutex, &path,&d,p]
                        (unsigned N, PADnoteParameters::Sample &s)
                        {
                            //printf("sending info to '%s'\n",
                            //       (path+to_s(N)).c_str());
                            rtdata_mutex.lock();
-                           d.chain((path+to_s(N)).c_str(), "ifb",
-                                   s.size, s.basefreq, sizeof(float*), &s.smp);
+                           d.chain((path+to_s(N)).c_str(), "ifbi",
+                                   s.size, s.basefreq, sizeof(float*), &s.smp,
+                                   s.format);
+                           p->sample[N].key = s.key;
                            rtdata_mutex.unlock();
-                       }, []{return false;});
+                       }, []{return false;}, 0, pool, current);
 #endif
 
     //clear out unused samples
     for(unsigned i = num; i < PAD_MAX_SAMPLES; ++i) {
-        d.chain((path+to_s(i)).c_str(), "ifb",
-                0, 440.0f, sizeof(float*), NULL);
+        d.chain((path+to_s(i)).c_str(), "ifbi",
+                0, 440.0f, sizeof(float*), NULL, PAD_FLOAT);
+        p->sample[i].key = 0;
     }
 }
 
@@ -230,11 +268,46 @@ void preparePadSynth(string path, PADnoteParameters *p, rtosc::RtData &d)
  *   realtime                                                                 *
  *                                                                            *
  * These instances are collected on every part change and kit change          *
+ *                                                                            *
+ * PADsynth samples are prepared in two phases:                               *
+ * 1) Short preview samples are computed right away and sent to the backend   *
+ * 2) Full quality samples are computed in the background from a copy of the  *
+ *    parameters. tickPad() sends them on to the backend, where each of them  *
+ *    replaces its preview sample as a whole                                  *
+ * A newer prepare of the same object aborts the background work              *
+ *                                                                            *
+ * Instruments with lazy samples (PADnoteParameters::Plazy) are loaded with   *
+ * preview samples only. fillPads() then starts the background work, which   *
+ * computes the samples of the keys played so far first and the remaining     *
+ * ones next, nearest to the played ones first                                *
  ******************************************************************************/
 struct NonRtObjStore
 {
     std::map<std::string, void*> objmap;
 
+    //Threads for the full quality and the preview PADsynth samples
+    PADpool *padpool;
+    PADpool *padpreview;
+
+    struct PadJob {
+        std::string        obj_rl;  //location of the PADnoteParameters
+        void              *target;  //object the samples are meant for
+        FFTwrapper        *fft;
+        PADnoteParameters *pars;    //copy taken at the time of prepare
+        std::atomic<bool>  abort;
+        std::atomic<bool>  done;
+        int                num;     //number of samples, once done
+        uint64_t           keys[PAD_MAX_SAMPLES]; //held by the backend
+        std::thread        thread;
+        bool               lazy;    //played keys first (see runLazyPad())
+        std::atomic<uint64_t> played[2]; //copied from the target by tickPad()
+
+        //Finished samples which are yet to be sent
+        std::mutex lock;
+        std::vector<std::pair<int, PADnoteParameters::Sample>> samples;
+    };
+    std::list<PadJob*> padjobs;
+
     void extractMaster(Master *master)
     {
         for(int i=0; i < NUM_MIDI_PARTS; ++i) {
@@ -313,7 +386,7 @@ struct NonRtObjStore
         string obj_rl(d.message, msg);
         void *pad = get(obj_rl);
         if(!strcmp(msg, "prepare")) {
-            preparePadSynth(obj_rl, (PADnoteParameters*)pad, d);
+            preparePad(obj_rl, (PADnoteParameters*)pad, d);
             d.matches++;
             d.reply((obj_rl+"needPrepare").c_str(), "F");
         } else {
@@ -325,6 +398,8 @@ struct NonRtObjStore
                 if(rtosc_narguments(msg)) {
                     if(!strcmp(msg, "oscilgen/prepare"))
                         ; //ignore
+                    else if(!strncmp(msg, "sample", 6))
+                        ; //samples are the result of a prepare
                     else {
                         d.reply((obj_rl+"needPrepare").c_str(), "T");
                     }
@@ -336,6 +411,246 @@ struct NonRtObjStore
                         obj_rl.c_str());
         }
     }
+
+    void preparePad(string obj_rl, PADnoteParameters *p, rtosc::RtData &d)
+    {
+        for(auto *job: padjobs)
+            if(job->obj_rl == obj_rl)
+                job->abort = true;
+
+#ifdef WIN32
+        preparePadSynth(obj_rl, p, d, padpool);
+#else
+        //Nothing to gain from a preview
+        if(p->samplesize() <= PADnoteParameters::PREVIEW_SIZE) {
+            preparePadSynth(obj_rl, p, d, padpool);
+            return;
+        }
+
+        //Only changed samples get a preview (see
+        //PADnoteParameters::sampleGenerator())
+        uint64_t current[PAD_MAX_SAMPLES];
+        for(int i = 0; i < PAD_MAX_SAMPLES; ++i)
+            current[i] = p->sample[i].key;
+
+        const string path = obj_rl + "sample";
+        unsigned num = p->previewGenerator([&path,&d,p]
+                (unsigned N, PADnoteParameters::Sample &s)
+                {
+                    d.chain((path+to_s(N)).c_str(), "ifbi",
+                            s.size, s.basefreq, sizeof(float*), &s.smp,
+                            s.format);
+                    p->sample[N].key = s.key;
+                }, []{return false;}, padpreview, current);
+
+        for(unsigned i = num; i < PAD_MAX_SAMPLES; ++i) {
+            d.chain((path+to_s(i)).c_str(), "ifbi",
+                    0, 440.0f, sizeof(float*), NULL, PAD_FLOAT);
+            p->sample[i].key = 0;
+        }
+
+        spawnPad(obj_rl, p);
+#endif
+    }
+
+    //Start computing the full quality samples of p in the background
+    void spawnPad(string obj_rl, PADnoteParameters *p)
+    {
+        PadJob *job = new PadJob;
+        for(int i = 0; i < PAD_MAX_SAMPLES; ++i)
+            job->keys[i] = p->sample[i].key;
+        job->obj_rl = obj_rl;
+        job->target = p;
+        job->fft    = new FFTwrapper(p->synth.oscilsize);
+        job->pars   = new PADnoteParameters(p->synth, job->fft, p->time);
+        job->pars->paste(*p);
+        job->abort  = false;
+        job->done   = false;
+        job->num    = 0;
+        job->lazy   = p->Plazy;
+        job->played[0] = p->playedkeys[0].load();
+        job->played[1] = p->playedkeys[1].load();
+        job->thread = std::thread(job->lazy ? runLazyPad : runPad, job,
+                                  padpool);
+        padjobs.push_back(job);
+    }
+
+    //Start the background work of lazy objects which were loaded with
+    //preview samples only (see PADnoteParameters::applyparameters())
+    void fillPads(void)
+    {
+#ifndef WIN32
+        for(auto &obj: objmap) {
+            const string &loc = obj.first;
+            auto *p = (PADnoteParameters*)obj.second;
+            if(!p || !p->Plazy || loc.size() < 8
+               || loc.compare(loc.size() - 8, 8, "padpars/"))
+                continue;
+            bool running = false;
+            for(auto *job: padjobs)
+                running |= job->obj_rl == loc && !job->abort;
+            if(!running)
+                spawnPad(loc, p);
+        }
+#endif
+    }
+
+    static void runPad(PadJob *job, PADpool *pool)
+    {
+        job->num = job->pars->sampleGenerator([job]
+                (unsigned N, PADnoteParameters::Sample &s)
+                {
+                    std::lock_guard<std::mutex> guard(job->lock);
+                    job->samples.push_back(std::make_pair((int)N, s));
+                }, [job]{return job->abort.load();}, 0, pool, job->keys);
+        job->done = true;
+    }
+
+    //Samples which PADnote picks for the keys played so far
+    static uint64_t playedSamples(const PadJob *job, const float *freqs,
+                                  int num)
+    {
+        uint64_t res = 0;
+        for(int key = 0; key < 128; ++key) {
+            if(!((job->played[key / 64].load() >> (key % 64)) & 1))
+                continue;
+            const float logfreq = logf(440.0f * powf(2.0f, (key - 69) / 12.0f));
+            int   best    = 0;
+            float mindist = fabs(logfreq - logf(freqs[0]));
+            for(int i = 1; i < num; ++i) {
+                const float dist = fabs(logfreq - logf(freqs[i]));
+                if(dist < mindist) {
+                    best    = i;
+                    mindist = dist;
+                }
+            }
+            res |= (uint64_t)1 << best;
+        }
+        return res;
+    }
+
+    //Sample within set which is nearest to focus
+    static int nearestSample(uint64_t set, int focus, int num)
+    {
+        int best = -1;
+        for(int i = 0; i < num; ++i)
+            if(((set >> i) & 1)
+               && (best < 0 || abs(i - focus) < abs(best - focus)))
+                best = i;
+        return best;
+    }
+
+    //Computes the samples in batches of one sample per thread, so that keys
+    //played in the meantime only wait for the current batch
+    static void runLazyPad(PadJob *job, PADpool *pool)
+    {
+        float freqs[PAD_MAX_SAMPLES];
+        const int num       = job->pars->samplefreqs(freqs);
+        const int batchsize = pool->workers() + 1;
+        uint64_t  missing   = num == 64 ? ~(uint64_t)0
+                                        : ((uint64_t)1 << num) - 1;
+        int       focus     = num / 2;
+        std::atomic<uint64_t> delivered(0);
+
+        while(missing && !job->abort) {
+            uint64_t wanted = playedSamples(job, freqs, num) & missing;
+            if(wanted)
+                focus = nearestSample(wanted, focus, num);
+
+            uint64_t batch = 0;
+            for(int i = 0; i < batchsize && (missing & ~batch); ++i) {
+                const uint64_t from = (wanted & ~batch) ? wanted & ~batch
+                                                        : missing & ~batch;
+                batch |= (uint64_t)1 << nearestSample(from, focus, num);
+            }
+
+            job->pars->sampleGenerator([job, &delivered]
+                    (unsigned N, PADnoteParameters::Sample &s)
+                    {
+                        std::lock_guard<std::mutex> guard(job->lock);
+                        job->samples.push_back(std::make_pair((int)N, s));
+                        delivered |= (uint64_t)1 << N;
+                    }, [job]{return job->abort.load();}, 0, pool, job->keys,
+                    batch);
+            missing &= ~(batch | delivered.load());
+        }
+        job->num  = num;
+        job->done = true;
+    }
+
+    //Send the samples of background jobs on to the backend
+    void tickPad(std::function<void(const char *)> send)
+    {
+        char buf[1024];
+        for(auto itr = padjobs.begin(); itr != padjobs.end();) {
+            PadJob *job = *itr;
+            PADnoteParameters *target = (PADnoteParameters*)job->target;
+            const bool done = job->done;
+
+            //The object may have been replaced by loading a part or master
+            if(!has(job->obj_rl) || get(job->obj_rl) != job->target)
+                job->abort = true;
+            else if(job->lazy) {
+                job->played[0] = target->playedkeys[0].load();
+                job->played[1] = target->playedkeys[1].load();
+            }
+
+            std::vector<std::pair<int, PADnoteParameters::Sample>> samples;
+            job->lock.lock();
+            samples.swap(job->samples);
+            job->lock.unlock();
+
+            for(auto &s: samples) {
+                if(job->abort) {
+                    SampleMemory::dealloc(s.second.smp);
+                    continue;
+                }
+                rtosc_message(buf, sizeof(buf),
+                              (job->obj_rl+"sample"+to_s(s.first)).c_str(),
+                              "ifbi", s.second.size, s.second.basefreq,
+                              sizeof(float*), &s.second.smp, s.second.format);
+                send(buf);
+                target->sample[s.first].key = s.second.key;
+            }
+
+            if(!done) {
+                ++itr;
+                continue;
+            }
+
+            //clear out unused samples
+            float *none = NULL;
+            for(int i = job->num; i < PAD_MAX_SAMPLES && !job->abort; ++i) {
+                rtosc_message(buf, sizeof(buf),
+                              (job->obj_rl+"sample"+to_s(i)).c_str(),
+                              "ifbi", 0, 440.0f, sizeof(float*), &none,
+                              PAD_FLOAT);
+                send(buf);
+                target->sample[i].key = 0;
+            }
+
+            job->thread.join();
+            delete job->pars;
+            delete job->fft;
+            delete job;
+            itr = padjobs.erase(itr);
+        }
+    }
+
+    void abortPad(void)
+    {
+        for(auto *job: padjobs)
+            job->abort = true;
+        for(auto *job: padjobs) {
+            job->thread.join();
+            for(auto &s: job->samples)
+                SampleMemory::dealloc(s.second.smp);
+            delete job->pars;
+            delete job->fft;
+            delete job;
+        }
+        padjobs.clear();
+    }
 };
 
 /******************************************************************************
@@ -491,7 +806,7 @@ public:
                 return actual_load[npart] != pending_load[npart];
                 };
 
-                p->applyparameters(isLateLoad);
+                p->applyparameters(isLateLoad, padpool, true);
                 return p;});
 
         //Load the part
@@ -515,10 +830,11 @@ public:
             return actual_load[npart] != pending_load[npart];
         };
 
-        p->applyparameters(isLateLoad);
+        p->applyparameters(isLateLoad, padpool);
 #endif
 
         obj_store.extractPart(p, npart);
+        obj_store.fillPads();
         kits.extractPart(p, npart);
 
         //Give it to the backend and wait for the old part to return for
@@ -538,7 +854,7 @@ public:
                 config->cfg.GzipCompression,
                 config->cfg.Interpolation,
                 &master->microtonal, master->fft);
-        p->applyparameters();
+        p->applyparameters([]{return false;}, padpool);
         obj_store.extractPart(p, npart);
         kits.extractPart(p, npart);
 
@@ -572,11 +888,16 @@ public:
                     return -1;
                 }
             }
-            m->applyparameters();
+#ifdef WIN32
+            m->applyparameters(padpool);
+#else
+            m->applyparameters(padpool, true);
+#endif
         }
 
         //Update resource locator table
         updateResources(m);
+        obj_store.fillPads();
 
         master = m;
 
@@ -692,6 +1013,8 @@ public:
             multi_thread_source.free(m);
         }
 
+        obj_store.tickPad([this](const char *msg) {handleMsg(msg);});
+
         autoSave.tick();
 
         heartBeat(master);
@@ -737,6 +1060,9 @@ public:
      */
     NonRtObjStore obj_store;
 
+    //Threads which compute PADsynth samples (see preparePadSynth())
+    PADpool *padpool;
+
     //This code will own the pointer to master, be prepared for odd things if
     //this assumption is broken
     Master *master;
@@ -1270,6 +1596,12 @@ static rtosc::Ports middwareSnoopPorts = {
         d.obj = impl.config;
         Config::ports.dispatch(chomp(msg), d);
         rEnd},
+    //Memory of all PADsynth samples: tables, bytes, locked and huge bytes
+    {"pad-memory:", 0, 0,
+        rBegin;
+        const SampleMemory::Stats s = SampleMemory::stats();
+        d.reply("/pad-memory", "hhhh", s.tables, s.bytes, s.locked, s.huge);
+        rEnd},
     {"presets/", 0,  &real_preset_ports,          [](const char *msg, RtData &d) {
         MiddleWareImpl *obj = (MiddleWareImpl*)d.obj;
         d.obj = (void*)obj->parent;
@@ -1603,6 +1935,21 @@ MiddleWareImpl::MiddleWareImpl(MiddleWare *mw, SYNTH_T synth_,
     idle = 0;
     idle_ptr = 0;
 
+    PADcache::setLimit((uint64_t)config->cfg.PADCacheSize << 20);
+    SampleMemory::setLock(config->cfg.PADLockSamples);
+    SampleMemory::setHugePages(config->cfg.PADHugePages);
+    //Measured plans also serve the estimating planner, so they are loaded
+    //either way
+    FFT_setMeasure(config->cfg.FFTMeasure);
+    if(!wisdomDirectory().empty())
+        FFT_loadWisdom(wisdomFile());
+    padpool = new PADpool((int)std::thread::hardware_concurrency() - 1);
+    obj_store.padpool    = padpool;
+    //The previews hold up the MiddleWare thread, so they get every core as
+    //well rather than waiting behind the full samples
+    obj_store.padpreview =
+        new PADpool((int)std::thread::hardware_concurrency() - 1);
+
     master = new Master(synth, config);
     master->bToU = bToU;
     master->uToB = uToB;
@@ -1643,11 +1990,18 @@ MiddleWareImpl::~MiddleWareImpl(void)
     if(server)
         lo_server_free(server);
 
+    obj_store.abortPad();
     delete master;
     delete osc;
     delete bToU;
     delete uToB;
+    delete obj_store.padpreview;
+    delete padpool;
 
+    if(config->cfg.FFTMeasure && !wisdomDirectory().empty()) {
+        os_make_dirs(wisdomDirectory());
+        FFT_saveWisdom(wisdomFile());
+    }
 }
 
 /** Threading When Saving
@@ -0,0 +1,99 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  NoteStats.cpp - Note Latency Histograms
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cstring>
+#include <cmath>
+#include "NoteStats.h"
+
+namespace zyn {
+
+static int bucketOf(uint64_t ticks)
+{
+    const int S = LatencyHistogram::SUBDIV;
+    if(ticks < (uint64_t)S)
+        return ticks;
+    int octave = 63 - __builtin_clzll(ticks);
+    int b = (octave - 1) * S + ((ticks >> (octave - 2)) & (S - 1));
+    return b < LatencyHistogram::BUCKETS ? b : LatencyHistogram::BUCKETS - 1;
+}
+
+uint64_t LatencyHistogram::bucketStart(int b)
+{
+    if(b < SUBDIV)
+        return b;
+    int octave = b / SUBDIV + 1;
+    return (uint64_t)(SUBDIV + b % SUBDIV) << (octave - 2);
+}
+
+void LatencyHistogram::add(uint64_t ticks)
+{
+    count[bucketOf(ticks)]++;
+    events++;
+    total += ticks;
+    if(ticks > max)
+        max = ticks;
+}
+
+void LatencyHistogram::reset(void)
+{
+    memset(this, 0, sizeof(*this));
+}
+
+uint64_t LatencyHistogram::percentile(float p) const
+{
+    const uint64_t target = ceilf(p * events);
+    uint64_t seen = 0;
+    for(int b = 0; b < BUCKETS; ++b) {
+        seen += count[b];
+        if(seen >= target && seen) {
+            const uint64_t end = bucketStart(b + 1);
+            return end < max ? end : max;
+        }
+    }
+    return max;
+}
+
+NoteStats::NoteStats(void)
+{
+    //Calibrate now rather than on the realtime thread
+    ticksPerSecond();
+    reset();
+}
+
+void NoteStats::reset(void)
+{
+    for(auto &h:hist)
+        h.reset();
+}
+
+static double measureTicksPerSecond(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    using namespace std::chrono;
+    const auto     start = steady_clock::now();
+    const uint64_t t0    = NoteStats::ticks();
+    auto now = start;
+    while(now - start < milliseconds(10))
+        now = steady_clock::now();
+    const uint64_t t1 = NoteStats::ticks();
+    return (t1 - t0) / duration<double>(now - start).count();
+#else
+    return 1e9;
+#endif
+}
+
+double NoteStats::ticksPerSecond(void)
+{
+    static const double rate = measureTicksPerSecond();
+    return rate;
+}
+
+}
@@ -0,0 +1,80 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  NoteStats.h - Note Latency Histograms
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <stdint.h>
+#include <chrono>
+
+namespace zyn {
+
+/**
+ * Histogram of how many ticks (see NoteStats::ticks()) an operation took.
+ *
+ * Each octave of ticks is split into SUBDIV buckets, so percentiles are
+ * within 25% of the real value.
+ */
+struct LatencyHistogram
+{
+    enum {SUBDIV = 4, BUCKETS = 40 * SUBDIV};
+
+    void add(uint64_t ticks);
+    void reset(void);
+
+    //Upper bound of the fraction p (0..1) of the events
+    uint64_t percentile(float p) const;
+
+    //First tick count which falls into bucket b
+    static uint64_t bucketStart(int b);
+
+    uint32_t count[BUCKETS];
+    uint32_t events;
+    uint64_t total;
+    uint64_t max;
+};
+
+/**
+ * Cost of the stages of a note's life, to track down where note on
+ * causes xruns.
+ */
+class NoteStats
+{
+    public:
+        enum Stage {
+            Construct, //building the note (SynthNote::create())
+            FirstOut,  //first call of SynthNote::noteout()
+            Kill,      //destroying the note
+            STAGES
+        };
+
+        NoteStats(void);
+
+        void add(Stage stage, uint64_t ticks) { hist[stage].add(ticks); }
+        void reset(void);
+
+        //Cycle counter when there is one, nanoseconds otherwise
+        static uint64_t ticks(void)
+        {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+            return __builtin_ia32_rdtsc();
+#else
+            using namespace std::chrono;
+            return duration_cast<nanoseconds>(
+                    steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+
+        //Rate of ticks(), measured once (not realtime safe the first time)
+        static double ticksPerSecond(void);
+
+        LatencyHistogram hist[STAGES];
+};
+
+}
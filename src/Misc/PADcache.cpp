@@ -0,0 +1,295 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PADcache.cpp - On Disk Cache Of PADsynth Samples
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cstring>
+#include <cstdlib>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <utime.h>
+#include "PADcache.h"
+#include "Util.h"
+#include "SampleMemory.h"
+
+namespace zyn {
+
+/*
+ * File layout
+ *
+ *   PADcacheHeader
+ *   PADcacheEntry[count]
+ *   (padding up to PAGE)
+ *   sample 0, padded up to PAGE
+ *   ...
+ *   sample count-1
+ */
+#define PAGE 4096
+static const char     magic[8] = {'Z','Y','N','P','A','D','\0','\0'};
+static const uint32_t version  = 2;
+
+struct PADcacheHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t count;
+    uint64_t key;
+    uint32_t size;
+    uint32_t pad;
+};
+
+struct PADcacheEntry {
+    float    basefreq;
+    uint32_t written;
+    uint64_t checksum;
+};
+
+static std::mutex            cacheLock; //guards cacheDir and eviction
+static std::string           cacheDir;
+static std::atomic<uint64_t> cacheLimit(0);
+static std::atomic<unsigned> tmpcounter(0);
+
+static long pageRound(long x)
+{
+    return (x + PAGE - 1) / PAGE * PAGE;
+}
+
+static long dataOffset(int count)
+{
+    return pageRound(sizeof(PADcacheHeader) + count * sizeof(PADcacheEntry));
+}
+
+static long sampleOffset(int count, int size, int n)
+{
+    return dataOffset(count) + n * pageRound(size * sizeof(float));
+}
+
+static uint64_t checksum(const float *smp, int size)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for(int i = 0; i < size; ++i) {
+        uint32_t w;
+        memcpy(&w, smp + i, sizeof(w));
+        h = (h ^ w) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static std::string defaultDirectory(void)
+{
+    const std::string base = os_cache_dir();
+    return base.empty() ? base : base + "/padsynth";
+}
+
+static std::string fileName(const std::string &dir, uint64_t key)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.pad", (unsigned long long)key);
+    return dir + name;
+}
+
+void PADcache::setLimit(uint64_t bytes)
+{
+    cacheLimit = bytes;
+}
+
+bool PADcache::enabled(void)
+{
+    return cacheLimit != 0 && !directory().empty();
+}
+
+void PADcache::setDirectory(const std::string &dir_)
+{
+    std::lock_guard<std::mutex> guard(cacheLock);
+    cacheDir = dir_;
+}
+
+std::string PADcache::directory(void)
+{
+    std::lock_guard<std::mutex> guard(cacheLock);
+    if(cacheDir.empty())
+        cacheDir = defaultDirectory();
+    return cacheDir;
+}
+
+uint64_t PADcache::hash(const void *data, size_t len, uint64_t h)
+{
+    const unsigned char *d = (const unsigned char*)data;
+    for(size_t i = 0; i < len; ++i)
+        h = (h ^ d[i]) * 0x100000001b3ULL;
+    return h;
+}
+
+bool PADcache::load(uint64_t key, int count, int size,
+                    float **smps, float *basefreqs)
+{
+    if(!enabled() || count < 1 || count > PAD_MAX_SAMPLES)
+        return false;
+    const std::string filename = fileName(directory(), key);
+    FILE *f = fopen(filename.c_str(), "rb");
+    if(!f)
+        return false;
+
+    PADcacheHeader header;
+    PADcacheEntry  entries[PAD_MAX_SAMPLES];
+    bool   ok = fread(&header, sizeof(header), 1, f) == 1
+        && !memcmp(header.magic, magic, sizeof(magic))
+        && header.version == version && header.key == key
+        && header.count == (uint32_t)count && header.size == (uint32_t)size
+        && fread(entries, sizeof(PADcacheEntry), count, f) == (size_t)count;
+
+    int loaded = 0;
+    for(; ok && loaded < count; ++loaded) {
+        float *smp = SampleMemory::alloc(size);
+        ok = entries[loaded].written
+            && !fseek(f, sampleOffset(count, size, loaded), SEEK_SET)
+            && fread(smp, sizeof(float), size, f) == (size_t)size
+            && checksum(smp, size) == entries[loaded].checksum;
+        smps[loaded]      = smp;
+        basefreqs[loaded] = entries[loaded].basefreq;
+    }
+    fclose(f);
+
+    if(!ok) {
+        fprintf(stderr, "Removing damaged PADsynth cache file '%s'\n",
+                filename.c_str());
+        for(int i = 0; i < loaded; ++i)
+            SampleMemory::dealloc(smps[i]);
+        remove(filename.c_str());
+        return false;
+    }
+
+    //Used now, so evicted last
+    utime(filename.c_str(), NULL);
+    return true;
+}
+
+PADcache::Writer::Writer(uint64_t key_, int count_, int size_)
+    :file(NULL), key(key_), count(count_), size(size_), written(0),
+    entries(new PADcacheEntry[count_])
+{
+    memset(entries, 0, sizeof(PADcacheEntry) * count);
+    const std::string d = directory();
+    if(d.empty())
+        return;
+    os_make_dirs(d);
+    tmpname = fileName(d, key) + "." + os_pid_as_padded_string() + "."
+        + to_s(tmpcounter++) + ".tmp";
+    file = fopen(tmpname.c_str(), "wb");
+}
+
+PADcache::Writer::~Writer(void)
+{
+    if(file) {
+        fclose(file);
+        remove(tmpname.c_str());
+    }
+    delete[] entries;
+}
+
+void PADcache::Writer::write(int n, const float *smp, float basefreq)
+{
+    if(n < 0 || n >= count)
+        return;
+    const uint64_t sum = checksum(smp, size);
+    std::lock_guard<std::mutex> guard(lock);
+    if(!file || entries[n].written)
+        return;
+    if(fseek(file, sampleOffset(count, size, n), SEEK_SET)
+            || fwrite(smp, sizeof(float), size, file) != (size_t)size) {
+        //Out of disk space or the like, give up on this file
+        fclose(file);
+        remove(tmpname.c_str());
+        file = NULL;
+        return;
+    }
+    entries[n].basefreq = basefreq;
+    entries[n].written  = 1;
+    entries[n].checksum = sum;
+    written++;
+}
+
+void PADcache::Writer::commit(void)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    if(!file)
+        return;
+
+    PADcacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.count   = count;
+    header.key     = key;
+    header.size    = size;
+
+    bool ok = written == count && !fseek(file, 0, SEEK_SET)
+        && fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(entries, sizeof(PADcacheEntry), count, file) == (size_t)count;
+    ok = !fclose(file) && ok;
+    file = NULL;
+
+    const std::string filename = fileName(directory(), key);
+    if(ok) {
+        //rename() does not replace existing files everywhere
+        remove(filename.c_str());
+        ok = !rename(tmpname.c_str(), filename.c_str());
+    }
+    if(!ok) {
+        remove(tmpname.c_str());
+        return;
+    }
+    evict(filename);
+}
+
+//Removes the least recently used files (other than keep) until the cache
+//fits in its limit
+void PADcache::evict(const std::string &keep)
+{
+    struct File {
+        std::string name;
+        time_t      mtime;
+        uint64_t    size;
+    };
+
+    std::lock_guard<std::mutex> guard(cacheLock);
+    DIR *d = opendir(cacheDir.c_str());
+    if(!d)
+        return;
+
+    std::vector<File> files;
+    uint64_t total = 0;
+    while(struct dirent *e = readdir(d)) {
+        const std::string name = e->d_name;
+        if(name.size() < 4 || name.compare(name.size() - 4, 4, ".pad"))
+            continue;
+        struct stat st;
+        const std::string path = cacheDir + "/" + name;
+        if(stat(path.c_str(), &st))
+            continue;
+        total += st.st_size;
+        if(path != keep)
+            files.push_back({path, st.st_mtime, (uint64_t)st.st_size});
+    }
+    closedir(d);
+
+    std::sort(files.begin(), files.end(), [](const File &a, const File &b)
+            {return a.mtime < b.mtime;});
+    for(auto &f:files) {
+        if(total <= cacheLimit)
+            break;
+        if(!remove(f.name.c_str()))
+            total -= f.size;
+    }
+}
+
+}
@@ -0,0 +1,86 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PADcache.h - On Disk Cache Of PADsynth Samples
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <stdint.h>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+namespace zyn {
+
+/**
+ * On disk cache of the samples generated by PADsynth.
+ *
+ * Each set of samples is stored in its own file named after a hash of every
+ * parameter which affects the samples. The file starts with a header holding
+ * a checksum of each sample and the samples follow it aligned to pages, so
+ * the file may also be memory mapped. Damaged files are removed when they are
+ * read and once the cache grows past its limit the least recently used files
+ * are removed.
+ */
+class PADcache
+{
+    public:
+        //Limits the size of the cache in bytes (0 disables the cache)
+        static void setLimit(uint64_t bytes);
+        static bool enabled(void);
+
+        //Directory the files are kept in, by default the user's cache dir
+        static void setDirectory(const std::string &dir);
+        static std::string directory(void);
+
+        //64 bit FNV-1a hash (chainable through h)
+        static uint64_t hash(const void *data, size_t len,
+                             uint64_t h = 0xcbf29ce484222325ULL);
+
+        /**
+         * Reads the samples stored for key
+         * @param count number of samples, at most PAD_MAX_SAMPLES
+         * @param size  floats per sample
+         * @param smps  receives count buffers of SampleMemory::alloc()
+         * @param basefreqs receives the base frequency of each sample
+         * @return false if nothing usable is stored for key
+         */
+        static bool load(uint64_t key, int count, int size,
+                         float **smps, float *basefreqs);
+
+        /**
+         * Stores the samples of one key as they are generated.
+         *
+         * The file only becomes visible to load() once every sample was
+         * written and commit() was called.
+         */
+        class Writer
+        {
+            public:
+                Writer(uint64_t key, int count, int size);
+                ~Writer(void);
+
+                //May be called by several threads at once
+                void write(int n, const float *smp, float basefreq);
+                void commit(void);
+
+            private:
+                std::mutex  lock;
+                FILE       *file;
+                std::string tmpname;
+                uint64_t    key;
+                int         count, size, written;
+                struct PADcacheEntry *entries;
+        };
+
+    private:
+        static void evict(const std::string &keep);
+};
+
+}
@@ -0,0 +1,193 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PADpool.cpp - Long Lived Workers For PADsynth Sample Generation
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "PADpool.h"
+#include "../DSP/FFTwrapper.h"
+#include <algorithm>
+
+namespace zyn {
+
+PADpool::Workspace::Workspace(void)
+    :size(0), fft(nullptr), fftfreqs(nullptr), spectrum(nullptr)
+{}
+
+PADpool::Workspace::~Workspace(void)
+{
+    release();
+}
+
+void PADpool::Workspace::prepare(int size_)
+{
+    if(size == size_)
+        return;
+
+    release();
+    size     = size_;
+    fft      = new FFTwrapper(size);
+    fftfreqs = new fft_t[size / 2];
+    spectrum = new float[size / 2];
+}
+
+void PADpool::Workspace::release(void)
+{
+    delete fft;
+    delete [] fftfreqs;
+    delete [] spectrum;
+    size     = 0;
+    fft      = nullptr;
+    fftfreqs = nullptr;
+    spectrum = nullptr;
+}
+
+PADpool::PADpool(int nworkers, int idle_ms)
+    :nthreads(std::max(0, std::min(nworkers, (int)MAX_WORKERS))),
+     threads(nullptr),
+     wake(nullptr), quit(false), workspace(nullptr), idle(idle_ms),
+     holding(false), stop(false), job(nullptr), job_abort(nullptr),
+     participants(0)
+{
+    for(int i = 0; i < MAX_WORKERS + 1; ++i) {
+        ranges[i].next = 0;
+        ranges[i].end  = 0;
+    }
+#ifdef WIN32
+    //C++11 threads are broken on mingw cross compilation
+    nthreads = 0;
+#endif
+    done.init(PTHREAD_PROCESS_PRIVATE, 0);
+    workspace = new Workspace[nthreads + 1];
+#ifndef WIN32
+    reapThread = std::thread(&PADpool::reaper, this);
+#endif
+    if(nthreads == 0)
+        return;
+
+    wake    = new ZynSema[nthreads];
+    threads = new std::thread[nthreads];
+    for(int i = 0; i < nthreads; ++i) {
+        wake[i].init(PTHREAD_PROCESS_PRIVATE, 0);
+        threads[i] = std::thread(&PADpool::worker, this, i);
+    }
+}
+
+PADpool::~PADpool(void)
+{
+    if(reapThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> guard(idleLock);
+            stop = true;
+        }
+        idleCond.notify_one();
+        reapThread.join();
+    }
+
+    quit = true;
+    for(int i = 0; i < nthreads; ++i)
+        wake[i].post();
+    for(int i = 0; i < nthreads; ++i)
+        threads[i].join();
+
+    delete [] threads;
+    delete [] wake;
+    delete [] workspace;
+}
+
+void PADpool::run(const job_t &job_, int njobs, const abort_t &do_abort,
+                  unsigned max_threads)
+{
+    if(njobs <= 0)
+        return;
+
+    std::lock_guard<std::mutex> guard(batch);
+
+    int helpers = std::min(njobs - 1, nthreads);
+    if(max_threads)
+        helpers = std::min(helpers, (int)max_threads - 1);
+
+    job          = &job_;
+    job_abort    = &do_abort;
+    participants = helpers + 1;
+    for(int i = 0; i < participants; ++i) {
+        ranges[i].next.store(njobs * i / participants, std::memory_order_relaxed);
+        ranges[i].end = njobs * (i + 1) / participants;
+    }
+
+    for(int i = 0; i < helpers; ++i)
+        wake[i].post();
+
+    drain(0);
+
+    //Barrier
+    for(int i = 0; i < helpers; ++i)
+        done.wait();
+
+    job       = nullptr;
+    job_abort = nullptr;
+
+    {
+        std::lock_guard<std::mutex> idling(idleLock);
+        lastBatch = std::chrono::steady_clock::now();
+        holding   = true;
+    }
+    idleCond.notify_one();
+}
+
+void PADpool::drain(int self)
+{
+    Workspace &ws = workspace[self];
+    for(int k = 0; k < participants; ++k) {
+        Range &r = ranges[(self + k) % participants];
+        int idx;
+        while(!aborted() &&
+              (idx = r.next.fetch_add(1, std::memory_order_relaxed)) < r.end)
+            (*job)(ws, idx);
+    }
+}
+
+void PADpool::reaper(void)
+{
+    std::unique_lock<std::mutex> lock(idleLock);
+    while(!stop) {
+        if(!holding) {
+            idleCond.wait(lock);
+            continue;
+        }
+        const auto due = lastBatch + idle;
+        if(std::chrono::steady_clock::now() < due) {
+            idleCond.wait_until(lock, due);
+            continue;
+        }
+
+        //A batch in progress stamps lastBatch again once it is done (the
+        //batch lock is only tried, as run() takes idleLock while holding it)
+        std::unique_lock<std::mutex> guard(batch, std::try_to_lock);
+        if(!guard.owns_lock()) {
+            idleCond.wait(lock);
+            continue;
+        }
+        for(int i = 0; i < nthreads + 1; ++i)
+            workspace[i].release();
+        holding = false;
+    }
+}
+
+void PADpool::worker(int id)
+{
+    while(true) {
+        wake[id].wait();
+        if(quit)
+            return;
+        drain(id + 1);
+        done.post();
+    }
+}
+
+}
@@ -0,0 +1,123 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PADpool.h - Long Lived Workers For PADsynth Sample Generation
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "../globals.h"
+#include "../Nio/ZynSema.h"
+
+namespace zyn {
+
+/**
+ * Worker threads which compute the samples of PADnoteParameters.
+ *
+ * Unlike RenderPool these threads are not realtime, as sample generation
+ * happens outside of the audio thread.
+ *
+ * - Each thread owns a Workspace with an IFFT and scratch spectra, which is
+ *   only rebuilt when the sample size changes. As they take ~26MB per thread
+ *   for the largest samples, they are freed once no batch came for idle_ms
+ * - run() splits the jobs into one contiguous range per thread; once a thread
+ *   is done with its own range it steals jobs from the others. The calling
+ *   thread takes part as well and run() acts as a barrier for all of them
+ * - No further jobs are started once do_abort() returns true. Jobs may poll
+ *   aborted() to stop early themselves
+ * - Batches from different threads take turns
+ */
+class PADpool
+{
+    public:
+        //Scratch data of a single thread
+        struct Workspace {
+            Workspace(void);
+            ~Workspace(void);
+            //Make fft, fftfreqs and spectrum fit a sample of size samples
+            void prepare(int size) NONREALTIME;
+            //Free everything until the next prepare()
+            void release(void) NONREALTIME;
+
+            int         size;
+            FFTwrapper *fft;
+            fft_t      *fftfreqs; //size / 2
+            float      *spectrum; //size / 2
+        };
+
+        typedef std::function<void(Workspace &ws, int idx)> job_t;
+        typedef std::function<bool()>                       abort_t;
+
+        /**
+         * @param nworkers number of helper threads (0 runs everything within
+         *                 the calling thread)
+         * @param idle_ms  time without batches after which the workspaces
+         *                 are freed*/
+        PADpool(int nworkers, int idle_ms = 10000) NONREALTIME;
+        PADpool(const PADpool&) = delete;
+        ~PADpool(void) NONREALTIME;
+
+        //Number of helper threads
+        int workers(void) const { return nthreads; }
+
+        /**
+         * Invoke job(ws, i) for each i in [0, njobs) until do_abort() holds.
+         * Returns once every started job has been completed.
+         * @param max_threads upper bound on the threads (including the
+         *                    calling one) working on this batch, or zero */
+        void run(const job_t &job, int njobs, const abort_t &do_abort,
+                 unsigned max_threads = 0) NONREALTIME;
+
+        //Whether the current batch has been aborted (for use within jobs)
+        bool aborted(void) const { return (*job_abort)(); }
+
+        //Upper bound on the number of helper threads
+        static const int MAX_WORKERS = 32;
+
+    private:
+        void worker(int id);
+        void drain(int self);
+        //Frees the workspaces once the pool has been idle for idle_ms
+        void reaper(void);
+
+        int          nthreads;
+        std::thread *threads;
+        ZynSema     *wake; //one per worker
+        ZynSema      done;
+        bool         quit;
+        Workspace   *workspace; //one per worker plus one for the caller
+        std::mutex   batch;
+
+        //Idle tracking (see reaper())
+        std::thread                           reapThread;
+        std::mutex                            idleLock;
+        std::condition_variable               idleCond;
+        std::chrono::milliseconds             idle;
+        std::chrono::steady_clock::time_point lastBatch;
+        bool                                  holding; //workspaces allocated
+        bool                                  stop;
+
+        //Current batch
+        const job_t   *job;
+        const abort_t *job_abort;
+        int            participants;
+
+        //Jobs [next, end) still to be claimed by (or stolen from) a thread
+        struct alignas(64) Range {
+            std::atomic<int> next;
+            int              end;
+        };
+        Range ranges[MAX_WORKERS + 1];
+};
+
+}
@@ -102,6 +102,20 @@ static const Ports partPorts = {
     {"captureMax:", rDoc("Capture maximum valid note"), NULL,
         [](const char *, RtData &r)
         {Part *p = (Part*)r.obj; p->Pmaxkey = p->lastnote;}},
+    {"note-stats:", rDoc("Grab note latency histograms\n"
+            "Replies with the rate of the ticks and a LatencyHistogram blob"
+            " for note construction, first output and kill"), NULL,
+        [](const char *, RtData &d)
+        {
+            const NoteStats &s = ((Part*)d.obj)->notePool.stats;
+            d.reply(d.loc, "fbbb", (float)NoteStats::ticksPerSecond(),
+                    sizeof(LatencyHistogram), &s.hist[NoteStats::Construct],
+                    sizeof(LatencyHistogram), &s.hist[NoteStats::FirstOut],
+                    sizeof(LatencyHistogram), &s.hist[NoteStats::Kill]);
+        }},
+    {"reset-note-stats:", rDoc("Clear note latency histograms"), NULL,
+        [](const char *, RtData &d)
+        {((Part*)d.obj)->notePool.stats.reset();}},
     {"polyType::c:i", rProp(parameter) rOptions(Polyphonic, Monophonic, Legato)
         rDoc("Synthesis polyphony type\n"
                 "Polyphonic - Each note is played independently\n"
@@ -228,6 +242,7 @@ Part::Part(Allocator &alloc, const SYNTH_T &synth_, const AbsTime &time_,
     Plegatomode(false),
     partoutl(new float[synth_.buffersize]),
     partoutr(new float[synth_.buffersize]),
+    rng(RandomStream::global()),
     ctl(synth_, &time_),
     microtonal(microtonal_),
     fft(fft_),
@@ -523,21 +538,31 @@ bool Part::NoteOn(unsigned char note,
             continue;
 
         SynthParams pars{memory, ctl, synth, time, notebasefreq, vel,
-            portamento, note, false};
+            portamento, note, false, &rng};
         const int sendto = Pkitmode ? item.sendto() : 0;
 
         try {
-            if(item.Padenabled)
-                notePool.insertNote(note, sendto,
-                        {memory.alloc<ADnote>(kit[i].adpars, pars,
-                            wm, (pre+"kit"+i+"/adpars/").c_str), 0, i});
-            if(item.Psubenabled)
-                notePool.insertNote(note, sendto,
-                        {memory.alloc<SUBnote>(kit[i].subpars, pars, wm, (pre+"kit"+i+"/subpars/").c_str), 1, i});
-            if(item.Ppadenabled)
-                notePool.insertNote(note, sendto,
-                        {memory.alloc<PADnote>(kit[i].padpars, pars, interpolation, wm,
-                            (pre+"kit"+i+"/padpars/").c_str), 2, i});
+            if(item.Padenabled) {
+                const uint64_t t = NoteStats::ticks();
+                SynthNote *sn = SynthNote::create<ADnote>(kit[i].adpars, pars,
+                        wm, (pre+"kit"+i+"/adpars/").c_str);
+                notePool.stats.add(NoteStats::Construct, NoteStats::ticks() - t);
+                notePool.insertNote(note, sendto, {sn, 0, i});
+            }
+            if(item.Psubenabled) {
+                const uint64_t t = NoteStats::ticks();
+                SynthNote *sn = SynthNote::create<SUBnote>(kit[i].subpars, pars,
+                        wm, (pre+"kit"+i+"/subpars/").c_str);
+                notePool.stats.add(NoteStats::Construct, NoteStats::ticks() - t);
+                notePool.insertNote(note, sendto, {sn, 1, i});
+            }
+            if(item.Ppadenabled) {
+                const uint64_t t = NoteStats::ticks();
+                SynthNote *sn = SynthNote::create<PADnote>(kit[i].padpars, pars,
+                        interpolation, wm, (pre+"kit"+i+"/padpars/").c_str);
+                notePool.stats.add(NoteStats::Construct, NoteStats::ticks() - t);
+                notePool.insertNote(note, sendto, {sn, 2, i});
+            }
         } catch (std::bad_alloc & ba) {
             std::cerr << "dropped new note: " << ba.what() << std::endl;
         }
@@ -790,6 +815,24 @@ void Part::AllNotesOff()
  * Compute Part samples and store them in the partoutl[] and partoutr[]
  */
 void Part::ComputePartSmps()
+{
+    ComputePartSmps(NULL, 0);
+}
+
+int Part::gatherNotes(NoteRenderJob *jobs, int max_jobs)
+{
+    int njobs = 0;
+    for(auto &d:notePool.activeDesc()) {
+        for(auto &s:notePool.activeNotes(d)) {
+            if(njobs >= max_jobs)
+                return njobs;
+            jobs[njobs++].note = s.note;
+        }
+    }
+    return njobs;
+}
+
+void Part::ComputePartSmps(const NoteRenderJob *jobs, int njobs)
 {
     assert(partefx[0]);
     for(unsigned nefx = 0; nefx < NUM_PART_EFX + 1; ++nefx) {
@@ -797,17 +840,36 @@ void Part::ComputePartSmps()
         memset(partfxinputr[nefx], 0, synth.bufferbytes);
     }
 
+    //Mixed in note order, so the result does not depend upon where the
+    //pre-rendered notes were computed
+    int job = 0;
     for(auto &d:notePool.activeDesc()) {
         d.age++;
         for(auto &s:notePool.activeNotes(d)) {
             float tmpoutr[synth.buffersize];
             float tmpoutl[synth.buffersize];
             auto &note = *s.note;
-            note.noteout(&tmpoutl[0], &tmpoutr[0]);
+            const float *outl = tmpoutl;
+            const float *outr = tmpoutr;
+            uint64_t cost;
+            if(job < njobs && jobs[job].note == &note) {
+                outl = jobs[job].outl;
+                outr = jobs[job].outr;
+                cost = jobs[job].ticks;
+                job++;
+            } else {
+                const uint64_t t = NoteStats::ticks();
+                note.noteout(&tmpoutl[0], &tmpoutr[0]);
+                cost = NoteStats::ticks() - t;
+            }
+            if(!s.rendered) {
+                notePool.stats.add(NoteStats::FirstOut, cost);
+                s.rendered = true;
+            }
 
             for(int i = 0; i < synth.buffersize; ++i) { //add the note to part(mix)
-                partfxinputl[d.sendto][i] += tmpoutl[i];
-                partfxinputr[d.sendto][i] += tmpoutr[i];
+                partfxinputl[d.sendto][i] += outl[i];
+                partfxinputr[d.sendto][i] += outr[i];
             }
 
             if(note.finished())
@@ -1033,11 +1095,41 @@ void Part::applyparameters(void)
     applyparameters([]{return false;});
 }
 
-void Part::applyparameters(std::function<bool()> do_abort)
+void Part::applyparameters(std::function<bool()> do_abort, PADpool *pool,
+                           bool lazy)
 {
-    for(int n = 0; n < NUM_KIT_ITEMS; ++n)
-        if(kit[n].Ppadenabled && kit[n].padpars)
-            kit[n].padpars->applyparameters(do_abort);
+    //Size the note blocks now rather than with the first notes played.
+    //The notes are built from a scratch allocator, the ADnote before the
+    //wavetables exist, so it computes its own waves (as at the frequencies
+    //without a table) and leaves nothing in the tables' share slots. The
+    //shared FFTwrapper gives this thread buffers of its own.
+    Alloc        scratch;
+    RandomStream scratchrng;
+    SynthParams  pars{scratch, ctl, synth, time, 440.0f, 1.0f, false, 69,
+                      false, &scratchrng};
+    for(int n = 0; n < NUM_KIT_ITEMS; ++n) {
+        Kit &k = kit[n];
+        try {
+            if(k.Padenabled && k.adpars) {
+                k.adpars->droptables();
+                SynthNote::measure<ADnote>(k.adpars, pars);
+            }
+            if(k.Psubenabled && k.subpars)
+                SynthNote::measure<SUBnote>(k.subpars, pars);
+        } catch(std::bad_alloc &) {
+            //the notes still learn the layout as they are created
+        }
+
+        if(k.Padenabled && k.adpars)
+            k.adpars->applyparameters();
+        if(k.Ppadenabled && k.padpars) {
+            k.padpars->applyparameters(do_abort, 0, pool, lazy);
+            try {
+                SynthNote::measure<PADnote>(k.padpars, pars, interpolation);
+            } catch(std::bad_alloc &) {
+            }
+        }
+    }
 }
 
 void Part::initialize_rt(void)
@@ -1051,6 +1143,11 @@ void Part::kill_rt(void)
     for(int i=0; i<NUM_PART_EFX; ++i)
         partefx[i]->kill();
     notePool.killAllNotes();
+    //The wavetable buffers are freed here rather than by the thread
+    //deleting the part, which would contend for the realtime allocator
+    for(int i=0; i<NUM_KIT_ITEMS; ++i)
+        if(kit[i].adpars)
+            kit[i].adpars->releasetables();
 }
 
 void Part::monomemPush(char note)
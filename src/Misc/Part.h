@@ -19,11 +19,22 @@
 #include "../globals.h"
 #include "../Params/Controller.h"
 #include "../Containers/NotePool.h"
+#include "Util.h"
 
 #include <functional>
 
 namespace zyn {
 
+/** Note which is rendered ahead of Part::ComputePartSmps() into its own
+ *  scratch buffer, so that the notes of one part can be spread over several
+ *  threads (see Master::AudioOut)*/
+struct NoteRenderJob {
+    SynthNote *note;
+    float     *outl;
+    float     *outr;
+    uint64_t   ticks; //cost of the noteout() call (see NoteStats)
+};
+
 /** Part implementation*/
 class Part
 {
@@ -58,6 +69,16 @@ class Part
         /* The synthesizer part output */
         void ComputePartSmps() REALTIME; //Part output
 
+        /**Lists the notes which will be mixed by the next ComputePartSmps()
+         * The order matches the order they are mixed in.
+         * @param jobs storage for at most max_jobs jobs (only note is set)
+         * @return number of jobs filled in*/
+        int gatherNotes(NoteRenderJob *jobs, int max_jobs) REALTIME;
+        /**Part output where the first njobs notes have already been rendered
+         * (by any thread) into the job buffers.
+         * Remaining notes are rendered in place.*/
+        void ComputePartSmps(const NoteRenderJob *jobs, int njobs) REALTIME;
+
 
         //saves the instrument settings to a XML file
         //returns 0 for ok or <0 if there is an error
@@ -71,7 +92,10 @@ class Part
         void defaultsinstrument();
 
         void applyparameters(void) NONREALTIME;
-        void applyparameters(std::function<bool()> do_abort) NONREALTIME;
+        //lazy: see PADnoteParameters::applyparameters()
+        void applyparameters(std::function<bool()> do_abort,
+                             PADpool *pool = NULL,
+                             bool lazy = false) NONREALTIME;
 
         void initialize_rt(void) REALTIME;
         void kill_rt(void) REALTIME;
@@ -140,6 +164,10 @@ class Part
         float *partoutl; //Left channel output of the part
         float *partoutr; //Right channel output of the part
 
+        //Source of the per note random streams
+        //(bound to the global generator unless Master assigns one)
+        RandomStream rng;
+
         float *partfxinputl[NUM_PART_EFX + 1], //Left and right signal that pass thru part effects;
         *partfxinputr[NUM_PART_EFX + 1];          //partfxinput l/r [NUM_PART_EFX] is for "no effect" buffer
 
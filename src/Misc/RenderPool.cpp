@@ -0,0 +1,137 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  RenderPool.cpp - Persistent Worker Threads For Parallel Rendering
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "RenderPool.h"
+#include <algorithm>
+#include <cstdio>
+#ifndef WIN32
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace zyn {
+
+thread_local int RenderPool::self = -1;
+
+RenderPool::RenderPool(int nworkers, unsigned ncpu)
+    :nthreads(std::max(0, std::min(nworkers, (int)MAX_WORKERS))),
+     threads(nullptr),
+     wake(nullptr), quit(false), job(nullptr), job_data(nullptr),
+     participants(0)
+{
+    for(int i = 0; i < MAX_WORKERS + 1; ++i) {
+        ranges[i].next = 0;
+        ranges[i].end  = 0;
+    }
+#ifdef WIN32
+    //C++11 threads are broken on mingw cross compilation (see
+    //PADnoteParameters::sampleGenerator), so render in the audio thread
+    nthreads = 0;
+#endif
+    //Workers sharing the only core with the audio thread, at its priority,
+    //would spin on the allocator locks in its place
+    if(ncpu <= 1)
+        nthreads = 0;
+    done.init(PTHREAD_PROCESS_PRIVATE, 0);
+    if(nthreads == 0)
+        return;
+
+    wake    = new ZynSema[nthreads];
+    threads = new std::thread[nthreads];
+    for(int i = 0; i < nthreads; ++i) {
+        wake[i].init(PTHREAD_PROCESS_PRIVATE, 0);
+        threads[i] = std::thread(&RenderPool::worker, this, i);
+    }
+
+#ifndef WIN32
+    for(int i = 0; i < nthreads; ++i) {
+        pthread_t handle = threads[i].native_handle();
+#ifdef HAVE_SCHEDULER
+        //Same priority as the audio thread (see set_realtime())
+        sched_param sc;
+        sc.sched_priority = 60;
+        if(pthread_setschedparam(handle, SCHED_FIFO, &sc))
+            fprintf(stderr, "[INFO] RenderPool worker %d is not realtime\n", i);
+#else
+        (void) handle;
+#endif
+    }
+#endif
+}
+
+RenderPool::~RenderPool(void)
+{
+    quit = true;
+    for(int i = 0; i < nthreads; ++i)
+        wake[i].post();
+    for(int i = 0; i < nthreads; ++i)
+        threads[i].join();
+
+    delete [] threads;
+    delete [] wake;
+}
+
+void RenderPool::run(job_t job_, void *data, int njobs)
+{
+    if(njobs <= 0)
+        return;
+
+    //Not worth waking anyone
+    if(nthreads == 0 || njobs == 1) {
+        for(int i = 0; i < njobs; ++i)
+            job_(data, i);
+        return;
+    }
+
+    //Only wake up as many workers as can possibly have work
+    const int helpers = njobs - 1 < nthreads ? njobs - 1 : nthreads;
+
+    job          = job_;
+    job_data     = data;
+    participants = helpers + 1;
+    for(int i = 0; i < participants; ++i) {
+        ranges[i].next.store(njobs * i / participants, std::memory_order_relaxed);
+        ranges[i].end = njobs * (i + 1) / participants;
+    }
+
+    for(int i = 0; i < helpers; ++i)
+        wake[i].post();
+
+    drain(0);
+
+    //Barrier
+    for(int i = 0; i < helpers; ++i)
+        done.wait();
+}
+
+void RenderPool::drain(int self)
+{
+    for(int k = 0; k < participants; ++k) {
+        Range &r = ranges[(self + k) % participants];
+        int idx;
+        while((idx = r.next.fetch_add(1, std::memory_order_relaxed)) < r.end)
+            job(job_data, idx);
+    }
+}
+
+void RenderPool::worker(int id)
+{
+    self = id + 1;
+    while(true) {
+        wake[id].wait();
+        if(quit)
+            return;
+        drain(id + 1);
+        done.post();
+    }
+}
+
+}
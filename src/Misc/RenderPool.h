@@ -0,0 +1,94 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  RenderPool.h - Persistent Worker Threads For Parallel Rendering
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <atomic>
+#include <thread>
+#include "../globals.h"
+#include "../Nio/ZynSema.h"
+
+namespace zyn {
+
+/**
+ * Fixed size set of worker threads which help the audio thread to compute
+ * independent jobs (e.g. one job per enabled part).
+ *
+ * - Threads are spawned (and joined) outside of the realtime thread
+ * - Each worker is given realtime priority when the platform allows it. They
+ *   are left to the scheduler rather than pinned, as the core the audio
+ *   thread runs on is not known here
+ * - Each thread knows its index (see current()), so that objects shared by
+ *   all of them can keep separate scratch buffers (e.g. FFTwrapper)
+ * - run() splits the jobs into one contiguous range per thread; once a thread
+ *   is done with its own range it steals jobs from the others. The calling
+ *   thread takes part as well and run() acts as a barrier for all of them
+ * - No allocation or locking of mutexes takes place within run()
+ */
+class RenderPool
+{
+    public:
+        typedef void (*job_t)(void *data, int idx);
+
+        /**
+         * @param nworkers number of helper threads (0 runs everything within
+         *                 the calling thread)
+         * @param ncpu     cores of the machine; with a single one (or an
+         *                 unknown count) everything runs in the calling
+         *                 thread as well*/
+        RenderPool(int nworkers,
+                   unsigned ncpu = std::thread::hardware_concurrency())
+            NONREALTIME;
+        RenderPool(const RenderPool&) = delete;
+        ~RenderPool(void) NONREALTIME;
+
+        //Number of helper threads
+        int workers(void) const { return nthreads; }
+
+        /**
+         * Invoke job(data, i) for each i in [0, njobs).
+         * Returns once every job has been completed.*/
+        void run(job_t job, void *data, int njobs) REALTIME;
+
+        //Upper bound on the number of helper threads
+        static const int MAX_WORKERS = 32;
+
+        //Render thread calling: 0 for the audio thread (see
+        //Master::AudioOut()), 1 + id for the workers and -1 for any other
+        static int current(void) { return self; }
+        //Marks the calling thread as the audio thread
+        static void audiothread(void) { self = 0; }
+
+    private:
+        void worker(int id);
+        void drain(int self);
+
+        int          nthreads;
+        std::thread *threads;
+        ZynSema     *wake; //one per worker
+        ZynSema      done;
+        bool         quit;
+
+        //Current batch
+        job_t            job;
+        void            *job_data;
+        int              participants;
+
+        //Jobs [next, end) still to be claimed by (or stolen from) a thread
+        struct alignas(64) Range {
+            std::atomic<int> next;
+            int              end;
+        };
+        Range ranges[MAX_WORKERS + 1];
+
+        static thread_local int self;
+};
+
+}
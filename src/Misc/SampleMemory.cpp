@@ -0,0 +1,237 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  SampleMemory.cpp - Memory For Sample Tables Read By The Realtime Thread
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "SampleMemory.h"
+#include <atomic>
+#include <new>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#ifndef WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace zyn {
+
+/*
+ * Layout of a table
+ *
+ *   TableHeader, padded up to HEADER bytes
+ *   n floats
+ *   (padding up to the page or huge page size)
+ */
+#define HEADER    64
+#define HUGE_PAGE (2 << 20)
+
+enum {
+    TABLE_LOCKED = 1,
+    TABLE_HUGE   = 2
+};
+
+struct TableHeader {
+    size_t   length; //of the mapping
+    size_t   huge;   //bytes of it on huge pages
+    uint32_t flags;
+};
+
+static std::atomic<bool>     lockTables(true);
+static std::atomic<bool>     hugeTables(false);
+static std::atomic<uint64_t> nTables(0), nBytes(0), nLocked(0), nHuge(0);
+
+void SampleMemory::setLock(bool lock)
+{
+    lockTables = lock;
+}
+
+void SampleMemory::setHugePages(bool huge)
+{
+    hugeTables = huge;
+}
+
+static size_t roundUp(size_t x, size_t to)
+{
+    return (x + to - 1) / to * to;
+}
+
+static TableHeader *header(const float *smp)
+{
+    return (TableHeader *)((char *)smp - HEADER);
+}
+
+#ifndef WIN32
+/*
+ * madvise(MADV_HUGEPAGE) succeeds even when the transparent huge pages end up
+ * not being used (disabled, or no free huge page when the table was faulted
+ * in), so this reads what the kernel reports for the mapping (AnonHugePages
+ * of /proc/self/smaps). When the kernel merged the table with a neighbouring
+ * mapping this covers both, so it is limited to the length of the table.
+ */
+static size_t transparentHugeBytes(const void *mem, size_t length)
+{
+    FILE *f = fopen("/proc/self/smaps", "r");
+    if(!f)
+        return 0;
+    const unsigned long addr = (unsigned long)mem;
+    bool   inside = false;
+    size_t bytes  = 0;
+    char   line[256];
+    while(fgets(line, sizeof(line), f)) {
+        unsigned long start, end, kb;
+        if(sscanf(line, "%lx-%lx ", &start, &end) == 2)
+            inside = start <= addr && addr < end;
+        else if(inside && sscanf(line, "AnonHugePages: %lu kB", &kb) == 1) {
+            bytes = kb * 1024;
+            break;
+        }
+    }
+    fclose(f);
+    return bytes < length ? bytes : length;
+}
+
+float *SampleMemory::alloc(size_t n)
+{
+    const size_t page  = sysconf(_SC_PAGESIZE);
+    const size_t bytes = HEADER + n * sizeof(float);
+    size_t   length = roundUp(bytes, page);
+    size_t   huge   = 0;
+    uint32_t flags  = 0;
+    void    *mem    = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    //Fails unless huge pages were reserved (vm.nr_hugepages)
+    if(hugeTables && bytes >= HUGE_PAGE / 2) {
+        mem = mmap(NULL, roundUp(bytes, HUGE_PAGE), PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if(mem != MAP_FAILED) {
+            length = roundUp(bytes, HUGE_PAGE);
+            huge   = length;
+            flags |= TABLE_HUGE;
+        }
+    }
+#endif
+    if(mem == MAP_FAILED) {
+        mem = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(mem == MAP_FAILED)
+            throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+        if(hugeTables && length >= HUGE_PAGE
+           && !madvise(mem, length, MADV_HUGEPAGE))
+            flags |= TABLE_HUGE;
+#endif
+    }
+
+    //Fault in every page now rather than in the realtime thread
+    for(size_t i = 0; i < length; i += page)
+        ((volatile char *)mem)[i] = 0;
+    if(lockTables && !mlock(mem, length))
+        flags |= TABLE_LOCKED;
+    //Only now does the kernel know if it used huge pages for the advice
+    if((flags & TABLE_HUGE) && !huge) {
+        huge = transparentHugeBytes(mem, length);
+        if(!huge)
+            flags &= ~TABLE_HUGE;
+    }
+
+    TableHeader *h = (TableHeader *)mem;
+    h->length = length;
+    h->huge   = huge;
+    h->flags  = flags;
+
+    nTables++;
+    nBytes += length;
+    if(flags & TABLE_LOCKED)
+        nLocked += length;
+    nHuge += huge;
+    return (float *)((char *)mem + HEADER);
+}
+
+void SampleMemory::dealloc(float *smp)
+{
+    if(!smp)
+        return;
+    TableHeader *h = header(smp);
+    const size_t   length = h->length;
+    const uint32_t flags  = h->flags;
+
+    nTables--;
+    nBytes -= length;
+    if(flags & TABLE_LOCKED)
+        nLocked -= length;
+    nHuge -= h->huge;
+    munmap(h, length);
+}
+
+void SampleMemory::stats(const float *smp, Stats &s)
+{
+    if(!smp)
+        return;
+    const TableHeader *h = header(smp);
+    s.tables++;
+    s.bytes += h->length;
+    if(h->flags & TABLE_LOCKED)
+        s.locked += h->length;
+    s.huge += h->huge;
+
+    const size_t page = sysconf(_SC_PAGESIZE);
+    std::vector<unsigned char> in((h->length + page - 1) / page);
+    if(mincore((void *)h, h->length, in.data()))
+        return;
+    for(size_t i = 0; i < in.size(); ++i)
+        if(in[i] & 1)
+            s.resident += page;
+}
+#else
+float *SampleMemory::alloc(size_t n)
+{
+    char        *mem = new char[HEADER + n * sizeof(float)];
+    TableHeader *h   = (TableHeader *)mem;
+    h->length = HEADER + n * sizeof(float);
+    h->huge   = 0;
+    h->flags  = 0;
+    nTables++;
+    nBytes += h->length;
+    return (float *)(mem + HEADER);
+}
+
+void SampleMemory::dealloc(float *smp)
+{
+    if(!smp)
+        return;
+    TableHeader *h = header(smp);
+    nTables--;
+    nBytes -= h->length;
+    delete [] (char *)h;
+}
+
+void SampleMemory::stats(const float *smp, Stats &s)
+{
+    if(!smp)
+        return;
+    s.tables++;
+    s.bytes    += header(smp)->length;
+    s.resident += header(smp)->length;
+}
+#endif
+
+SampleMemory::Stats SampleMemory::stats(void)
+{
+    Stats s;
+    s.tables   = nTables;
+    s.bytes    = nBytes;
+    s.locked   = nLocked;
+    s.huge     = nHuge;
+    s.resident = 0;
+    return s;
+}
+
+}
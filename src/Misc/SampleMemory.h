@@ -0,0 +1,60 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  SampleMemory.h - Memory For Sample Tables Read By The Realtime Thread
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <stdint.h>
+#include <cstddef>
+#include "../globals.h"
+
+namespace zyn {
+
+/**
+ * Allocation of the large sample tables of PADsynth.
+ *
+ * The tables are written by worker threads and then only read by the
+ * realtime thread, which must not take page faults on them. Each table gets
+ * its own anonymous mapping, which
+ * - is touched page by page when allocated, so it is never faulted in later
+ * - is locked into RAM (if enabled and permitted by RLIMIT_MEMLOCK), so it
+ *   is never paged out
+ * - is backed by huge pages (if enabled): explicit ones with MAP_HUGETLB
+ *   when the system has some reserved, transparent ones through madvise()
+ *   otherwise, which saves TLB misses when playing through large tables
+ *
+ * Without mmap() (Windows) plain new[] is used.
+ */
+class SampleMemory
+{
+    public:
+        //Options for the following allocations
+        static void setLock(bool lock);
+        static void setHugePages(bool huge);
+
+        //Table of n floats (failures throw std::bad_alloc like new[])
+        static float *alloc(size_t n) NONREALTIME;
+        //Frees a table of alloc() (NULL is ignored)
+        static void dealloc(float *smp) NONREALTIME;
+
+        struct Stats {
+            uint64_t tables;   //number of tables
+            uint64_t bytes;    //bytes mapped for them
+            uint64_t locked;   //bytes locked into RAM
+            uint64_t huge;     //bytes the kernel put on huge pages
+            uint64_t resident; //bytes in RAM right now
+        };
+
+        //All tables (resident is left at zero)
+        static Stats stats(void);
+        //Adds a single table to s (with resident)
+        static void stats(const float *smp, Stats &s) NONREALTIME;
+};
+
+}
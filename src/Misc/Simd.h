@@ -0,0 +1,91 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  Simd.h - Runtime Selection Of Vectorized Kernels
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+
+/*
+ * Kernels are written as plain loops over a fixed number of lanes and the
+ * compiler vectorizes them for the instruction set of the build (SSE2 or
+ * NEON with the default release flags).
+ *
+ * On x86 a second copy of a kernel may be compiled for AVX2:
+ *
+ *     template<...> static ZYN_KERNEL void body(...) {...}
+ *     static void kernel(...) {body(...);}
+ *     ZYN_TARGET_AVX2 static void kernelAVX2(...) {body(...);}
+ *
+ * and picked at runtime with cpuHasAVX2().
+ *
+ * Where the compiler fails to vectorize a loop on its own, ZYN_SIMD_VECTOR
+ * offers eight lane vector types using the GCC vector extensions. They map to
+ * two SSE2 or NEON registers, or one AVX2 register.
+ *
+ * Kernels streaming through tables too large for the caches may hint the
+ * upcoming reads with ZYN_PREFETCH(addr).
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ZYN_SIMD_AVX2 1
+#define ZYN_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#ifdef __GNUC__
+#define ZYN_KERNEL inline __attribute__((always_inline))
+#else
+#define ZYN_KERNEL inline
+#endif
+
+#ifdef __GNUC__
+#define ZYN_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define ZYN_PREFETCH(addr)
+#endif
+
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 9)
+#define ZYN_SIMD_VECTOR 1
+#endif
+
+#include <stdint.h>
+
+namespace zyn {
+
+#ifdef ZYN_SIMD_VECTOR
+typedef float   vfloat8 __attribute__((vector_size(32)));
+typedef int32_t vint8   __attribute__((vector_size(32)));
+typedef uint32_t vuint8 __attribute__((vector_size(32)));
+
+#define vtofloat(x) __builtin_convertvector(x, vfloat8)
+#define vtoint(x)   __builtin_convertvector(x, vint8)
+
+/*
+ * Helpers producing a vector hand it back through a pointer, as returning a
+ * vfloat8 by value changes the ABI in builds without AVX (-Wpsabi). Once
+ * inlined the code is the same.
+ */
+
+//mask ? a : out for each lane, into out
+ZYN_KERNEL void vselect(const vint8 &mask, const vfloat8 &a, vfloat8 *out)
+{
+    *out = (vfloat8)((mask & (vint8)a) | (~mask & (vint8)*out));
+}
+#endif
+
+//True if the AVX2 build of the kernels may be used
+inline bool cpuHasAVX2(void)
+{
+#ifdef ZYN_SIMD_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+#else
+    return false;
+#endif
+}
+
+}
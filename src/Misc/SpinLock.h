@@ -0,0 +1,69 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  SpinLock.h - Minimal RT-Safe Lock
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <atomic>
+
+namespace zyn {
+
+//Busy waiting lock for the short critical sections which are shared between
+//realtime render threads (never hold it around anything which could block)
+//
+//Compatible with std::lock_guard
+class SpinLock
+{
+    public:
+        SpinLock(void) {flag.clear();}
+        SpinLock(const SpinLock&) = delete;
+
+        void lock(void)
+        {
+            while(flag.test_and_set(std::memory_order_acquire))
+                ;
+        }
+
+        void unlock(void)
+        {
+            flag.clear(std::memory_order_release);
+        }
+
+    private:
+        std::atomic_flag flag;
+};
+
+//SpinLock which is only taken once enabled, for objects which are only
+//shared between threads while parts render in parallel (see RenderPool)
+class OptionalSpinLock
+{
+    public:
+        OptionalSpinLock(void) :enabled(false) {}
+
+        //Only while no other thread uses the guarded object
+        void enable(bool on) {enabled = on;}
+
+        void lock(void)
+        {
+            if(enabled)
+                spin.lock();
+        }
+
+        void unlock(void)
+        {
+            if(enabled)
+                spin.unlock();
+        }
+
+    private:
+        SpinLock spin;
+        bool     enabled;
+};
+
+}
@@ -13,10 +13,12 @@
 
 #include "globals.h"
 #include "Util.h"
+#include "Simd.h"
 #include <vector>
 #include <cassert>
 #include <cmath>
 #include <cstdio>
+#include <cstdlib>
 #include <fstream>
 
 #include <sys/types.h>
@@ -198,6 +200,40 @@ std::string os_pid_as_padded_string()
     return result_str + max_pid_len + written - os_guess_pid_length();
 }
 
+std::string os_cache_dir()
+{
+    const char *xdg  = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+#ifdef _WIN32
+    if(!home)
+        home = getenv("LOCALAPPDATA");
+#endif
+    std::string base;
+    if(xdg && *xdg)
+        base = xdg;
+    else if(home && *home)
+        base = std::string(home) + "/.cache";
+    else
+        return "";
+    return base + "/zynaddsubfx";
+}
+
+static void os_make_dir(const std::string &path)
+{
+#ifdef _WIN32
+    mkdir(path.c_str());
+#else
+    mkdir(path.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+#endif
+}
+
+void os_make_dirs(const std::string &path)
+{
+    for(size_t i = 1; i <= path.size(); ++i)
+        if(i == path.size() || path[i] == '/')
+            os_make_dir(path.substr(0, i));
+}
+
 std::string legalizeFilename(std::string filename)
 {
     for(int i = 0; i < (int) filename.size(); ++i) {
@@ -219,6 +255,156 @@ float SYNTH_T::numRandom()
     return RND;
 }
 
+RandomStream RandomStream::split(void)
+{
+    if(shared())
+        return *this;
+
+    //Scramble the parent output so that sibling streams do not end up as
+    //shifted copies of the parent sequence
+    prng_t h = next() ^ 0x9e3779b9;
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return RandomStream(h);
+}
+
+/*
+ * out[i] = rnd() * scale + offset
+ *
+ * The LCG is stepped in LANES interleaved lanes, each one jumping LANES
+ * states ahead at a time, which yields the very same sequence as repeated
+ * rnd() calls without the serial dependency
+ */
+static ZYN_KERNEL void rndBody(prng_t &src, float *out, int n, float scale,
+                               float offset)
+{
+    const int LANES = 8;
+    if(n < 2 * LANES) {
+        for(int i = 0; i < n; ++i)
+            out[i] = (prng_r(src) & 0x7fffffff) / (INT32_MAX * 1.0f) * scale
+                     + offset;
+        return;
+    }
+
+    prng_t lane[LANES];
+    prng_t mul = 1, add = 0;
+    for(int k = 0; k < LANES; ++k) {
+        lane[k] = prng_r(src);
+        mul     = mul * 1103515245;
+        add     = add * 1103515245 + 12345;
+    }
+
+    int i = 0;
+    while(true) {
+        for(int k = 0; k < LANES; ++k)
+            out[i + k] = (int32_t)(lane[k] & 0x7fffffff) / (INT32_MAX * 1.0f)
+                         * scale + offset;
+        i += LANES;
+        if(i + LANES > n)
+            break;
+        for(int k = 0; k < LANES; ++k)
+            lane[k] = lane[k] * mul + add;
+    }
+    src = lane[LANES - 1];
+
+    for(; i < n; ++i)
+        out[i] = (prng_r(src) & 0x7fffffff) / (INT32_MAX * 1.0f) * scale
+                 + offset;
+}
+
+/*
+ * Paul Kellet's pinking filter, applied in place
+ *
+ * Its six one pole sections are independent of each other, so they are
+ * stepped side by side in the lanes of a vector (the last two lanes idle)
+ */
+static ZYN_KERNEL void pinkBody(float *state, float *smps, int n)
+{
+    const int L = 8;
+    const float c[L] = {0.99886f, 0.99332f, 0.96900f, 0.86650f, 0.55000f,
+                        -0.7616f, 0.0f, 0.0f};
+    const float g[L] = {0.0555179f, 0.0750759f, 0.1538520f, 0.3104856f,
+                        0.5329522f, -0.0168980f, 0.0f, 0.0f};
+    float f[L];
+    for(int k = 0; k < L; ++k)
+        f[k] = k < 6 ? state[k] : 0.0f;
+    float last = state[6];
+
+    for(int i = 0; i < n; ++i) {
+        const float white = smps[i];
+        for(int k = 0; k < L; ++k)
+            f[k] = c[k] * f[k] + g[k] * white;
+        float sum = 0.0f;
+        for(int k = 0; k < L; ++k)
+            sum += f[k];
+        smps[i] = sum + last + white * 0.5362f;
+        last    = white * 0.115926f;
+    }
+
+    for(int k = 0; k < 6; ++k)
+        state[k] = f[k];
+    state[6] = last;
+}
+
+static void rndFillBase(prng_t &src, float *out, int n, float scale,
+                        float offset)
+{
+    rndBody(src, out, n, scale, offset);
+}
+
+static void pinkBase(float *state, float *smps, int n)
+{
+    pinkBody(state, smps, n);
+}
+
+#ifdef ZYN_SIMD_AVX2
+ZYN_TARGET_AVX2
+static void rndFillAVX2(prng_t &src, float *out, int n, float scale,
+                        float offset)
+{
+    rndBody(src, out, n, scale, offset);
+}
+
+ZYN_TARGET_AVX2
+static void pinkAVX2(float *state, float *smps, int n)
+{
+    pinkBody(state, smps, n);
+}
+#endif
+
+static void rndFill(prng_t &src, float *out, int n, float scale, float offset)
+{
+#ifdef ZYN_SIMD_AVX2
+    if(cpuHasAVX2())
+        return rndFillAVX2(src, out, n, scale, offset);
+#endif
+    rndFillBase(src, out, n, scale, offset);
+}
+
+void RandomStream::fill(float *out, int n)
+{
+    rndFill(*src, out, n, 1.0f, 0.0f);
+}
+
+void RandomStream::white(float *out, int n)
+{
+    rndFill(*src, out, n, 2.0f, -1.0f);
+}
+
+void RandomStream::pink(float *out, int n, float *state)
+{
+    //the filter input is a quarter of rnd() - 0.5
+    rndFill(*src, out, n, 0.25f, -0.125f);
+#ifdef ZYN_SIMD_AVX2
+    if(cpuHasAVX2())
+        return pinkAVX2(state, out, n);
+#endif
+    pinkBase(state, out, n);
+}
+
 float interpolate(const float *data, size_t len, float pos)
 {
     assert(len > (size_t)pos + 1);
@@ -64,6 +64,11 @@ void os_usleep(long length);
 //! returns pid padded to maximum pid lenght, posix conform
 std::string os_pid_as_padded_string();
 
+//! per user cache directory of zynaddsubfx (empty if there is none)
+std::string os_cache_dir();
+//! creates path along with any missing parents
+void os_make_dirs(const std::string &path);
+
 std::string legalizeFilename(std::string filename);
 
 void invSignal(float *sig, size_t len);
@@ -146,6 +151,70 @@ inline void sprng(prng_t p)
 #endif
 #define RND (prng() / (INT32_MAX * 1.0f))
 
+//Values of the filter state of a RandomStream::pink() noise
+#define PINK_STATE 7
+
+/**
+ * Independent stream of the prng() sequence
+ *
+ * Each Master, Part and note owns one, so rendering does not depend upon the
+ * order in which threads happen to draw numbers.
+ * A stream may also be bound to the global prng_state (see global()), which
+ * reproduces the single threaded behavior of RND/prng() exactly.
+ *
+ * A stream must only be used from one thread at a time.
+ */
+class RandomStream
+{
+    public:
+        explicit RandomStream(prng_t seed = 0x1234)
+            :state(seed), src(&state) {}
+        RandomStream(const RandomStream &r)
+            :state(r.state), src(r.shared() ? r.src : &state) {}
+        RandomStream &operator=(const RandomStream &r)
+        {
+            state = r.state;
+            src   = r.shared() ? r.src : &state;
+            return *this;
+        }
+
+        //Stream which draws from (and advances) the global prng_state
+        static RandomStream global(void)
+        {
+            RandomStream r;
+            r.src = &prng_state;
+            return r;
+        }
+
+        bool shared(void) const { return src != &state; }
+
+        void seed(prng_t p) { *src = p; }
+
+        //Equivalent of prng()
+        prng_t next(void) { return prng_r(*src) & 0x7fffffff; }
+
+        //Equivalent of RND
+        float rnd(void) { return next() / (INT32_MAX * 1.0f); }
+
+        //Deterministically derived stream for a child object (e.g. a note)
+        //Streams bound to the global state yield bound streams
+        RandomStream split(void);
+
+        //out[i] = rnd() for n values (vectorizable)
+        void fill(float *out, int n);
+
+        //Bulk noise of n values from this stream (vectorized):
+        //white noise, out[i] = 2 * rnd() - 1
+        void white(float *out, int n);
+        //pink noise of the PINK_STATE filter values in state (zeroed for a
+        //new sound)
+        void pink(float *out, int n, float *state);
+
+    private:
+        prng_t  state;
+        prng_t *src;
+};
+
 //Linear Interpolation
 float interpolate(const float *data, size_t len, float pos);
 
@@ -205,6 +205,7 @@ static const Ports voicePorts = {
                 int k=(int) rtosc_argument(msg, 0).i;
                 if (k<0) k+=16;
                 obj->PCoarseDetune = k*1024 + obj->PCoarseDetune%1024;
+                rChangeCb
             }
         }},
     {"coarsedetune::c:i", rProp(parameter) rShort("coarse") rLinear(-64,63)
@@ -220,6 +221,7 @@ static const Ports voicePorts = {
                 int k=(int) rtosc_argument(msg, 0).i;
                 if (k<0) k+=1024;
                 obj->PCoarseDetune = k + (obj->PCoarseDetune/1024)*1024;
+                rChangeCb
             }
         }},
     {"PFMVolume::i", rShort("vol.") rLinear(0,127)
@@ -230,8 +232,10 @@ static const Ports voicePorts = {
             if (!rtosc_narguments(msg))
                 d.reply(d.loc, "i", (int)roundf(127.0f * obj->FMvolume
                     / 100.0f));
-            else
+            else {
                 obj->FMvolume = 100.0f * rtosc_argument(msg, 0).i / 127.0f;
+                rChangeCb
+            }
         }},
     //weird stuff for PCoarseDetune
     {"FMdetunevalue:", rMap(unit,cents) rDoc("Get modulator detune"), NULL, [](const char *, RtData &d)
@@ -256,6 +260,7 @@ static const Ports voicePorts = {
                 int k=(int) rtosc_argument(msg, 0).i;
                 if (k<0) k+=16;
                 obj->PFMCoarseDetune = k*1024 + obj->PFMCoarseDetune%1024;
+                rChangeCb
             }
         }},
     {"FMcoarsedetune::c:i", rProp(parameter) rShort("coarse") rLinear(-64,63)
@@ -271,6 +276,7 @@ static const Ports voicePorts = {
                 int k=(int) rtosc_argument(msg, 0).i;
                 if (k<0) k+=1024;
                 obj->PFMCoarseDetune = k + (obj->PFMCoarseDetune/1024)*1024;
+                rChangeCb
             }
         }},
 
@@ -361,6 +367,7 @@ static const Ports globalPorts = {
                 int k=(int) rtosc_argument(msg, 0).i;
                 if (k<0) k+=16;
                 obj->PCoarseDetune = k*1024 + obj->PCoarseDetune%1024;
+                rChangeCb
             }
         }},
     {"coarsedetune::c:i", rProp(parameter) rShort("coarse") rLinear(-64, 63)
@@ -376,6 +383,7 @@ static const Ports globalPorts = {
                 int k=(int) rtosc_argument(msg, 0).i;
                 if (k<0) k+=1024;
                 obj->PCoarseDetune = k + (obj->PCoarseDetune/1024)*1024;
+                rChangeCb
             }
         }},
 
@@ -617,6 +625,22 @@ float ADnoteParameters::getUnisonFrequencySpreadCents(int nvoice) const
     return VoicePar[nvoice].getUnisonFrequencySpreadCents();
 }
 
+/*
+ * Get the time stamp notes compare with to see if a voice must be set up
+ * again (global parameters like the detune type affect every voice)
+ */
+int64_t ADnoteParameters::getVoiceUpdateTimestamp(int nvoice) const
+{
+    if(!time)
+        return -1;
+    int64_t stamp = GlobalPar.last_update_timestamp;
+    if(VoicePar[nvoice].last_update_timestamp > stamp)
+        stamp = VoicePar[nvoice].last_update_timestamp;
+    if(last_update_timestamp > stamp)
+        stamp = last_update_timestamp;
+    return stamp;
+}
+
 float ADnoteVoiceParam::getUnisonFrequencySpreadCents(void) const {
     return powf(Unison_frequency_spread / 127.0 * 2.0f, 2.0f) * 50.0f; //cents
 }
@@ -1031,6 +1055,42 @@ void ADnoteParameters::pasteArray(ADnoteParameters &a, int nvoice)
     }
 }
 
+void ADnoteParameters::applyparameters(void)
+{
+    bool osc[NUM_VOICES] = {}, mod[NUM_VOICES] = {};
+    for(int i = 0; i < NUM_VOICES; ++i) {
+        const ADnoteVoiceParam &voice = VoicePar[i];
+        if(!voice.Enabled)
+            continue;
+        osc[voice.Pextoscil != -1 ? voice.Pextoscil : i] = true;
+        if(voice.PFMEnabled && voice.PFMVoice < 0)
+            mod[voice.PextFMoscil != -1 ? voice.PextFMoscil : i] = true;
+    }
+
+    for(int i = 0; i < NUM_VOICES; ++i) {
+        if(osc[i])
+            VoicePar[i].OscilSmp->preparetables();
+        if(mod[i])
+            VoicePar[i].FMSmp->preparetables();
+    }
+}
+
+void ADnoteParameters::droptables(void)
+{
+    for(int i = 0; i < NUM_VOICES; ++i) {
+        VoicePar[i].OscilSmp->droptables();
+        VoicePar[i].FMSmp->droptables();
+    }
+}
+
+void ADnoteParameters::releasetables(void)
+{
+    for(int i = 0; i < NUM_VOICES; ++i) {
+        VoicePar[i].OscilSmp->releasetables();
+        VoicePar[i].FMSmp->releasetables();
+    }
+}
+
 #define copy(x) this->x = a.x
 #define RCopy(x) this->x->paste(*a.x)
 void ADnoteVoiceParam::paste(ADnoteVoiceParam &a)
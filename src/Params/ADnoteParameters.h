@@ -15,6 +15,7 @@
 #define AD_NOTE_PARAMETERS_H
 
 #include "../globals.h"
+#include "../Misc/Allocator.h"
 #include "PresetsArray.h"
 
 namespace zyn {
@@ -323,9 +324,21 @@ class ADnoteParameters:public PresetsArray
         void paste(ADnoteParameters &a);
         void pasteArray(ADnoteParameters &a, int section);
 
+        //! Compute the wavetables of the oscillators used by the voices
+        //! (only before the instance is handed to the realtime thread)
+        void applyparameters(void) NONREALTIME;
+        //! Delete the wavetables of the voices (under the same conditions)
+        void droptables(void) NONREALTIME;
+        //! Drop the buffers the wavetables handed out to the notes (before
+        //! the instance leaves the realtime thread)
+        void releasetables(void) REALTIME;
+
 
         float getBandwidthDetuneMultiplier() const;
         float getUnisonFrequencySpreadCents(int nvoice) const;
+        //! Time stamp of the last change which may affect voice nvoice, or
+        //! -1 if changes are not tracked (no time source)
+        int64_t getVoiceUpdateTimestamp(int nvoice) const;
         static const rtosc::Ports &ports;
         void defaults(int n); //n is the nvoice
         void add2XMLsection(XMLwrapper& xml, int n);
@@ -334,6 +347,9 @@ class ADnoteParameters:public PresetsArray
         const AbsTime *time;
         int64_t last_update_timestamp;
 
+        //Size of the arena the notes are built in (see SynthNote::create())
+        mutable NoteLayout layout;
+
     private:
         void EnableVoice(const SYNTH_T &synth, int nvoice, const AbsTime* time);
         void KillVoice(int nvoice);
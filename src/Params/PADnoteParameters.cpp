@@ -20,6 +20,9 @@
 #include "../Synth/OscilGen.h"
 #include "../Misc/WavFile.h"
 #include "../Misc/Time.h"
+#include "../Misc/PADcache.h"
+#include "../Misc/PADpool.h"
+#include "../Misc/SampleMemory.h"
 #include <cstdio>
 #include <thread>
 
@@ -84,18 +87,22 @@ static const rtosc::Ports realtime_ports =
             rOptions(L35cents, L10cents, E100cents, E1200cents),
             rDefault(L10cents), "Magnitude of Detune"),
 
-    {"sample#64:ifb", rProp(internal) rDoc("Nothing to see here"), 0,
+    {"sample#64:ifbi", rProp(internal) rDoc("Nothing to see here"), 0,
         [](const char *m, rtosc::RtData &d)
         {
             PADnoteParameters *p = (PADnoteParameters*)d.obj;
             const char *mm = m;
             while(!isdigit(*mm))++mm;
             unsigned n = atoi(mm);
+            //Samples get replaced several times per prepare (see
+            //NonRtObjStore), so hand the old buffer back for deletion
+            if(p->sample[n].smp)
+                d.reply("/free", "sb", "PADsample", sizeof(float*),
+                        &p->sample[n].smp);
             p->sample[n].size     = rtosc_argument(m,0).i;
             p->sample[n].basefreq = rtosc_argument(m,1).f;
             p->sample[n].smp      = *(float**)rtosc_argument(m,2).b.data;
-
-            //XXX TODO memory managment (deallocation of smp buffer)
+            p->sample[n].format   = rtosc_argument(m,3).i;
         }},
     //weird stuff for PCoarseDetune
     {"detunevalue:", rMap(unit,cents) rDoc("Get detune value"), NULL,
@@ -230,6 +237,12 @@ static const rtosc::Ports non_realtime_ports =
             "Samples per octave"),
     rParamI(Pquality.oct, rShort("octaves"), rLinear(0,7), rDefault(3),
             "Number of octaves to sample (above the first sample"),
+    rOption(Pquality.storage, rShort("storage"),
+            rOptions(float, float16, int16),
+            rDefault(float),
+            "Format the samples are kept in (16 bit formats halve the memory)"),
+    rToggle(Plazy, rShort("lazy"), rDefault(false),
+            "Compute the full quality samples of the played keys first"),
 
     {"Pbandwidth::i", rShort("bandwidth") rProp(parameter) rLinear(0,1000)
         rDefault(500) rDoc("Bandwith Of Harmonics"), NULL,
@@ -285,6 +298,16 @@ static const rtosc::Ports non_realtime_ports =
             d.replyArray(d.loc, types, args);
 #undef RES
         }},
+    {"sample-memory:", rProp(non-realtime)
+        rDoc("Memory of the samples: tables, bytes, locked, huge and resident bytes"),
+        NULL, [](const char *, rtosc::RtData &d) {
+            PADnoteParameters *p = ((PADnoteParameters*)d.obj);
+            SampleMemory::Stats s = {0, 0, 0, 0, 0};
+            for(int i = 0; i < PAD_MAX_SAMPLES; ++i)
+                SampleMemory::stats(p->sample[i].smp, s);
+            d.reply(d.loc, "hhhhh", s.tables, s.bytes, s.locked, s.huge,
+                    s.resident);
+        }},
     {"needPrepare:", rDoc("Unimplemented Stub"),
         NULL, [](const char *, rtosc::RtData&) {}},
 };
@@ -324,8 +347,13 @@ PADnoteParameters::PADnoteParameters(const SYNTH_T &synth_, FFTwrapper *fft_,
     FilterEnvelope->init(ad_global_filter);
     FilterLfo = new LFOParams(ad_global_filter, time_);
 
-    for(int i = 0; i < PAD_MAX_SAMPLES; ++i)
-        sample[i].smp = NULL;
+    for(int i = 0; i < PAD_MAX_SAMPLES; ++i) {
+        sample[i].smp    = NULL;
+        sample[i].format = PAD_FLOAT;
+        sample[i].key    = 0;
+    }
+    playedkeys[0] = 0;
+    playedkeys[1] = 0;
 
     defaults();
 }
@@ -376,6 +404,8 @@ void PADnoteParameters::defaults()
     Pquality.basenote   = 4;
     Pquality.oct    = 3;
     Pquality.smpoct = 2;
+    Pquality.storage = PAD_FLOAT;
+    Plazy = false;
 
     PStereo = 1; //stereo
     /* Frequency Global Parameters */
@@ -416,10 +446,12 @@ void PADnoteParameters::deletesample(int n)
     if((n < 0) || (n >= PAD_MAX_SAMPLES))
         return;
 
-    delete[] sample[n].smp;
+    SampleMemory::dealloc(sample[n].smp);
     sample[n].smp = NULL;
     sample[n].size     = 0;
     sample[n].basefreq = 440.0f;
+    sample[n].format   = PAD_FLOAT;
+    sample[n].key      = 0;
 }
 
 void PADnoteParameters::deletesamples()
@@ -832,16 +864,25 @@ void PADnoteParameters::applyparameters()
 }
 
 void PADnoteParameters::applyparameters(std::function<bool()> do_abort,
-                                        unsigned max_threads)
+                                        unsigned max_threads,
+                                        PADpool *pool,
+                                        bool lazy)
 {
     if(do_abort())
         return;
-    unsigned num = sampleGenerator([this]
-                       (unsigned N, PADnoteParameters::Sample &smp) {
-                           delete[] sample[N].smp;
-                           sample[N] = smp;
-                       },
-                       do_abort, max_threads);
+    //Samples whose spectrum did not change are kept
+    uint64_t current[PAD_MAX_SAMPLES];
+    for(int i = 0; i < PAD_MAX_SAMPLES; ++i)
+        current[i] = sample[i].key;
+    auto cb = [this](unsigned N, PADnoteParameters::Sample &smp) {
+                  SampleMemory::dealloc(sample[N].smp);
+                  sample[N] = smp;
+              };
+    unsigned num;
+    if(lazy && Plazy)
+        num = previewGenerator(cb, do_abort, pool, current);
+    else
+        num = sampleGenerator(cb, do_abort, max_threads, pool, current);
 
     //Delete remaining unused samples
     for(unsigned i = num; i < PAD_MAX_SAMPLES; ++i)
@@ -853,22 +894,32 @@ void PADnoteParameters::applyparameters(std::function<bool()> do_abort,
 // - Pquality.basenote
 // - Pquality.oct
 // - Pquality.smpoct
+// - Pquality.storage
 // - spectrum at various frequencies (oodles of data)
 int PADnoteParameters::sampleGenerator(PADnoteParameters::callback cb,
         std::function<bool()> do_abort,
-        unsigned max_threads)
+        unsigned max_threads,
+        PADpool *pool,
+        const uint64_t *current,
+        uint64_t mask)
 {
-    if(!max_threads)
-        max_threads = std::numeric_limits<unsigned>::max();
-
-    const int samplesize   = (((int) 1) << (Pquality.samplesize + 14));
-    const int spectrumsize = samplesize / 2;
-    const int profilesize = 512;
+    return generator(cb, do_abort, max_threads, pool, current, mask,
+                     samplesize(), true);
+}
 
-    float     profile[profilesize];
+const int PADnoteParameters::PREVIEW_SIZE;
 
+int PADnoteParameters::previewGenerator(PADnoteParameters::callback cb,
+        std::function<bool()> do_abort,
+        PADpool *pool,
+        const uint64_t *current)
+{
+    return generator(cb, do_abort, 0, pool, current, ~(uint64_t)0,
+                     std::min(samplesize(), (int)PREVIEW_SIZE), false);
+}
 
-    const float bwadjust = getprofile(profile, profilesize);
+int PADnoteParameters::samplefreqs(float *basefreqs) const
+{
     float basefreq = 65.406f * powf(2.0f, Pquality.basenote / 2);
     if(Pquality.basenote % 2 == 1)
         basefreq *= 1.5f;
@@ -894,91 +945,272 @@ int PADnoteParameters::sampleGenerator(PADnoteParameters::callback cb,
     for(int nsample = 0; nsample < samplemax; ++nsample)
         adj[nsample] = (Pquality.oct + 1.0f) * (float)nsample / samplemax;
 
+    for(int nsample = 0; nsample < samplemax; ++nsample)
+        basefreqs[nsample] = basefreq *
+            powf(2.0f, adj[nsample] - adj[samplemax - 1] * 0.5f);
+    return samplemax;
+}
+
+void PADnoteParameters::markplayed(float freq) const
+{
+    const int key = limit((int)lrintf(12.0f * log2f(freq / 440.0f)) + 69,
+                          0, 127);
+    if(!(playedkeys[key / 64].load(std::memory_order_relaxed)
+         & ((uint64_t)1 << (key % 64))))
+        playedkeys[key / 64].fetch_or((uint64_t)1 << (key % 64),
+                                      std::memory_order_relaxed);
+}
+
+//Convert the n floats of smp into the given PADformat
+static float *encodeSample(float *smp, int n, int format)
+{
+    if(format == PAD_FLOAT)
+        return smp;
+
+    float *packed = SampleMemory::alloc(PADnoteParameters::storage(n, format));
+    packed[PADnoteParameters::storage(n, format) - 1] = 0.0f;
+    if(format == PAD_HALF) {
+        uint16_t *dst = (uint16_t *)packed;
+        for(int i = 0; i < n; ++i)
+            dst[i] = float2half(smp[i]);
+    }
+    else {
+        int16_t *dst = (int16_t *)packed;
+        const float scale = 32767.0f / PAD_INT16_RANGE;
+        for(int i = 0; i < n; ++i)
+            dst[i] = (int16_t)lrintf(limit(smp[i] * scale, -32767.0f, 32767.0f));
+    }
+    SampleMemory::dealloc(smp);
+    return packed;
+}
+
+//Hash of everything generatespectrum_*() use for the sample at basefreq.
+//Harmonics which do not reach the spectrum are left out, so that e.g. a
+//change to a high harmonic leaves the keys of the high samples alone
+uint64_t PADnoteParameters::spectrumKey(float basefreq,
+                                        const float *profile,
+                                        int profilesize,
+                                        float bwadjust) const
+{
+    float harmonics[synth.oscilsize];
+    memset(harmonics, 0, sizeof(float) * synth.oscilsize);
+    oscilgen->get(harmonics, basefreq, false);
+    normalize_max(harmonics, synth.oscilsize / 2);
+
+    uint64_t key = PADcache::hash(&Pmode, sizeof(Pmode));
+    key = PADcache::hash(&basefreq, sizeof(basefreq), key);
+    key = PADcache::hash(&synth.samplerate, sizeof(synth.samplerate), key);
+
+    for(int nh = 1; nh < synth.oscilsize / 2; ++nh) {
+        const float realfreq = getNhr(nh) * basefreq;
+        if(realfreq > synth.samplerate_f * 0.49999f)
+            break;
+        if(realfreq < 20.0f)
+            break;
+        if(Pmode == 0 && harmonics[nh - 1] < 1e-4)
+            continue;
+
+        float amp = harmonics[nh - 1];
+        if(resonance->Penabled)
+            amp *= resonance->getfreqresponse(realfreq);
+
+        key = PADcache::hash(&nh, sizeof(nh), key);
+        key = PADcache::hash(&realfreq, sizeof(realfreq), key);
+        key = PADcache::hash(&amp, sizeof(amp), key);
+    }
+
+    if(Pmode == 0) {
+        key = PADcache::hash(&Pbandwidth, sizeof(Pbandwidth), key);
+        key = PADcache::hash(&Pbwscale, sizeof(Pbwscale), key);
+        key = PADcache::hash(&bwadjust, sizeof(bwadjust), key);
+        key = PADcache::hash(profile, sizeof(float) * profilesize, key);
+    }
+    return key;
+}
+
+int PADnoteParameters::generator(PADnoteParameters::callback cb,
+        std::function<bool()> do_abort,
+        unsigned max_threads,
+        PADpool *pool,
+        const uint64_t *current,
+        uint64_t mask,
+        int samplesize,
+        bool cacheable)
+{
+    if(!max_threads)
+        max_threads = std::numeric_limits<unsigned>::max();
+
+    const int spectrumsize = samplesize / 2;
+    const int profilesize = 512;
+
+    float     profile[profilesize];
+
+
+    const float bwadjust = getprofile(profile, profilesize);
+
+    //Each sample is identified by the inputs of its spectrum, its size and
+    //its format.
+    //Samples whose key the caller already has (at this size or at full
+    //size) are not computed again.
+    //Each sample also gets its own phase stream, seeded from its spectrum,
+    //so the result neither depends upon the number of threads nor upon
+    //which samples are computed
+    const int fullsize = this->samplesize();
+    const int format   = Pquality.storage;
+    float     basefreqs[PAD_MAX_SAMPLES];
+    uint64_t  spectrumkeys[PAD_MAX_SAMPLES];
+    uint64_t  keys[PAD_MAX_SAMPLES];
+    int       todo[PAD_MAX_SAMPLES];
+    int       ntodo = 0;
+    const int samplemax = samplefreqs(basefreqs);
+    for(int nsample = 0; nsample < samplemax; ++nsample) {
+        spectrumkeys[nsample] = spectrumKey(basefreqs[nsample], profile,
+                                            profilesize, bwadjust);
+        const uint64_t formatkey = PADcache::hash(&format, sizeof(format),
+                                                  spectrumkeys[nsample]);
+        keys[nsample] = PADcache::hash(&samplesize, sizeof(samplesize),
+                                       formatkey);
+        const uint64_t fullkey = PADcache::hash(&fullsize, sizeof(fullsize),
+                                                formatkey);
+        if(!current || (current[nsample] != keys[nsample]
+                        && current[nsample] != fullkey))
+            todo[ntodo++] = nsample;
+    }
+
+    if(ntodo == 0)
+        return samplemax;
+
     const PADnoteParameters* this_c = this;
 
-    auto thread_cb = [basefreq, bwadjust, &cb, do_abort,
-                      samplesize, samplemax, spectrumsize,
-                      &adj, &profile, this_c](
-                      unsigned nthreads, unsigned threadno)
+    //the last samples contains the first samples
+    //(used for linear/cubic interpolation)
+    const int extra_samples = 5;
+    //floats per stored sample
+    const int smpfloats = storage(samplesize + extra_samples, format);
+
+    //The disk cache holds complete sets of samples only (see PADcache)
+    cacheable = cacheable && ntodo == samplemax && PADcache::enabled();
+    const uint64_t key = cacheable ? sampleKey() : 0;
+
+    if(cacheable) {
+        float *smps[PAD_MAX_SAMPLES];
+        float  cachedfreqs[PAD_MAX_SAMPLES];
+        if(PADcache::load(key, samplemax, smpfloats, smps, cachedfreqs)) {
+            for(int nsample = 0; nsample < samplemax; ++nsample) {
+                PADnoteParameters::Sample cached;
+                cached.size     = samplesize;
+                cached.basefreq = cachedfreqs[nsample];
+                cached.smp      = smps[nsample];
+                cached.format   = format;
+                cached.key      = keys[nsample];
+                cb(nsample, cached);
+            }
+            return samplemax;
+        }
+    }
+
+    //Only the samples in mask are computed
+    int nmasked = 0;
+    for(int i = 0; i < ntodo; ++i)
+        if((mask >> todo[i]) & 1)
+            todo[nmasked++] = todo[i];
+    cacheable = cacheable && nmasked == samplemax;
+    ntodo     = nmasked;
+    if(ntodo == 0)
+        return samplemax;
+
+    PADcache::Writer *writer = cacheable ?
+        new PADcache::Writer(key, samplemax, smpfloats) : NULL;
+
+    //A pool is only spawned for this call when the caller has none
+    PADpool *local = NULL;
+    if(!pool) {
+        const unsigned ncpu = std::max(1u, std::thread::hardware_concurrency());
+        local = new PADpool(std::min(max_threads, ncpu) - 1);
+        pool  = local;
+    }
+
+    auto sample_cb = [bwadjust, &cb, pool, samplesize, spectrumsize,
+                      &basefreqs, &spectrumkeys, &keys, &todo,
+                      &profile, this_c, writer, format](
+                      PADpool::Workspace &ws, int idx)
     {
-        //prepare a BIG IFFT
-        FFTwrapper *fft      = new FFTwrapper(samplesize);
-        fft_t      *fftfreqs = new fft_t[samplesize / 2];
-        float      *spectrum = new float[spectrumsize];
-
-        for(int nsample = 0; nsample < samplemax; ++nsample)
-        if(nsample % nthreads == threadno)
-         {
-            if(do_abort())
-                break;
-            const float basefreqadjust =
-                powf(2.0f, adj[nsample] - adj[samplemax - 1] * 0.5f);
-
-            if(this_c->Pmode == 0)
-                this_c->generatespectrum_bandwidthMode(spectrum,
-                                                       spectrumsize,
-                                                       basefreq*basefreqadjust,
-                                                       profile,
-                                                       profilesize,
-                                                       bwadjust);
-            else
-                this_c->generatespectrum_otherModes(spectrum, spectrumsize,
-                                                    basefreq * basefreqadjust);
-
-            //the last samples contains the first samples
-            //(used for linear/cubic interpolation)
-            const int extra_samples = 5;
-            PADnoteParameters::Sample newsample;
-            newsample.smp = new float[samplesize + extra_samples];
-
-            newsample.smp[0] = 0.0f;
-            for(int i = 1; i < spectrumsize; ++i) //randomize the phases
-                fftfreqs[i] = FFTpolar(spectrum[i], (float)RND * 2 * PI);
-            //that's all; here is the only ifft for the whole sample;
-            //no windows are used ;-)
-            fft->freqs2smps(fftfreqs, newsample.smp);
-
-
-            //normalize(rms)
-            float rms = 0.0f;
-            for(int i = 0; i < samplesize; ++i)
-                rms += newsample.smp[i] * newsample.smp[i];
-            rms = sqrt(rms);
-            if(rms < 0.000001f)
-                rms = 1.0f;
-            rms *= sqrt(262144.0f / samplesize);//262144=2^18
-            for(int i = 0; i < samplesize; ++i)
-                newsample.smp[i] *= 1.0f / rms * 50.0f;
-
-            //prepare extra samples used by the linear or cubic interpolation
-            for(int i = 0; i < extra_samples; ++i)
-                newsample.smp[i + samplesize] = newsample.smp[i];
-
-            //yield new sample
-            newsample.size     = samplesize;
-            newsample.basefreq = basefreq * basefreqadjust;
-            cb(nsample, newsample);
+        const int nsample = todo[idx];
+
+        //the BIG IFFT is planned once per sample size and thread
+        ws.prepare(samplesize);
+        fft_t *fftfreqs = ws.fftfreqs;
+        float *spectrum = ws.spectrum;
+
+        if(this_c->Pmode == 0)
+            this_c->generatespectrum_bandwidthMode(spectrum,
+                                                   spectrumsize,
+                                                   basefreqs[nsample],
+                                                   profile,
+                                                   profilesize,
+                                                   bwadjust);
+        else
+            this_c->generatespectrum_otherModes(spectrum, spectrumsize,
+                                                basefreqs[nsample]);
+
+        //Check again between the expensive steps, so that an abort does not
+        //have to wait for the whole sample
+        if(pool->aborted())
+            return;
+
+        PADnoteParameters::Sample newsample;
+        newsample.smp = SampleMemory::alloc(samplesize + extra_samples);
+
+        newsample.smp[0] = 0.0f;
+        const uint64_t seed = spectrumkeys[nsample];
+        RandomStream phases(seed ^ (seed >> 32));
+        for(int i = 1; i < spectrumsize; ++i) //randomize the phases
+            fftfreqs[i] = FFTpolar(spectrum[i], phases.rnd() * 2 * PI);
+        //that's all; here is the only ifft for the whole sample;
+        //no windows are used ;-)
+        ws.fft->freqs2smps(fftfreqs, newsample.smp);
+
+        if(pool->aborted()) {
+            SampleMemory::dealloc(newsample.smp);
+            return;
         }
 
-        //Cleanup
-        delete (fft);
-        delete[] fftfreqs;
-        delete[] spectrum;
+        //normalize(rms)
+        float rms = 0.0f;
+        for(int i = 0; i < samplesize; ++i)
+            rms += newsample.smp[i] * newsample.smp[i];
+        rms = sqrt(rms);
+        if(rms < 0.000001f)
+            rms = 1.0f;
+        rms *= sqrt(262144.0f / samplesize);//262144=2^18
+        for(int i = 0; i < samplesize; ++i)
+            newsample.smp[i] *= 1.0f / rms * 50.0f;
+
+        //prepare extra samples used by the linear or cubic interpolation
+        for(int i = 0; i < extra_samples; ++i)
+            newsample.smp[i + samplesize] = newsample.smp[i];
+
+        newsample.smp = encodeSample(newsample.smp, samplesize + extra_samples,
+                                     format);
+
+        //yield new sample
+        newsample.size     = samplesize;
+        newsample.basefreq = basefreqs[nsample];
+        newsample.format   = format;
+        newsample.key      = keys[nsample];
+        if(writer)
+            writer->write(nsample, newsample.smp, newsample.basefreq);
+        cb(nsample, newsample);
     };
 
-#ifdef WIN32
-    //Temporarily disable multi-threading here as C++11 threads are broken on
-    //mingw cross compilation
-    thread_cb(1,0);
-#else
-    unsigned nthreads = std::min(max_threads,
-                                 std::thread::hardware_concurrency());
-    std::vector<std::thread> threads(nthreads);
-    for(unsigned i = 0; i < nthreads; ++i)
-        threads[i] = std::thread(thread_cb, nthreads, i);
-    for(unsigned i = 0; i < nthreads; ++i)
-        threads[i].join();
-#endif
+    pool->run(sample_cb, ntodo, do_abort, max_threads);
+    delete local;
+
+    if(writer) {
+        if(!do_abort())
+            writer->commit();
+        delete writer;
+    }
 
     return samplemax;
 }
@@ -998,17 +1230,15 @@ void PADnoteParameters::export2wav(std::string basefilename)
             int nsmps = sample[k].size;
             short int *smps = new short int[nsmps];
             for(int i = 0; i < nsmps; ++i)
-                smps[i] = (short int)(sample[k].smp[i] * 32767.0f);
+                smps[i] = (short int)(sample[k].value(i) * 32767.0f);
             wav.writeMonoSamples(nsmps, smps);
         }
     }
 }
 
-void PADnoteParameters::add2XML(XMLwrapper& xml)
+//Everything the samples are generated from
+void PADnoteParameters::sample2XML(XMLwrapper& xml)
 {
-    xml.setPadSynth(true);
-
-    xml.addparbool("stereo", PStereo);
     xml.addpar("mode", Pmode);
     xml.addpar("bandwidth", Pbandwidth);
     xml.addpar("bandwidth_scale", Pbwscale);
@@ -1048,7 +1278,29 @@ void PADnoteParameters::add2XML(XMLwrapper& xml)
     xml.addpar("basenote", Pquality.basenote);
     xml.addpar("octaves", Pquality.oct);
     xml.addpar("samples_per_octave", Pquality.smpoct);
+    xml.addpar("storage", Pquality.storage);
     xml.endbranch();
+}
+
+uint64_t PADnoteParameters::sampleKey(void)
+{
+    XMLwrapper xml;
+    sample2XML(xml);
+    char *data = xml.getXMLdata();
+    uint64_t key = PADcache::hash(data, data ? strlen(data) : 0);
+    free(data);
+    const int rate = synth.samplerate, size = synth.oscilsize;
+    key = PADcache::hash(&rate, sizeof(rate), key);
+    return PADcache::hash(&size, sizeof(size), key);
+}
+
+void PADnoteParameters::add2XML(XMLwrapper& xml)
+{
+    xml.setPadSynth(true);
+
+    xml.addparbool("stereo", PStereo);
+    xml.addparbool("lazy_samples", Plazy);
+    sample2XML(xml);
 
     xml.beginbranch("AMPLITUDE_PARAMETERS");
     xml.addpar("volume", PVolume);
@@ -1109,6 +1361,7 @@ void PADnoteParameters::add2XML(XMLwrapper& xml)
 void PADnoteParameters::getfromXML(XMLwrapper& xml)
 {
     PStereo    = xml.getparbool("stereo", PStereo);
+    Plazy      = xml.getparbool("lazy_samples", Plazy);
     Pmode      = xml.getpar127("mode", 0);
     Pbandwidth = xml.getpar("bandwidth", Pbandwidth, 0, 1000);
     Pbwscale   = xml.getpar127("bandwidth_scale", Pbwscale);
@@ -1160,6 +1413,8 @@ void PADnoteParameters::getfromXML(XMLwrapper& xml)
         Pquality.oct    = xml.getpar127("octaves", Pquality.oct);
         Pquality.smpoct = xml.getpar127("samples_per_octave",
                                          Pquality.smpoct);
+        Pquality.storage = xml.getpar("storage", Pquality.storage,
+                                      PAD_FLOAT, PAD_INT16);
         xml.exitbranch();
     }
 
@@ -1257,6 +1512,8 @@ void PADnoteParameters::paste(PADnoteParameters &x)
     COPY(Pquality.basenote);
     COPY(Pquality.oct);
     COPY(Pquality.smpoct);
+    COPY(Pquality.storage);
+    COPY(Plazy);
 
     oscilgen->paste(*x.oscilgen);
     resonance->paste(*x.resonance);
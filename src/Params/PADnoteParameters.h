@@ -15,13 +15,70 @@
 #define PAD_NOTE_PARAMETERS_H
 
 #include "../globals.h"
+#include "../Misc/Allocator.h"
 
 #include "Presets.h"
 #include <string>
+#include <cstring>
+#include <atomic>
 #include <functional>
 
 namespace zyn {
 
+//Storage formats of the samples (see PADnoteParameters::Sample)
+enum PADformat {
+    PAD_FLOAT = 0, //32 bit float
+    PAD_HALF  = 1, //16 bit float
+    PAD_INT16 = 2  //16 bit integer, full scale at PAD_INT16_RANGE
+};
+
+//The samples are normalized to an rms of about 0.1, so their peaks stay
+//well below this
+const float PAD_INT16_RANGE = 1.0f;
+
+//IEEE 754 half precision conversions (without infinities and NaNs, which
+//the samples never contain)
+inline float half2float(uint16_t h)
+{
+    const uint32_t sign = (uint32_t)(h & 0x8000u) << 16;
+    uint32_t bits = (uint32_t)(h & 0x7fffu) << 13;
+    float    f;
+    memcpy(&f, &bits, sizeof(f));
+    f *= 5.192296858534828e+33f; //2^112 moves the exponent bias from 15 to 127
+    memcpy(&bits, &f, sizeof(f));
+    bits |= sign;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+//Rounds to nearest even and saturates at the largest half
+inline uint16_t float2half(float f)
+{
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    const uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    uint16_t h;
+    if(bits >= (uint32_t)(127 + 16) << 23) //too large
+        h = 0x7bff;
+    else if(bits < (uint32_t)113 << 23) { //subnormal or zero
+        const uint32_t magic_bits = (uint32_t)((127 - 15) + (23 - 10) + 1) << 23;
+        float magic, x;
+        memcpy(&magic, &magic_bits, sizeof(magic));
+        memcpy(&x, &bits, sizeof(x));
+        x += magic;
+        memcpy(&bits, &x, sizeof(bits));
+        h = bits - magic_bits;
+    }
+    else {
+        const uint32_t odd = (bits >> 13) & 1;
+        bits += ((uint32_t)(15 - 127) << 23) + 0xfff + odd;
+        h = bits >> 13;
+    }
+    return h | (sign >> 16);
+}
+
 /**
  * Parameters for PAD synthesis
  *
@@ -90,8 +147,14 @@ class PADnoteParameters:public Presets
         struct { //quality of the samples (how many samples, the length of them,etc.)
             unsigned char samplesize;
             unsigned char basenote, oct, smpoct;
+            unsigned char storage; //PADformat of the samples
         } Pquality;
 
+        //Lazy generation: instruments are loaded with preview samples and
+        //the full quality ones are computed for the played keys first (see
+        //NonRtObjStore in MiddleWare.cpp)
+        unsigned char Plazy;
+
         //frequency parameters
         //If the base frequency is fixed to 440 Hz
         unsigned char Pfixedfreq;
@@ -153,8 +216,12 @@ class PADnoteParameters:public Presets
         void applyparameters(void);
         //! Compute the #sample array from the other parameters.
         //! For the function's parameters, see sampleGenerator()
+        //! @param lazy if set and Plazy is enabled, only preview samples are
+        //!             computed; the caller is to fill in the full ones
         void applyparameters(std::function<bool()> do_abort,
-                             unsigned max_threads = 0);
+                             unsigned max_threads = 0,
+                             PADpool *pool = NULL,
+                             bool lazy = false);
         void export2wav(std::string basefilename);
 
         OscilGen  *oscilgen;
@@ -163,9 +230,33 @@ class PADnoteParameters:public Presets
         struct Sample {
             int    size;
             float  basefreq;
+            //size + 5 values (the last ones repeat the first ones for the
+            //interpolation) in the given PADformat. 16 bit values are
+            //packed two to a float (see storage())
             float *smp;
+            int    format;
+            //Inputs the sample was computed from (see sampleGenerator());
+            //never touched by the realtime thread
+            uint64_t key;
+
+            //Decoded value at position i
+            float value(int i) const
+            {
+                if(format == PAD_HALF)
+                    return half2float(((const uint16_t *)smp)[i]);
+                if(format == PAD_INT16)
+                    return ((const int16_t *)smp)[i]
+                           * (PAD_INT16_RANGE / 32767.0f);
+                return smp[i];
+            }
         };
 
+        //Number of floats which hold n values in the given format
+        static int storage(int n, int format)
+        {
+            return format == PAD_FLOAT ? n : (n + 1) / 2;
+        }
+
         //! RT sample data
         Sample sample[PAD_MAX_SAMPLES];
 
@@ -182,13 +273,48 @@ class PADnoteParameters:public Presets
         //!                 user)
         //! @param max_threads Maximum number of threads for computation, or
         //!                    zero if no maximum shall be set
+        //! @param pool Threads to compute the samples with; if NULL, threads
+        //!             are spawned for this call only
+        //! @param current Keys of the samples the caller holds; samples with
+        //!                an unchanged key are skipped (cb is not called)
+        //! @param mask Samples to compute (bit n for sample n). A complete
+        //!             set found in the disk cache is passed on as a whole
         int sampleGenerator(PADnoteParameters::callback cb,
                             std::function<bool()> do_abort,
-                            unsigned max_threads = 0);
+                            unsigned max_threads = 0,
+                            PADpool *pool = NULL,
+                            const uint64_t *current = NULL,
+                            uint64_t mask = ~(uint64_t)0);
+
+        //! Same samples as sampleGenerator(), but only PREVIEW_SIZE long, so
+        //! that they can be heard until the full ones are done.
+        //! The result is not cached
+        int previewGenerator(PADnoteParameters::callback cb,
+                             std::function<bool()> do_abort,
+                             PADpool *pool = NULL,
+                             const uint64_t *current = NULL);
+
+        //! Length of the samples of previewGenerator()
+        static const int PREVIEW_SIZE = 1 << 14;
+        //! Length of the samples of sampleGenerator()
+        int samplesize(void) const
+        {
+            return ((int) 1) << (Pquality.samplesize + 14);
+        }
+        //! Base frequency of each sample; returns the number of samples
+        int samplefreqs(float *basefreqs) const;
+
+        //! Keys (as MIDI notes) which notes were played at, one bit each.
+        //! Set by the realtime thread when Plazy is enabled
+        mutable std::atomic<uint64_t> playedkeys[2];
+        void markplayed(float freq) const REALTIME;
 
         const AbsTime *time;
         int64_t last_update_timestamp;
 
+        //Size of the arena the notes are built in (see SynthNote::create())
+        mutable NoteLayout layout;
+
         static const rtosc::MergePorts ports;
         static const rtosc::Ports     &non_realtime_ports;
         static const rtosc::Ports     &realtime_ports;
@@ -206,6 +332,24 @@ class PADnoteParameters:public Presets
         void deletesamples();
         void deletesample(int n);
 
+        int generator(PADnoteParameters::callback cb,
+                      std::function<bool()> do_abort,
+                      unsigned max_threads,
+                      PADpool *pool,
+                      const uint64_t *current,
+                      uint64_t mask,
+                      int samplesize,
+                      bool cacheable);
+        uint64_t spectrumKey(float basefreq,
+                             const float *profile,
+                             int profilesize,
+                             float bwadjust) const;
+
+        //Stores the parameters the samples depend upon
+        void sample2XML(XMLwrapper& xml);
+        //Hash of the parameters the samples depend upon
+        uint64_t sampleKey(void);
+
     public:
         const SYNTH_T &synth;
 };
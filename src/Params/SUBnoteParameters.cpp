@@ -105,6 +105,9 @@ static const rtosc::Ports SUBnotePorts = {
     rOption(Pstart, rShort("initial"), rOptions(zero, random, ones),
             rDefault(random),
             "How harmonics are initialized"),
+    rParamI(Pctlrate, rShort("ctl rate"), rMap(min, 1), rMap(max, 16),
+            rDefault(1),
+            "Buffers between updates of the filter coefficients"),
 
     {"clear:", rDoc("Reset all harmonics to equal bandwidth/zero amplitude"), NULL,
         rBegin;
@@ -284,6 +287,7 @@ void SUBnoteParameters::defaults()
     Pbwscale     = 64;
     Pstereo      = 1;
     Pstart = 1;
+    Pctlrate     = 1;
 
     PDetune = 8192;
     PCoarseDetune = 0;
@@ -333,6 +337,7 @@ void SUBnoteParameters::add2XML(XMLwrapper& xml)
     xml.addpar("num_stages", Pnumstages);
     xml.addpar("harmonic_mag_type", Phmagtype);
     xml.addpar("start", Pstart);
+    xml.addpar("ctl_rate", Pctlrate);
 
     xml.beginbranch("HARMONICS");
     for(int i = 0; i < MAX_SUB_HARMONICS; ++i) {
@@ -517,6 +522,7 @@ void SUBnoteParameters::paste(SUBnoteParameters &sub)
 
     doPaste(Pbwscale);
     doPaste(Pstart);
+    doPaste(Pctlrate);
 
     if ( time ) {
         last_update_timestamp = time->time();
@@ -528,6 +534,7 @@ void SUBnoteParameters::getfromXML(XMLwrapper& xml)
     Pnumstages = xml.getpar127("num_stages", Pnumstages);
     Phmagtype  = xml.getpar127("harmonic_mag_type", Phmagtype);
     Pstart     = xml.getpar127("start", Pstart);
+    Pctlrate   = xml.getpar("ctl_rate", Pctlrate, 1, 16);
 
     if(xml.enterbranch("HARMONICS")) {
         Phmag[0] = 0;
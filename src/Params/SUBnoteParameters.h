@@ -16,6 +16,7 @@
 
 #include <stdint.h>
 #include "../globals.h"
+#include "../Misc/Allocator.h"
 #include "Presets.h"
 
 namespace zyn {
@@ -108,9 +109,16 @@ class SUBnoteParameters:public Presets
         //how the harmonics start("0"=0,"1"=random,"2"=1)
         unsigned char Pstart;
 
+        //buffers between updates of the filter coefficients; above 1 they
+        //are interpolated in between
+        unsigned char Pctlrate;
+
         const AbsTime *time;
         int64_t last_update_timestamp;
 
+        //Size of the arena the notes are built in (see SynthNote::create())
+        mutable NoteLayout layout;
+
         static const rtosc::Ports &ports;
 };
 
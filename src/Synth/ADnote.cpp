@@ -15,20 +15,28 @@
 #include <cstdlib>
 #include <cstdio>
 #include <cstring>
+#include <algorithm>
 #include <cassert>
 #include <stdint.h>
+#include <mutex>
 
 #include "../globals.h"
 #include "../Misc/Util.h"
 #include "../Misc/Allocator.h"
+#include "../Misc/SpinLock.h"
 #include "../Params/ADnoteParameters.h"
 #include "../Containers/ScratchString.h"
 #include "ModFilter.h"
 #include "OscilGen.h"
+#include "OscilKernels.h"
 #include "ADnote.h"
 
 namespace zyn {
 
+//Notes of the same part may be rendered on different threads while sharing
+//their OscilGen, so late oscillator (re)generation has to take turns
+static SpinLock oscilLock;
+
 ADnote::ADnote(ADnoteParameters *pars_, SynthParams &spars,
         WatchManager *wm, const char *prefix)
     :SynthNote(spars), pars(*pars_)
@@ -53,7 +61,7 @@ ADnote::ADnote(ADnoteParameters *pars_, SynthParams &spars,
     bandwidthDetuneMultiplier = pars.getBandwidthDetuneMultiplier();
 
     if(pars.GlobalPar.PPanning == 0)
-        NoteGlobalPar.Panning = RND;
+        NoteGlobalPar.Panning = rng.rnd();
     else
         NoteGlobalPar.Panning = pars.GlobalPar.PPanning / 128.0f;
 
@@ -77,6 +85,7 @@ ADnote::ADnote(ADnoteParameters *pars_, SynthParams &spars,
     else
         NoteGlobalPar.Punch.Enabled = 0;
 
+    voicerelbw = ctl.bandwidth.relbw;
     for(int nvoice = 0; nvoice < NUM_VOICES; ++nvoice)
         setupVoice(nvoice);
 
@@ -102,13 +111,15 @@ void ADnote::setupVoice(int nvoice)
     auto &voice = NoteVoicePar[nvoice];
 
 
-    for (int i = 0; i < 14; i++)
-        pinking[nvoice][i] = 0.0;
+    for (int i = 0; i < PINK_STATE; i++)
+        pinking[nvoice][0][i] = pinking[nvoice][1][i] = 0.0;
 
-    param.OscilSmp->newrandseed(prng());
-    voice.OscilSmp = NULL;
-    voice.FMSmp    = NULL;
-    voice.VoiceOut = NULL;
+    param.OscilSmp->newrandseed(rng.next());
+    voice.OscilSmp    = NULL;
+    voice.OscilShared = NULL;
+    voice.FMSmp       = NULL;
+    voice.FMShared    = NULL;
+    voice.VoiceOut    = NULL;
 
     voice.FMVoice = -1;
     unison_size[nvoice] = 1;
@@ -155,20 +166,16 @@ void ADnote::setupVoice(int nvoice)
         oscposloFM[nvoice][k] = 0.0f;
     }
 
-    //the extra points contains the first point
-    voice.OscilSmp =
-        memory.valloc<float>(synth.oscilsize + OSCIL_SMP_EXTRA_SAMPLES);
-
     //Get the voice's oscil or external's voice oscil
     int vc = nvoice;
     if(pars.VoicePar[nvoice].Pextoscil != -1)
         vc = pars.VoicePar[nvoice].Pextoscil;
     if(!pars.GlobalPar.Hrandgrouping)
-        pars.VoicePar[vc].OscilSmp->newrandseed(prng());
+        pars.VoicePar[vc].OscilSmp->newrandseed(rng.next());
     int oscposhi_start =
-        pars.VoicePar[vc].OscilSmp->get(NoteVoicePar[nvoice].OscilSmp,
-                getvoicebasefreq(nvoice),
-                pars.VoicePar[nvoice].Presonance);
+        loadOscil(*pars.VoicePar[vc].OscilSmp, voice.OscilSmp,
+                  voice.OscilShared, getvoicebasefreq(nvoice),
+                  pars.VoicePar[nvoice].Presonance);
 
     // This code was planned for biasing the carrier in MOD_RING
     // but that's on hold for the moment.  Disabled 'cos small
@@ -186,10 +193,6 @@ void ADnote::setupVoice(int nvoice)
     // NoteVoicePar[nvoice].OscilSmpMin = min;
     // NoteVoicePar[nvoice].OscilSmpMax = max;
 
-    //I store the first elments to the last position for speedups
-    for(int i = 0; i < OSCIL_SMP_EXTRA_SAMPLES; ++i)
-        voice.OscilSmp[synth.oscilsize + i] = voice.OscilSmp[i];
-
     voice.phase_offset = (int)((pars.VoicePar[nvoice].Poscilphase
                     - 64.0f) / 128.0f * synth.oscilsize + synth.oscilsize * 4);
     oscposhi_start += NoteVoicePar[nvoice].phase_offset;
@@ -199,7 +202,7 @@ void ADnote::setupVoice(int nvoice)
         oscposhi[nvoice][k] = kth_start % synth.oscilsize;
         //put random starting point for other subvoices
         kth_start      = oscposhi_start +
-            (int)(RND * pars.VoicePar[nvoice].Unison_phase_randomness /
+            (int)(rng.rnd() * pars.VoicePar[nvoice].Unison_phase_randomness /
                     127.0f * (synth.oscilsize - 1));
     }
 
@@ -216,6 +219,7 @@ void ADnote::setupVoice(int nvoice)
     voice.filterbypass = param.Pfilterbypass;
 
     setupVoiceMod(nvoice);
+    voicestamp[nvoice] = pars.getVoiceUpdateTimestamp(nvoice);
 
     voice.FMVoice = param.PFMVoice;
     voice.FMFreqEnvelope = NULL;
@@ -231,6 +235,39 @@ void ADnote::setupVoice(int nvoice)
                     - 1.0f) / synth.buffersize_f / 10.0f * synth.samplerate_f);
 }
 
+int ADnote::loadOscil(OscilGen &osc, float *&smps, OscilBuffer *&shared,
+                      float freq, int resonance)
+{
+    //The shared waves stay cached by osc after this note is gone, so they
+    //are taken from the part's allocator rather than the note's arena
+    short start;
+    OscilBuffer *buf = osc.getshared(freq, resonance, rng, parentMemory(),
+                                     OSCIL_SMP_EXTRA_SAMPLES, start);
+
+    //Drop the previous wave (legato)
+    if(shared) {
+        shared->unref();
+        smps = NULL;
+    }
+    shared = buf;
+
+    if(buf) {
+        memory.devalloc(smps);
+        smps = buf->smps();
+        return start;
+    }
+
+    //the extra points contains the first point
+    if(!smps)
+        smps = memory.valloc<float>(synth.oscilsize + OSCIL_SMP_EXTRA_SAMPLES);
+    start = osc.get(smps, freq, resonance, rng);
+
+    //I store the first elments to the last position for speedups
+    for(int i = 0; i < OSCIL_SMP_EXTRA_SAMPLES; ++i)
+        smps[synth.oscilsize + i] = smps[i];
+    return start;
+}
+
 int ADnote::setupVoiceUnison(int nvoice)
 {
     int unison = pars.VoicePar[nvoice].Unison_size;
@@ -275,10 +312,12 @@ int ADnote::setupVoiceUnison(int nvoice)
                 break;
         default: { //unison for more than 2 subvoices
                      float unison_values[true_unison];
+                     float noise[true_unison];
                      float min = -1e-6, max = 1e-6;
+                     rng.white(noise, true_unison);
                      for(int k = 0; k < true_unison; ++k) {
                          float step = (k / (float) (true_unison - 1)) * 2.0f - 1.0f; //this makes the unison spread more uniform
-                         float val  = step + (RND * 2.0f - 1.0f) / (true_unison - 1);
+                         float val  = step + noise[k] / (true_unison - 1);
                          unison_values[k] = val;
                          if (min > val) {
                              min = val;
@@ -319,13 +358,16 @@ int ADnote::setupVoiceUnison(int nvoice)
     const float increments_per_second = synth.samplerate_f / synth.buffersize_f;
     const float vib_speed = pars.VoicePar[nvoice].Unison_vibratto_speed / 127.0f;
     const float vibratto_base_period  = 0.25f * powf(2.0f, (1.0f - vib_speed) * 4.0f);
+    //position, period and direction of each subvoice
+    float noise[3 * unison];
+    rng.fill(noise, 3 * unison);
     for(int k = 0; k < unison; ++k) {
-        unison_vibratto[nvoice].position[k] = RND * 1.8f - 0.9f;
+        unison_vibratto[nvoice].position[k] = noise[3 * k] * 1.8f - 0.9f;
         //make period to vary randomly from 50% to 200% vibratto base period
         const float vibratto_period = vibratto_base_period
-            * powf(2.0f, RND * 2.0f - 1.0f);
+            * powf(2.0f, noise[3 * k + 1] * 2.0f - 1.0f);
 
-        const float m = (RND < 0.5f ? -1.0f : 1.0f) *
+        const float m = (noise[3 * k + 2] < 0.5f ? -1.0f : 1.0f) *
             4.0f / (vibratto_period * increments_per_second);
         unison_vibratto[nvoice].step[k] = m;
 
@@ -362,7 +404,7 @@ int ADnote::setupVoiceUnison(int nvoice)
                 break;
             case 1:
                 for(int k = 0; k < unison; ++k)
-                    unison_invert_phase[nvoice][k] = (RND > 0.5f);
+                    unison_invert_phase[nvoice][k] = (rng.rnd() > 0.5f);
                 break;
             default:
                 for(int k = 0; k < unison; ++k)
@@ -444,9 +486,8 @@ void ADnote::setupVoiceMod(int nvoice, bool first_run)
 
     //Triggers when a user enables modulation on a running voice
     if(!first_run && voice.FMEnabled != NONE && voice.FMSmp == NULL && voice.FMVoice < 0) {
-        param.FMSmp->newrandseed(prng());
-        voice.FMSmp = memory.valloc<float>(synth.oscilsize + OSCIL_SMP_EXTRA_SAMPLES);
-        memset(voice.FMSmp, 0, sizeof(float)*(synth.oscilsize + OSCIL_SMP_EXTRA_SAMPLES));
+        std::lock_guard<SpinLock> guard(oscilLock);
+        param.FMSmp->newrandseed(rng.next());
         int vc = nvoice;
         if(param.PextFMoscil != -1)
             vc = param.PextFMoscil;
@@ -458,16 +499,13 @@ void ADnote::setupVoiceMod(int nvoice, bool first_run)
             tmp = getFMvoicebasefreq(nvoice);
 
         if(!pars.GlobalPar.Hrandgrouping)
-            pars.VoicePar[vc].FMSmp->newrandseed(prng());
+            pars.VoicePar[vc].FMSmp->newrandseed(rng.next());
 
         for(int k = 0; k < unison_size[nvoice]; ++k)
             oscposhiFM[nvoice][k] = (oscposhi[nvoice][k]
-                    + pars.VoicePar[vc].FMSmp->get(
-                        voice.FMSmp, tmp))
+                    + loadOscil(*pars.VoicePar[vc].FMSmp, voice.FMSmp,
+                                voice.FMShared, tmp, 0))
                 % synth.oscilsize;
-
-        for(int i = 0; i < OSCIL_SMP_EXTRA_SAMPLES; ++i)
-            voice.FMSmp[synth.oscilsize + i] = voice.FMSmp[i];
         int oscposhiFM_add =
             (int)((param.PFMoscilphase
                         - 64.0f) / 128.0f * synth.oscilsize
@@ -508,9 +546,9 @@ void ADnote::setupVoiceMod(int nvoice, bool first_run)
 
 SynthNote *ADnote::cloneLegato(void)
 {
-    SynthParams sp{memory, ctl, synth, time, legato.param.freq, velocity,
-                   (bool)portamento, legato.param.midinote, true};
-    return memory.alloc<ADnote>(&pars, sp);
+    SynthParams sp{parentMemory(), ctl, synth, time, legato.param.freq, velocity,
+                   (bool)portamento, legato.param.midinote, true, &rng};
+    return create<ADnote>(&pars, sp);
 }
 
 // ADlegatonote: This function is (mostly) a copy of ADnote(...) and
@@ -538,7 +576,7 @@ void ADnote::legatonote(LegatoParams lpars)
     bandwidthDetuneMultiplier = pars.getBandwidthDetuneMultiplier();
 
     if(pars.GlobalPar.PPanning == 0)
-        NoteGlobalPar.Panning = RND;
+        NoteGlobalPar.Panning = rng.rnd();
     else
         NoteGlobalPar.Panning = pars.GlobalPar.PPanning / 128.0f;
 
@@ -591,17 +629,11 @@ void ADnote::legatonote(LegatoParams lpars)
         if(pars.VoicePar[nvoice].Pextoscil != -1)
             vc = pars.VoicePar[nvoice].Pextoscil;
         if(!pars.GlobalPar.Hrandgrouping)
-            pars.VoicePar[vc].OscilSmp->newrandseed(prng());
+            pars.VoicePar[vc].OscilSmp->newrandseed(rng.next());
 
-        pars.VoicePar[vc].OscilSmp->get(NoteVoicePar[nvoice].OscilSmp,
-                                         getvoicebasefreq(nvoice),
-                                         pars.VoicePar[nvoice].Presonance); //(gf)Modif of the above line.
-
-        //I store the first elments to the last position for speedups
-        for(int i = 0; i < OSCIL_SMP_EXTRA_SAMPLES; ++i)
-            NoteVoicePar[nvoice].OscilSmp[synth.oscilsize
-                                          + i] =
-                NoteVoicePar[nvoice].OscilSmp[i];
+        loadOscil(*pars.VoicePar[vc].OscilSmp, NoteVoicePar[nvoice].OscilSmp,
+                  NoteVoicePar[nvoice].OscilShared, getvoicebasefreq(nvoice),
+                  pars.VoicePar[nvoice].Presonance); //(gf)Modif of the above line.
 
         auto &voiceFilter = NoteVoicePar[nvoice].Filter;
         if(voiceFilter) {
@@ -704,7 +736,7 @@ void ADnote::legatonote(LegatoParams lpars)
             NoteVoicePar[nvoice].Volume = -NoteVoicePar[nvoice].Volume;
 
         if(pars.VoicePar[nvoice].PPanning == 0)
-            NoteVoicePar[nvoice].Panning = RND;  // random panning
+            NoteVoicePar[nvoice].Panning = rng.rnd();  // random panning
         else
             NoteVoicePar[nvoice].Panning =
                 pars.VoicePar[nvoice].PPanning / 128.0f;
@@ -728,7 +760,7 @@ void ADnote::legatonote(LegatoParams lpars)
         /* Voice Modulation Parameters Init */
         if((NoteVoicePar[nvoice].FMEnabled != NONE)
            && (NoteVoicePar[nvoice].FMVoice < 0)) {
-            pars.VoicePar[nvoice].FMSmp->newrandseed(prng());
+            pars.VoicePar[nvoice].FMSmp->newrandseed(rng.next());
 
             //Perform Anti-aliasing only on MIX or RING MODULATION
 
@@ -737,11 +769,12 @@ void ADnote::legatonote(LegatoParams lpars)
                 vc = pars.VoicePar[nvoice].PextFMoscil;
 
             if(!pars.GlobalPar.Hrandgrouping)
-                pars.VoicePar[vc].FMSmp->newrandseed(prng());
+                pars.VoicePar[vc].FMSmp->newrandseed(rng.next());
 
-            for(int i = 0; i < OSCIL_SMP_EXTRA_SAMPLES; ++i)
-                NoteVoicePar[nvoice].FMSmp[synth.oscilsize + i] =
-                    NoteVoicePar[nvoice].FMSmp[i];
+            if(!NoteVoicePar[nvoice].FMShared)
+                for(int i = 0; i < OSCIL_SMP_EXTRA_SAMPLES; ++i)
+                    NoteVoicePar[nvoice].FMSmp[synth.oscilsize + i] =
+                        NoteVoicePar[nvoice].FMSmp[i];
         }
 
         FMnewamplitude[nvoice] = NoteVoicePar[nvoice].FMVolume
@@ -832,7 +865,7 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
     NoteGlobalPar.initparameters(pars.GlobalPar, synth,
                                  time,
                                  memory, basefreq, velocity,
-                                 stereo, wm, prefix);
+                                 stereo, wm, prefix, &rng);
 
     NoteGlobalPar.AmpEnvelope->envout_dB(); //discard the first envelope output
     globalnewamplitude = NoteGlobalPar.Volume
@@ -863,7 +896,7 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
             vce.Volume = -vce.Volume;
 
         if(param.PPanning == 0)
-            vce.Panning = RND;  // random panning
+            vce.Panning = rng.rnd();  // random panning
         else
             vce.Panning = param.PPanning / 128.0f;
 
@@ -878,7 +911,7 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
 
         if(param.PAmpLfoEnabled) {
             vce.AmpLfo = memory.alloc<LFO>(*param.AmpLfo, basefreq, time, wm,
-                    (pre+"VoicePar"+nvoice+"/AmpLfo/").c_str);
+                    (pre+"VoicePar"+nvoice+"/AmpLfo/").c_str, &rng);
             newamplitude[nvoice] *= vce.AmpLfo->amplfoout();
         }
 
@@ -890,7 +923,7 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
 
         if(param.PFreqLfoEnabled)
             vce.FreqLfo = memory.alloc<LFO>(*param.FreqLfo, basefreq, time, wm,
-                    (pre+"VoicePar"+nvoice+"/FreqLfo/").c_str);
+                    (pre+"VoicePar"+nvoice+"/FreqLfo/").c_str, &rng);
 
         /* Voice Filter Parameters Init */
         if(param.PFilterEnabled) {
@@ -910,15 +943,14 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
 
             if(param.PFilterLfoEnabled) {
                 vce.FilterLfo = memory.alloc<LFO>(*param.FilterLfo, basefreq, time, wm,
-                        (pre+"VoicePar"+nvoice+"/FilterLfo/").c_str);
+                        (pre+"VoicePar"+nvoice+"/FilterLfo/").c_str, &rng);
                 vce.Filter->addMod(*vce.FilterLfo);
             }
         }
 
         /* Voice Modulation Parameters Init */
         if((vce.FMEnabled != NONE) && (vce.FMVoice < 0)) {
-            param.FMSmp->newrandseed(prng());
-            vce.FMSmp = memory.valloc<float>(synth.oscilsize + OSCIL_SMP_EXTRA_SAMPLES);
+            param.FMSmp->newrandseed(rng.next());
 
             //Perform Anti-aliasing only on MIX or RING MODULATION
 
@@ -933,16 +965,13 @@ void ADnote::initparameters(WatchManager *wm, const char *prefix)
                 tmp = getFMvoicebasefreq(nvoice);
 
             if(!pars.GlobalPar.Hrandgrouping)
-                pars.VoicePar[vc].FMSmp->newrandseed(prng());
+                pars.VoicePar[vc].FMSmp->newrandseed(rng.next());
 
             for(int k = 0; k < unison_size[nvoice]; ++k)
                 oscposhiFM[nvoice][k] = (oscposhi[nvoice][k]
-                                         + pars.VoicePar[vc].FMSmp->get(
-                                             vce.FMSmp, tmp))
+                                         + loadOscil(*pars.VoicePar[vc].FMSmp,
+                                             vce.FMSmp, vce.FMShared, tmp, 0))
                                         % synth.oscilsize;
-
-            for(int i = 0; i < OSCIL_SMP_EXTRA_SAMPLES; ++i)
-                vce.FMSmp[synth.oscilsize + i] = vce.FMSmp[i];
             int oscposhiFM_add =
                 (int)((param.PFMoscilphase
                        - 64.0f) / 128.0f * synth.oscilsize
@@ -1243,23 +1272,24 @@ inline void ADnote::fadein(float *smps) const
  */
 inline void ADnote::ComputeVoiceOscillator_LinearInterpolation(int nvoice)
 {
-    for(int k = 0; k < unison_size[nvoice]; ++k) {
-        int    poshi  = oscposhi[nvoice][k];
-        int    poslo  = oscposlo[nvoice][k] * (1<<24);
-        int    freqhi = oscfreqhi[nvoice][k];
-        int    freqlo = oscfreqlo[nvoice][k] * (1<<24);
-        float *smps   = NoteVoicePar[nvoice].OscilSmp;
-        float *tw     = tmpwave_unison[k];
-        assert(oscfreqlo[nvoice][k] < 1.0f);
-        for(int i = 0; i < synth.buffersize; ++i) {
-            tw[i]  = (smps[poshi] * ((1<<24) - poslo) + smps[poshi + 1] * poslo)/(1.0f*(1<<24));
-            poslo += freqlo;
-            poshi += freqhi + (poslo>>24);
-            poslo &= 0xffffff;
-            poshi &= synth.oscilsize - 1;
+    //Unison voices are computed OSCIL_LANES at a time (see OscilKernels.h)
+    UnisonPhase ph;
+    for(int k0 = 0; k0 < unison_size[nvoice]; k0 += OSCIL_LANES) {
+        const int lanes = std::min(unison_size[nvoice] - k0, OSCIL_LANES);
+        for(int l = 0; l < lanes; ++l) {
+            const int k = k0 + l;
+            assert(oscfreqlo[nvoice][k] < 1.0f);
+            ph.hi[l]     = oscposhi[nvoice][k];
+            ph.lo[l]     = oscposlo[nvoice][k] * (1<<24);
+            ph.freqhi[l] = oscfreqhi[nvoice][k];
+            ph.freqlo[l] = oscfreqlo[nvoice][k] * (1<<24);
+        }
+        oscilLinear(NoteVoicePar[nvoice].OscilSmp, synth.oscilsize - 1, ph,
+                    lanes, &tmpwave_unison[k0], synth.buffersize);
+        for(int l = 0; l < lanes; ++l) {
+            oscposhi[nvoice][k0 + l] = ph.hi[l];
+            oscposlo[nvoice][k0 + l] = ph.lo[l]/(1.0f*(1<<24));
         }
-        oscposhi[nvoice][k] = poshi;
-        oscposlo[nvoice][k] = poslo/(1.0f*(1<<24));
     }
 }
 
@@ -1327,32 +1357,32 @@ inline void ADnote::ComputeVoiceOscillatorMix(int nvoice)
         }
     }
     else
-        for(int k = 0; k < unison_size[nvoice]; ++k) {
-            int    poshiFM  = oscposhiFM[nvoice][k];
-            float  posloFM  = oscposloFM[nvoice][k];
-            int    freqhiFM = oscfreqhiFM[nvoice][k];
-            float  freqloFM = oscfreqloFM[nvoice][k];
-            float *tw = tmpwave_unison[k];
+        ComputeVoiceModulator(nvoice, false);
+}
 
-            for(int i = 0; i < synth.buffersize; ++i) {
-                float amp = INTERPOLATE_AMPLITUDE(FMoldamplitude[nvoice],
-                                            FMnewamplitude[nvoice],
-                                            i,
-                                            synth.buffersize);
-                tw[i] = tw[i] * (1.0f - amp) + amp
-                        * (NoteVoicePar[nvoice].FMSmp[poshiFM] * (1 - posloFM)
-                           + NoteVoicePar[nvoice].FMSmp[poshiFM + 1] * posloFM);
-                posloFM += freqloFM;
-                if(posloFM >= 1.0f) {
-                    posloFM -= 1.0f;
-                    poshiFM++;
-                }
-                poshiFM += freqhiFM;
-                poshiFM &= synth.oscilsize - 1;
-            }
-            oscposhiFM[nvoice][k] = poshiFM;
-            oscposloFM[nvoice][k] = posloFM;
+/*
+ * Mixes or ring modulates the unison voices with the voice's own modulator
+ * oscillator (see modulatorMix())
+ */
+inline void ADnote::ComputeVoiceModulator(int nvoice, bool ring)
+{
+    ModulatorPhase ph;
+    for(int k0 = 0; k0 < unison_size[nvoice]; k0 += OSCIL_LANES) {
+        const int lanes = std::min(unison_size[nvoice] - k0, OSCIL_LANES);
+        for(int l = 0; l < lanes; ++l) {
+            ph.hi[l]     = oscposhiFM[nvoice][k0 + l];
+            ph.lo[l]     = oscposloFM[nvoice][k0 + l];
+            ph.freqhi[l] = oscfreqhiFM[nvoice][k0 + l];
+            ph.freqlo[l] = oscfreqloFM[nvoice][k0 + l];
+        }
+        modulatorMix(NoteVoicePar[nvoice].FMSmp, synth.oscilsize - 1, ph,
+                     lanes, &tmpwave_unison[k0], synth.buffersize,
+                     FMoldamplitude[nvoice], FMnewamplitude[nvoice], ring);
+        for(int l = 0; l < lanes; ++l) {
+            oscposhiFM[nvoice][k0 + l] = ph.hi[l];
+            oscposloFM[nvoice][k0 + l] = ph.lo[l];
         }
+    }
 }
 
 /*
@@ -1379,33 +1409,7 @@ inline void ADnote::ComputeVoiceOscillatorRingModulation(int nvoice)
             }
         }
     else
-        for(int k = 0; k < unison_size[nvoice]; ++k) {
-            int    poshiFM  = oscposhiFM[nvoice][k];
-            float  posloFM  = oscposloFM[nvoice][k];
-            int    freqhiFM = oscfreqhiFM[nvoice][k];
-            float  freqloFM = oscfreqloFM[nvoice][k];
-            float *tw = tmpwave_unison[k];
-
-            for(int i = 0; i < synth.buffersize; ++i) {
-                float amp = INTERPOLATE_AMPLITUDE(FMoldamplitude[nvoice],
-                                            FMnewamplitude[nvoice],
-                                            i,
-                                            synth.buffersize);
-                tw[i] *= (NoteVoicePar[nvoice].FMSmp[poshiFM] * (1.0f - posloFM)
-                          + NoteVoicePar[nvoice].FMSmp[poshiFM
-                                                       + 1] * posloFM) * amp
-                         + (1.0f - amp);
-                posloFM += freqloFM;
-                if(posloFM >= 1.0f) {
-                    posloFM -= 1.0f;
-                    poshiFM++;
-                }
-                poshiFM += freqhiFM;
-                poshiFM &= synth.oscilsize - 1;
-            }
-            oscposhiFM[nvoice][k] = poshiFM;
-            oscposloFM[nvoice][k] = posloFM;
-        }
+        ComputeVoiceModulator(nvoice, true);
 }
 
 /*
@@ -1427,31 +1431,29 @@ inline void ADnote::ComputeVoiceOscillatorFrequencyModulation(int nvoice,
         }
     } else {
         //Compute the modulator and store it in tmpwave_unison[][]
-        for(int k = 0; k < unison_size[nvoice]; ++k) {
-            int    poshiFM  = oscposhiFM[nvoice][k];
-            int    posloFM  = oscposloFM[nvoice][k]  * (1<<24);
-            int    freqhiFM = oscfreqhiFM[nvoice][k];
-            int    freqloFM = oscfreqloFM[nvoice][k] * (1<<24);
-            float *tw = tmpwave_unison[k];
-            const float *smps = NoteVoicePar[nvoice].FMSmp;
-
-            for(int i = 0; i < synth.buffersize; ++i) {
-                tw[i] = (smps[poshiFM] * ((1<<24) - posloFM)
-                         + smps[poshiFM + 1] * posloFM) / (1.0f*(1<<24));
-                if (FMmode == PW_MOD && (k & 1))
-                    tw[i] = -tw[i];
-
-                posloFM += freqloFM;
-                if(posloFM >= (1<<24)) {
-                    posloFM &= 0xffffff;//fmod(posloFM, 1.0f);
-                    poshiFM++;
-                }
-                poshiFM += freqhiFM;
-                poshiFM &= synth.oscilsize - 1;
+        UnisonPhase ph;
+        for(int k0 = 0; k0 < unison_size[nvoice]; k0 += OSCIL_LANES) {
+            const int lanes = std::min(unison_size[nvoice] - k0, OSCIL_LANES);
+            for(int l = 0; l < lanes; ++l) {
+                const int k = k0 + l;
+                ph.hi[l]     = oscposhiFM[nvoice][k];
+                ph.lo[l]     = oscposloFM[nvoice][k]  * (1<<24);
+                ph.freqhi[l] = oscfreqhiFM[nvoice][k];
+                ph.freqlo[l] = oscfreqloFM[nvoice][k] * (1<<24);
+            }
+            oscilLinear(NoteVoicePar[nvoice].FMSmp, synth.oscilsize - 1, ph,
+                        lanes, &tmpwave_unison[k0], synth.buffersize);
+            for(int l = 0; l < lanes; ++l) {
+                oscposhiFM[nvoice][k0 + l] = ph.hi[l];
+                oscposloFM[nvoice][k0 + l] = ph.lo[l]/((1<<24)*1.0f);
             }
-            oscposhiFM[nvoice][k] = poshiFM;
-            oscposloFM[nvoice][k] = posloFM/((1<<24)*1.0f);
         }
+        if(FMmode == PW_MOD)
+            for(int k = 1; k < unison_size[nvoice]; k += 2) {
+                float *tw = tmpwave_unison[k];
+                for(int i = 0; i < synth.buffersize; ++i)
+                    tw[i] = -tw[i];
+            }
     }
     // Amplitude interpolation
     if(ABOVE_AMPLITUDE_THRESHOLD(FMoldamplitude[nvoice],
@@ -1477,15 +1479,9 @@ inline void ADnote::ComputeVoiceOscillatorFrequencyModulation(int nvoice,
     if(FMmode == FREQ_MOD) { //Frequency modulation
         const float normalize = synth.oscilsize_f / 262144.0f * 44100.0f
                           / synth.samplerate_f;
-        for(int k = 0; k < unison_size[nvoice]; ++k) {
-            float *tw    = tmpwave_unison[k];
-            float  fmold = FMoldsmp[nvoice][k];
-            for(int i = 0; i < synth.buffersize; ++i) {
-                fmold = fmod(fmold + tw[i] * normalize, synth.oscilsize);
-                tw[i] = fmold;
-            }
-            FMoldsmp[nvoice][k] = fmold;
-        }
+        for(int k = 0; k < unison_size[nvoice]; ++k)
+            fmIntegrate(tmpwave_unison[k], FMoldsmp[nvoice][k], normalize,
+                        synth.oscilsize, synth.buffersize);
     }
     else {  //Phase or PWM modulation
         const float normalize = synth.oscilsize_f / 262144.0f;
@@ -1497,47 +1493,25 @@ inline void ADnote::ComputeVoiceOscillatorFrequencyModulation(int nvoice,
     }
 
     //do the modulation
-    for(int k = 0; k < unison_size[nvoice]; ++k) {
-        float *smps   = NoteVoicePar[nvoice].OscilSmp;
-        float *tw     = tmpwave_unison[k];
-        int    poshi  = oscposhi[nvoice][k];
-        int    poslo  = oscposlo[nvoice][k] * (1<<24);
-        int    freqhi = oscfreqhi[nvoice][k];
-        int    freqlo = oscfreqlo[nvoice][k] * (1<<24);
-
-        for(int i = 0; i < synth.buffersize; ++i) {
-            int FMmodfreqhi = 0;
-            F2I(tw[i], FMmodfreqhi);
-            float FMmodfreqlo = tw[i]-FMmodfreqhi;//fmod(tw[i] /*+ 0.0000000001f*/, 1.0f);
-            if(FMmodfreqhi < 0)
-                FMmodfreqlo++;
-
-            //carrier
-            int carposhi = poshi + FMmodfreqhi;
-            int carposlo = poslo + FMmodfreqlo;
-            if (FMmode == PW_MOD && (k & 1))
-                carposhi += NoteVoicePar[nvoice].phase_offset;
-
-            if(carposlo >= (1<<24)) {
-                carposhi++;
-                carposlo &= 0xffffff;//fmod(carposlo, 1.0f);
-            }
-            carposhi &= (synth.oscilsize - 1);
-
-            tw[i] = (smps[carposhi] * ((1<<24) - carposlo)
-                    + smps[carposhi + 1] * carposlo)/(1.0f*(1<<24));
-
-            poslo += freqlo;
-            if(poslo >= (1<<24)) {
-                poslo &= 0xffffff;//fmod(poslo, 1.0f);
-                poshi++;
-            }
-
-            poshi += freqhi;
-            poshi &= synth.oscilsize - 1;
+    UnisonPhase ph;
+    int32_t     offset[OSCIL_LANES];
+    for(int k0 = 0; k0 < unison_size[nvoice]; k0 += OSCIL_LANES) {
+        const int lanes = std::min(unison_size[nvoice] - k0, OSCIL_LANES);
+        for(int l = 0; l < lanes; ++l) {
+            const int k = k0 + l;
+            ph.hi[l]     = oscposhi[nvoice][k];
+            ph.lo[l]     = oscposlo[nvoice][k] * (1<<24);
+            ph.freqhi[l] = oscfreqhi[nvoice][k];
+            ph.freqlo[l] = oscfreqlo[nvoice][k] * (1<<24);
+            offset[l]    = (FMmode == PW_MOD && (k & 1)) ?
+                           NoteVoicePar[nvoice].phase_offset : 0;
+        }
+        oscilModulated(NoteVoicePar[nvoice].OscilSmp, synth.oscilsize - 1, ph,
+                       offset, lanes, &tmpwave_unison[k0], synth.buffersize);
+        for(int l = 0; l < lanes; ++l) {
+            oscposhi[nvoice][k0 + l] = ph.hi[l];
+            oscposlo[nvoice][k0 + l] = ph.lo[l]/((1<<24)*1.0f);
         }
-        oscposhi[nvoice][k] = poshi;
-        oscposlo[nvoice][k] = (poslo)/((1<<24)*1.0f);
     }
 }
 
@@ -1548,29 +1522,16 @@ inline void ADnote::ComputeVoiceOscillatorFrequencyModulation(int nvoice,
 inline void ADnote::ComputeVoiceWhiteNoise(int nvoice)
 {
     for(int k = 0; k < unison_size[nvoice]; ++k) {
-        float *tw = tmpwave_unison[k];
-        for(int i = 0; i < synth.buffersize; ++i)
-            tw[i] = RND * 2.0f - 1.0f;
+        rng.white(tmpwave_unison[k], synth.buffersize);
     }
 }
 
 inline void ADnote::ComputeVoicePinkNoise(int nvoice)
 {
-    for(int k = 0; k < unison_size[nvoice]; ++k) {
-        float *tw = tmpwave_unison[k];
-        float *f = &pinking[nvoice][k > 0 ? 7 : 0];
-        for(int i = 0; i < synth.buffersize; ++i) {
-            float white = (RND-0.5)/4.0;
-            f[0] = 0.99886*f[0]+white*0.0555179;
-            f[1] = 0.99332*f[1]+white*0.0750759;
-            f[2] = 0.96900*f[2]+white*0.1538520;
-            f[3] = 0.86650*f[3]+white*0.3104856;
-            f[4] = 0.55000*f[4]+white*0.5329522;
-            f[5] = -0.7616*f[5]-white*0.0168980;
-            tw[i] = f[0]+f[1]+f[2]+f[3]+f[4]+f[5]+f[6]+white*0.5362;
-            f[6] = white*0.115926;
-        }
-    }
+    //the subvoices past the first one share a filter
+    for(int k = 0; k < unison_size[nvoice]; ++k)
+        rng.pink(tmpwave_unison[k], synth.buffersize,
+                 pinking[nvoice][k > 0 ? 1 : 0]);
 }
 
 inline void ADnote::ComputeVoiceDC(int nvoice)
@@ -1600,10 +1561,18 @@ int ADnote::noteout(float *outl, float *outr)
     memset(bypassr, 0, synth.bufferbytes);
 
     //Update Changed Parameters From UI
+    //(the modulator volume also depends upon the bandwidth controller)
+    const bool relbwChanged = ctl.bandwidth.relbw != voicerelbw;
+    voicerelbw = ctl.bandwidth.relbw;
     for(unsigned nvoice = 0; nvoice < NUM_VOICES; ++nvoice) {
         if((NoteVoicePar[nvoice].Enabled != ON)
            || (NoteVoicePar[nvoice].DelayTicks > 0))
             continue;
+        const int64_t stamp = pars.getVoiceUpdateTimestamp(nvoice);
+        if(stamp != -1 && stamp == voicestamp[nvoice]
+           && stamp != time.time() && !relbwChanged)
+            continue;
+        voicestamp[nvoice] = stamp;
         setupVoiceDetune(nvoice);
         setupVoiceMod(nvoice, false);
     }
@@ -1651,9 +1620,15 @@ int ADnote::noteout(float *outl, float *outr)
         memset(tmpwavel, 0, synth.bufferbytes);
         if(stereo)
             memset(tmpwaver, 0, synth.bufferbytes);
-        for(int k = 0; k < unison_size[nvoice]; ++k) {
-            float *tw = tmpwave_unison[k];
-            if(stereo) {
+        float lvol[OSCIL_LANES], rvol[OSCIL_LANES];
+        for(int k0 = 0; k0 < unison_size[nvoice]; k0 += OSCIL_LANES) {
+            const int lanes = std::min(unison_size[nvoice] - k0, OSCIL_LANES);
+            for(int l = 0; l < lanes; ++l) {
+                const int k = k0 + l;
+                if(!stereo) {
+                    lvol[l] = 1.0f;
+                    continue;
+                }
                 float stereo_pos = 0;
                 bool is_pwm = NoteVoicePar[nvoice].FMEnabled == PW_MOD;
                 if (is_pwm) {
@@ -1683,27 +1658,21 @@ int ADnote::noteout(float *outl, float *outr)
                 float panning = (stereo_pos + 1.0f) * 0.5f;
 
 
-                float lvol = (1.0f - panning) * 2.0f;
-                if(lvol > 1.0f)
-                    lvol = 1.0f;
+                lvol[l] = (1.0f - panning) * 2.0f;
+                if(lvol[l] > 1.0f)
+                    lvol[l] = 1.0f;
 
-                float rvol = panning * 2.0f;
-                if(rvol > 1.0f)
-                    rvol = 1.0f;
+                rvol[l] = panning * 2.0f;
+                if(rvol[l] > 1.0f)
+                    rvol[l] = 1.0f;
 
                 if(unison_invert_phase[nvoice][k]) {
-                    lvol = -lvol;
-                    rvol = -rvol;
+                    lvol[l] = -lvol[l];
+                    rvol[l] = -rvol[l];
                 }
-
-                for(int i = 0; i < synth.buffersize; ++i)
-                    tmpwavel[i] += tw[i] * lvol;
-                for(int i = 0; i < synth.buffersize; ++i)
-                    tmpwaver[i] += tw[i] * rvol;
             }
-            else
-                for(int i = 0; i < synth.buffersize; ++i)
-                    tmpwavel[i] += tw[i];
+            unisonMix(&tmpwave_unison[k0], lvol, rvol, lanes, tmpwavel,
+                      stereo ? tmpwaver : NULL, synth.buffersize);
         }
 
 
@@ -1923,7 +1892,12 @@ void ADnote::Voice::releasekey()
 
 void ADnote::Voice::kill(Allocator &memory, const SYNTH_T &synth)
 {
-    memory.devalloc(OscilSmp);
+    if(OscilShared) {
+        OscilShared->unref();
+        OscilShared = NULL;
+        OscilSmp    = NULL;
+    } else
+        memory.devalloc(OscilSmp);
     memory.dealloc(FreqEnvelope);
     memory.dealloc(FreqLfo);
     memory.dealloc(AmpEnvelope);
@@ -1934,7 +1908,11 @@ void ADnote::Voice::kill(Allocator &memory, const SYNTH_T &synth)
     memory.dealloc(FMFreqEnvelope);
     memory.dealloc(FMAmpEnvelope);
 
-    if((FMEnabled != NONE) && (FMVoice < 0))
+    if(FMShared) {
+        FMShared->unref();
+        FMShared = NULL;
+        FMSmp    = NULL;
+    } else if((FMEnabled != NONE) && (FMVoice < 0))
         memory.devalloc(FMSmp);
 
     if(VoiceOut)
@@ -1963,18 +1941,19 @@ void ADnote::Global::initparameters(const ADnoteGlobalParam &param,
                                     float basefreq, float velocity,
                                     bool stereo,
                                     WatchManager *wm,
-                                    const char *prefix)
+                                    const char *prefix,
+                                    RandomStream *rng)
 {
     ScratchString pre = prefix;
     FreqEnvelope = memory.alloc<Envelope>(*param.FreqEnvelope, basefreq,
             synth.dt(), wm, (pre+"GlobalPar/FreqEnvelope/").c_str);
     FreqLfo      = memory.alloc<LFO>(*param.FreqLfo, basefreq, time, wm,
-                   (pre+"GlobalPar/FreqLfo/").c_str);
+                   (pre+"GlobalPar/FreqLfo/").c_str, rng);
 
     AmpEnvelope = memory.alloc<Envelope>(*param.AmpEnvelope, basefreq,
             synth.dt(), wm, (pre+"GlobalPar/AmpEnvelope/").c_str);
     AmpLfo      = memory.alloc<LFO>(*param.AmpLfo, basefreq, time, wm,
-                   (pre+"GlobalPar/AmpLfo/").c_str);
+                   (pre+"GlobalPar/AmpLfo/").c_str, rng);
 
     Volume = 4.0f * powf(0.1f, 3.0f * (1.0f - param.PVolume / 96.0f)) //-60 dB .. 0 dB
              * VelF(velocity, param.PAmpVelocityScaleFunction);     //sensing
@@ -1985,7 +1964,7 @@ void ADnote::Global::initparameters(const ADnoteGlobalParam &param,
     FilterEnvelope = memory.alloc<Envelope>(*param.FilterEnvelope, basefreq,
             synth.dt(), wm, (pre+"GlobalPar/FilterEnvelope/").c_str);
     FilterLfo      = memory.alloc<LFO>(*param.FilterLfo, basefreq, time, wm,
-                   (pre+"GlobalPar/FilterLfo/").c_str);
+                   (pre+"GlobalPar/FilterLfo/").c_str, rng);
 
     Filter->addMod(*FilterEnvelope);
     Filter->addMod(*FilterLfo);
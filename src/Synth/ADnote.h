@@ -58,6 +58,12 @@ class ADnote:public SynthNote
         void setupVoiceDetune(int nvoice);
         void setupVoiceMod(int nvoice, bool first_run = true);
 
+        /**Fills smps with the output of osc, sharing the buffer with the
+         * other notes when it does not depend upon the note
+         * @return start position as returned by OscilGen::get()*/
+        int loadOscil(OscilGen &osc, float *&smps, OscilBuffer *&shared,
+                      float freq, int resonance);
+
         /**Changes the frequency of an oscillator.
          * @param nvoice voice to run computations on
          * @param in_freq new frequency*/
@@ -91,6 +97,9 @@ class ADnote:public SynthNote
         inline void ComputeVoiceOscillatorMix(int nvoice);
         /**Computes the Ring Modulated Oscillator.*/
         inline void ComputeVoiceOscillatorRingModulation(int nvoice);
+        /**Mixes or ring modulates tmpwave_unison with the voice's own
+         * modulator and updates oscposhiFM/oscposloFM*/
+        inline void ComputeVoiceModulator(int nvoice, bool ring);
         /**Computes the Frequency Modulated Oscillator.
          * @param FMmode modulation type 0=Phase 1=Frequency*/
         inline void ComputeVoiceOscillatorFrequencyModulation(int nvoice,
@@ -128,7 +137,8 @@ class ADnote:public SynthNote
                                 float basefreq, float velocity,
                                 bool stereo,
                                 WatchManager *wm,
-                                const char *prefix);
+                                const char *prefix,
+                                RandomStream *rng);
             /******************************************
             *     FREQUENCY GLOBAL PARAMETERS        *
             ******************************************/
@@ -183,6 +193,7 @@ class ADnote:public SynthNote
 
             /* Waveform of the Voice */
             float *OscilSmp;
+            OscilBuffer *OscilShared; //owner of OscilSmp if shared
 
             /* preserved for phase mod PWM emulation. */
             int phase_offset;
@@ -242,6 +253,7 @@ class ADnote:public SynthNote
 
             /* Wave of the Voice */
             float *FMSmp;
+            OscilBuffer *FMShared; //owner of FMSmp if shared
 
             float FMVolume;
             float FMDetune;  //in cents
@@ -256,7 +268,7 @@ class ADnote:public SynthNote
         /********************************************************/
 
         //pinking filter (Paul Kellet)
-        float pinking[NUM_VOICES][14];
+        float pinking[NUM_VOICES][2][PINK_STATE];
 
         //the size of unison for a single voice
         int unison_size[NUM_VOICES];
@@ -317,6 +329,13 @@ class ADnote:public SynthNote
         //1 - if it is the fitst tick (used to fade in the sound)
         char firsttick[NUM_VOICES];
 
+        //parameter time stamp each voice was last set up with
+        //(see ADnoteParameters::getVoiceUpdateTimestamp())
+        int64_t voicestamp[NUM_VOICES];
+
+        //bandwidth controller value the voices were last set up with
+        float voicerelbw;
+
         //1 if the note has portamento
         int portamento;
 
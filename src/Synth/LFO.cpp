@@ -22,14 +22,15 @@
 namespace zyn {
 
 LFO::LFO(const LFOParams &lfopars, float basefreq, const AbsTime &t, WatchManager *m,
-        const char *watch_prefix)
+        const char *watch_prefix, RandomStream *rng_)
     :first_half(-1),
     delayTime(t, lfopars.Pdelay / 127.0f * 4.0f), //0..4 sec
     waveShape(lfopars.PLFOtype),
     deterministic(!lfopars.Pfreqrand),
     dt_(t.dt()),
     lfopars_(lfopars), basefreq_(basefreq),
-    watchOut(m, watch_prefix, "out")
+    watchOut(m, watch_prefix, "out"),
+    rng(rng_ ? rng_->split() : RandomStream::global())
 {
     int stretch = lfopars.Pstretch;
     if(stretch == 0)
@@ -44,7 +45,7 @@ LFO::LFO(const LFOParams &lfopars, float basefreq, const AbsTime &t, WatchManage
 
     if(!lfopars.Pcontinous) {
         if(lfopars.Pstartphase == 0)
-            phase = RND;
+            phase = rng.rnd();
         else
             phase = fmod((lfopars.Pstartphase - 64.0f) / 127.0f + 1.0f, 1.0f);
     }
@@ -75,8 +76,8 @@ LFO::LFO(const LFOParams &lfopars, float basefreq, const AbsTime &t, WatchManage
             break;
     }
 
-    amp1     = (1 - lfornd) + lfornd * RND;
-    amp2     = (1 - lfornd) + lfornd * RND;
+    amp1     = (1 - lfornd) + lfornd * rng.rnd();
+    amp2     = (1 - lfornd) + lfornd * rng.rnd();
     incrnd   = nextincrnd = 1.0f;
     computeNextFreqRnd();
     computeNextFreqRnd(); //twice because I want incrnd & nextincrnd to be random
@@ -109,7 +110,7 @@ float LFO::baseOut(const char waveShape, const float phase)
         case LFO_RANDOM:
             if ((phase < 0.5) != first_half) {
                 first_half = phase < 0.5;
-                last_random = 2*RND-1;
+                last_random = 2*rng.rnd()-1;
             }
             return last_random;
         default:            return cosf(phase * 2.0f * PI); //LFO_SINE
@@ -168,7 +169,7 @@ float LFO::lfoout()
     if(phase >= 1) {
         phase    = fmod(phase, 1.0f);
         amp1 = amp2;
-        amp2 = (1 - lfornd) + lfornd * RND;
+        amp2 = (1 - lfornd) + lfornd * rng.rnd();
 
         computeNextFreqRnd();
     }
@@ -193,7 +194,7 @@ void LFO::computeNextFreqRnd()
     if(deterministic)
         return;
     incrnd     = nextincrnd;
-    nextincrnd = powf(0.5f, lfofreqrnd) + RND * (powf(2.0f, lfofreqrnd) - 1.0f);
+    nextincrnd = powf(0.5f, lfofreqrnd) + rng.rnd() * (powf(2.0f, lfofreqrnd) - 1.0f);
 }
 
 }
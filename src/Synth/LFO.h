@@ -16,6 +16,7 @@
 
 #include "../globals.h"
 #include "../Misc/Time.h"
+#include "../Misc/Util.h"
 #include "WatchPoint.h"
 
 namespace zyn {
@@ -28,9 +29,10 @@ class LFO
          *
          * @param lfopars pointer to a LFOParams object
          * @param basefreq base frequency of LFO
+         * @param rng stream of the owning note (NULL for the global one)
          */
         LFO(const LFOParams &lfopars, float basefreq, const AbsTime &t, WatchManager *m=0,
-                const char *watch_prefix=0);
+                const char *watch_prefix=0, RandomStream *rng=0);
         ~LFO();
 
         float lfoout();
@@ -69,6 +71,8 @@ class LFO
 
         VecWatchPoint watchOut;
 
+        RandomStream rng;
+
         void computeNextFreqRnd(void);
 };
 
@@ -111,10 +111,14 @@ void ModFilter::updateSense(float velocity, uint8_t scale,
         
 void ModFilter::filter(float *l, float *r)
 {
-    if(left && l)
-        left->filterout(l);
-    if(right && r)
-        right->filterout(r);
+    if(left && l && right && r)
+        left->filterout_stereo(l, *right, r);
+    else {
+        if(left && l)
+            left->filterout(l);
+        if(right && r)
+            right->filterout(r);
+    }
 }
 
 static int current_category(Filter *f)
@@ -15,8 +15,11 @@
 #include "../DSP/FFTwrapper.h"
 #include "../Synth/Resonance.h"
 #include "../Misc/WaveShapeSmps.h"
+#include "../Misc/Allocator.h"
 
+#include <algorithm>
 #include <cassert>
+#include <climits>
 #include <cstdlib>
 #include <cmath>
 #include <cstdio>
@@ -29,10 +32,40 @@
 
 namespace zyn {
 
+//Computes the spectrum (and the wavetables for it) outside of the realtime
+//thread and hands them over to the realtime side through path (".../prepare")
+static void prepareNonRt(OscilGen &o, rtosc::RtData &d, const char *path)
+{
+    fft_t *data = new fft_t[o.synth.oscilsize / 2];
+    o.prepare(data);
+    // fprintf(stderr, "sending '%p' of fft data\n", data);
+    d.chain(path, "b", sizeof(fft_t*), &data);
+    o.pendingfreqs = data;
+
+    if(o.ADvsPAD)
+        return;
+    OscilTables *tables = o.maketables(data);
+    char  repath[128];
+    strcpy(repath, path);
+    strcpy(strrchr(repath, '/')+1, "tables");
+    d.chain(repath, "b", sizeof(OscilTables*), &tables);
+}
+
 #define rObject OscilGen
 const rtosc::Ports OscilGen::non_realtime_ports = {
     rSelf(OscilGen),
-    rPaste,
+    rPresetType,
+    {"paste:b", rProp(internal) rDoc("paste port"), 0,
+        [](const char *m, rtosc::RtData &d) {
+            OscilGen &paste = **(OscilGen **)rtosc_argument(m,0).b.data;
+            OscilGen &o = *(OscilGen*)d.obj;
+            o.paste(paste);
+            //XXX hack hack
+            char  repath[128];
+            strcpy(repath, d.loc);
+            strcpy(strrchr(repath, '/')+1, "prepare");
+            prepareNonRt(o, d, repath);
+        }},
     //TODO ensure min/max
     rOption(Phmagtype, rShort("scale"),
             rOptions(linear,dB scale (-40),
@@ -113,12 +146,7 @@ const rtosc::Ports OscilGen::non_realtime_ports = {
                 strcpy(repath, d.loc);
                 char *edit   = strrchr(repath, '/')+1;
                 strcpy(edit, "prepare");
-                OscilGen &o = *((OscilGen*)d.obj);
-                fft_t *data = new fft_t[o.synth.oscilsize / 2];
-                o.prepare(data);
-                // fprintf(stderr, "sending '%p' of fft data\n", data);
-                d.chain(repath, "b", sizeof(fft_t*), &data);
-                o.pendingfreqs = data;
+                prepareNonRt(*((OscilGen*)d.obj), d, repath);
             }
         }},
     //TODO update to rArray and test
@@ -139,12 +167,7 @@ const rtosc::Ports OscilGen::non_realtime_ports = {
                 strcpy(repath, d.loc);
                 char *edit   = strrchr(repath, '/')+1;
                 strcpy(edit, "prepare");
-                OscilGen &o = *((OscilGen*)d.obj);
-                fft_t *data = new fft_t[o.synth.oscilsize / 2];
-                o.prepare(data);
-                // fprintf(stderr, "sending '%p' of fft data\n", data);
-                d.chain(repath, "b", sizeof(fft_t*), &data);
-                o.pendingfreqs = data;
+                prepareNonRt(*((OscilGen*)d.obj), d, repath);
             }
         }},
     {"base-spectrum:", rProp(non-realtime) rDoc("Returns spectrum of base waveshape"),
@@ -170,12 +193,7 @@ const rtosc::Ports OscilGen::non_realtime_ports = {
     {"prepare:", rProp(non-realtime) rDoc("Performs setup operation to oscillator"),
         NULL, [](const char *, rtosc::RtData &d) {
             //fprintf(stderr, "prepare: got a message from '%s'\n", m);
-            OscilGen &o = *(OscilGen*)d.obj;
-            fft_t *data = new fft_t[o.synth.oscilsize / 2];
-            o.prepare(data);
-            // fprintf(stderr, "sending '%p' of fft data\n", data);
-            d.chain(d.loc, "b", sizeof(fft_t*), &data);
-            o.pendingfreqs = data;
+            prepareNonRt(*(OscilGen*)d.obj, d, d.loc);
         }},
     {"convert2sine:", rProp(non-realtime) rDoc("Translates waveform into FS"),
         NULL, [](const char *, rtosc::RtData &d) {
@@ -184,6 +202,8 @@ const rtosc::Ports OscilGen::non_realtime_ports = {
             char  repath[128];
             strcpy(repath, d.loc);
             char *edit   = strrchr(repath, '/')+1;
+            strcpy(edit, "prepare");
+            prepareNonRt(*((OscilGen*)d.obj), d, repath);
             *edit = 0;
             d.reply("/damage", "s", repath);
         }},
@@ -194,6 +214,8 @@ const rtosc::Ports OscilGen::non_realtime_ports = {
             char  repath[128];
             strcpy(repath, d.loc);
             char *edit   = strrchr(repath, '/')+1;
+            strcpy(edit, "prepare");
+            prepareNonRt(*((OscilGen*)d.obj), d, repath);
             *edit = 0;
             d.reply("/damage", "s", repath);
         }}};
@@ -253,6 +275,16 @@ const rtosc::Ports OscilGen::realtime_ports{
             assert(o.oscilFFTfreqs !=*(fft_t**)rtosc_argument(m,0).b.data);
             o.oscilFFTfreqs = *(fft_t**)rtosc_argument(m,0).b.data;
         }},
+    {"tables:b", rProp(internal) rProp(realtime) rProp(pointer) rDoc("Sets precomputed wavetables"),
+        NULL, [](const char *m, rtosc::RtData &d) {
+            OscilGen &o = *(OscilGen*)d.obj;
+            assert(rtosc_argument(m,0).b.len == sizeof(void*));
+            if(o.tables) {
+                o.tables->release();
+                d.reply("/free", "sb", "OscilTables", sizeof(void*), &o.tables);
+            }
+            o.tables = *(OscilTables**)rtosc_argument(m,0).b.data;
+        }},
 
 };
 
@@ -353,6 +385,8 @@ OscilGen::OscilGen(const SYNTH_T &synth_, FFTwrapper *fft_, Resonance *res_)
     cachedbasefunc = new float[synth.oscilsize];
     cachedbasevalid = false;
     pendingfreqs     = oscilFFTfreqs;
+    tables           = NULL;
+    revision         = 0;
 
     randseed = 1;
     ADvsPAD  = false;
@@ -367,6 +401,7 @@ OscilGen::~OscilGen()
     delete[] basefuncFFTfreqs;
     delete[] oscilFFTfreqs;
     delete[] cachedbasefunc;
+    delete tables;
 }
 
 
@@ -818,6 +853,11 @@ void OscilGen::prepare(void)
 
 void OscilGen::prepare(fft_t *freqs)
 {
+    //The tables no longer match the spectrum. They are left alone, as this
+    //may run outside of the realtime thread while notes use them
+    if(freqs == oscilFFTfreqs)
+        ++revision;
+
     if((oldbasepar != Pbasefuncpar) || (oldbasefunc != Pcurrentbasefunc)
        || DIFF(basefuncmodulation) || DIFF(basefuncmodulationpar1)
        || DIFF(basefuncmodulationpar2) || DIFF(basefuncmodulationpar3))
@@ -964,7 +1004,7 @@ void OscilGen::adaptiveharmonicpostprocess(fft_t *f, int size)
     par = 1.0f - powf((1.0f - par), 1.5f);
 
     for(int i = 0; i < size; ++i) {
-        inf[i] = f[i] * double(par);
+        inf[i] = f[i] * (fftw_real)par;
         f[i]  *= (1.0f - par);
     }
 
@@ -1039,16 +1079,29 @@ bool OscilGen::needPrepare(void)
  * Get the oscillator function
  */
 short int OscilGen::get(float *smps, float freqHz, int resonance)
+{
+    RandomStream rng = RandomStream::global();
+    return get(smps, freqHz, resonance, rng);
+}
+
+short int OscilGen::get(float *smps, float freqHz, int resonance,
+                        RandomStream &rng)
 {
     if(needPrepare())
         prepare();
 
     fft_t *input = freqHz > 0.0f ? oscilFFTfreqs : pendingfreqs;
 
-    int outpos =
-        (int)((RND * 2.0f
-               - 1.0f) * synth.oscilsize_f * (Prand - 64.0f) / 64.0f);
-    outpos = (outpos + 2 * synth.oscilsize) % synth.oscilsize;
+    int outpos = randpos(rng);
+
+    //Precomputed output
+    const int k = tableindex(freqHz, resonance);
+    if(k >= 0) {
+        memcpy(smps, tables->table(k), synth.oscilsize * sizeof(float));
+        //Advance rng just like the harmonic amplitude randomness does
+        rng.seed(rng.next() + 1);
+        return Prand < 64 ? outpos : 0;
+    }
 
 
     clearAll(outoscilFFTfreqs, synth.oscilsize);
@@ -1085,13 +1138,14 @@ short int OscilGen::get(float *smps, float freqHz, int resonance)
         const float rnd = PI * powf((Prand - 64.0f) / 64.0f, 2.0f);
         for(int i = 1; i < nyquist - 1; ++i) //to Nyquist only for AntiAliasing
             outoscilFFTfreqs[i] *=
-                FFTpolar<fftw_real>(1.0f, (float)(rnd * i * RND));
+                FFTpolar<fftw_real>(1.0f, (float)(rnd * i * rng.rnd()));
     }
 
     //Harmonic Amplitude Randomness
     if((freqHz > 0.1f) && (!ADvsPAD)) {
-        unsigned int realrnd = prng();
-        sprng(randseed);
+        //The amplitudes only depend upon randseed
+        unsigned int realrnd = rng.next();
+        RandomStream amprng(randseed);
         float power     = Pamprandpower / 127.0f;
         float normalize = 1.0f / (1.2f - power);
         switch(Pamprandtype) {
@@ -1099,18 +1153,18 @@ short int OscilGen::get(float *smps, float freqHz, int resonance)
                 power = power * 2.0f - 0.5f;
                 power = powf(15.0f, power);
                 for(int i = 1; i < nyquist - 1; ++i)
-                    outoscilFFTfreqs[i] *= powf(RND, power) * normalize;
+                    outoscilFFTfreqs[i] *= powf(amprng.rnd(), power) * normalize;
                 break;
             case 2:
                 power = power * 2.0f - 0.5f;
                 power = powf(15.0f, power) * 2.0f;
-                float rndfreq = 2 * PI * RND;
+                float rndfreq = 2 * PI * amprng.rnd();
                 for(int i = 1; i < nyquist - 1; ++i)
                     outoscilFFTfreqs[i] *= powf(fabs(sinf(i * rndfreq)), power)
                                            * normalize;
                 break;
         }
-        sprng(realrnd + 1);
+        rng.seed(realrnd + 1);
     }
 
     if((freqHz > 0.1f) && (resonance != 0))
@@ -1133,6 +1187,207 @@ short int OscilGen::get(float *smps, float freqHz, int resonance)
         return 0;
 }
 
+OscilBuffer *OscilGen::getshared(float freqHz, int resonance,
+                                 RandomStream &rng, Allocator &memory,
+                                 int extra, short &start)
+{
+    if(needPrepare())
+        prepare();
+
+    const int k = tableindex(freqHz, resonance);
+    if(k < 0)
+        return NULL;
+
+    OscilBuffer *&buf = tables->shared[k];
+    if(!buf) {
+        buf = OscilBuffer::make(memory, tables->table(k), synth.oscilsize,
+                                extra);
+        if(!buf)
+            return NULL;
+    }
+
+    //Same random numbers as get()
+    const int outpos = randpos(rng);
+    rng.seed(rng.next() + 1);
+    start = Prand < 64 ? outpos : 0;
+
+    buf->ref();
+    return buf;
+}
+
+int OscilGen::tableindex(float freqHz, int resonance) const
+{
+    //Output depending upon more than the frequency
+    if(!tables || tables->src != oscilFFTfreqs
+       || tables->revision != revision || freqHz <= 0.1f || ADvsPAD
+       || Prand > 64 || Pamprandtype || Padaptiveharmonics
+       || (resonance && res && res->Penabled))
+        return -1;
+    return tables->lookup(freqHz);
+}
+
+int OscilGen::randpos(RandomStream &rng) const
+{
+    int outpos =
+        (int)((rng.rnd() * 2.0f
+               - 1.0f) * synth.oscilsize_f * (Prand - 64.0f) / 64.0f);
+    return (outpos + 2 * synth.oscilsize) % synth.oscilsize;
+}
+
+OscilTables *OscilGen::maketables(const fft_t *freqs) const
+{
+    const int half = synth.oscilsize / 2;
+    OscilTables *t = new OscilTables(freqs, synth.oscilsize,
+                                     0.5f * synth.samplerate_f);
+    t->revision = revision;
+
+    //The instance's fft is shared with the realtime thread
+    FFTwrapper ifft(synth.oscilsize);
+    fft_t     *spectrum = new fft_t[half];
+    for(int k = 0; k < t->n; ++k) {
+        //Same antialiasing as get() does for the notes with this many
+        //harmonics
+        clearAll(spectrum, synth.oscilsize);
+        for(int i = 1; i <= t->harmonics[k]; ++i)
+            spectrum[i] = freqs[i];
+        rmsNormalize(spectrum, synth.oscilsize);
+
+        float *smps = t->smps + k * synth.oscilsize;
+        ifft.freqs2smps(spectrum, smps);
+        for(int i = 0; i < synth.oscilsize; ++i)
+            smps[i] *= 0.25f;                     //correct the amplitude
+    }
+    delete[] spectrum;
+
+    return t;
+}
+
+void OscilGen::preparetables(void)
+{
+    prepare();
+    droptables();
+    tables = ADvsPAD ? NULL : maketables(oscilFFTfreqs);
+}
+
+void OscilGen::droptables(void)
+{
+    //No note of the realtime thread ever used the old tables
+    assert(!tables || !tables->inuse());
+    delete tables;
+    tables = NULL;
+}
+
+void OscilGen::releasetables(void)
+{
+    if(tables)
+        tables->release();
+}
+
+OscilTables::OscilTables(const fft_t *src_, int oscilsize_, float nyqfreq_)
+    :src(src_), revision(0), oscilsize(oscilsize_), nyqfreq(nyqfreq_), n(0)
+{
+    //get() keeps up to oscilsize / 2 - 2 harmonics
+    const int most  = oscilsize / 2 - 2;
+    const int limit = std::max(1, OSCIL_TABLE_BYTES
+                                  / (int)(oscilsize * sizeof(float)));
+    harmonics = new int[most];
+    beyond    = INT_MAX;
+    for(int h = 1;;) {
+        if(n == limit) {
+            beyond = h;
+            break;
+        }
+        harmonics[n++] = h;
+        if(h >= most)
+            break;
+        if(h < OSCIL_TABLE_EXACT)
+            h += 1;
+        else if(h < OSCIL_TABLE_FINE)
+            h = std::max(h + 1,
+                         (int)(h * powf(2.0f, 1.0f / OSCIL_TABLE_STEPS)));
+        else
+            h *= 2;
+        h = std::min(h, most);
+    }
+
+    smps   = new float[n * oscilsize];
+    shared = new OscilBuffer*[n];
+    for(int k = 0; k < n; ++k)
+        shared[k] = NULL;
+}
+
+OscilTables::~OscilTables()
+{
+    //Only left when the allocator is no longer used by the realtime thread
+    //(see OscilGen::releasetables())
+    release();
+    delete[] harmonics;
+    delete[] smps;
+    delete[] shared;
+}
+
+void OscilTables::release(void)
+{
+    for(int k = 0; k < n; ++k) {
+        if(shared[k])
+            shared[k]->unref();
+        shared[k] = NULL;
+    }
+}
+
+bool OscilTables::inuse(void) const
+{
+    for(int k = 0; k < n; ++k)
+        if(shared[k])
+            return true;
+    return false;
+}
+
+OscilBuffer *OscilBuffer::make(Allocator &memory, const float *wave,
+                               int oscilsize, int extra)
+{
+    //The wave directly follows the header, and bypasses the allocator's
+    //transactions as the buffer outlives the note creating it
+    void *mem = memory.alloc_mem(sizeof(OscilBuffer)
+                                 + (oscilsize + extra) * sizeof(float));
+    if(!mem)
+        return NULL;
+
+    float *data = (float*)((char*)mem + sizeof(OscilBuffer));
+    memcpy(data, wave, oscilsize * sizeof(float));
+    for(int i = 0; i < extra; ++i)
+        data[oscilsize + i] = data[i];
+
+    return new(mem) OscilBuffer(memory, data);
+}
+
+void OscilBuffer::unref(void)
+{
+    if(refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    Allocator &pool = memory;
+    this->~OscilBuffer();
+    pool.dealloc_mem(this);
+}
+
+int OscilTables::count(float freq) const
+{
+    //As computed by get()
+    int nyquist = (int)(nyqfreq / fabs(freq)) + 2;
+    if(nyquist > oscilsize / 2)
+        nyquist = oscilsize / 2;
+    return nyquist - 2;
+}
+
+int OscilTables::lookup(float freq) const
+{
+    const int h = count(freq);
+    if(h < 1 || h >= beyond)
+        return -1;
+    //the last table with at most h harmonics
+    return std::upper_bound(harmonics, harmonics + n, h) - harmonics - 1;
+}
+
 ///*
 // * Get the oscillator function's harmonics
 // */
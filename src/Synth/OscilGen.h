@@ -15,11 +15,96 @@
 #define OSCIL_GEN_H
 
 #include "../globals.h"
+#include <atomic>
 #include <rtosc/ports.h>
 #include "../Params/Presets.h"
+#include "../Misc/Util.h"
 
 namespace zyn {
 
+/**
+ * Read only oscillator wave which is shared by every note playing it.
+ *
+ * It lives within the realtime Allocator and is reference counted, so the
+ * last reference may be dropped from any of the render threads.
+ */
+class OscilBuffer
+{
+    public:
+        /**Copies wave and repeats its first extra samples at the end
+         * @return NULL if the pool is exhausted*/
+        static OscilBuffer *make(Allocator &memory, const float *wave,
+                                 int oscilsize, int extra) REALTIME;
+
+        void ref(void) { refs.fetch_add(1, std::memory_order_relaxed); }
+        //Frees the buffer once the last reference is gone
+        void unref(void) REALTIME;
+
+        //Not to be written to
+        float *smps(void) const { return data; }
+
+    private:
+        OscilBuffer(Allocator &memory_, float *data_)
+            :memory(memory_), refs(1), data(data_) {}
+
+        Allocator       &memory;
+        std::atomic<int> refs;
+        float           *data;
+};
+
+//Notes keeping up to this many harmonics get the exact output from the tables
+#define OSCIL_TABLE_EXACT 24
+//Tables per octave of harmonics above OSCIL_TABLE_EXACT
+#define OSCIL_TABLE_STEPS 12
+//Above this many harmonics there is one table per octave
+#define OSCIL_TABLE_FINE  256
+//Memory the tables of one oscillator may take
+#define OSCIL_TABLE_BYTES (2 << 20)
+
+/**
+ * Band limited copies of a prepared oscillator.
+ *
+ * get() keeps the harmonics up to nyquist, table k keeps the first
+ * harmonics[k] of them. There is a table for every count up to
+ * OSCIL_TABLE_EXACT and for every twelfth of an octave up to
+ * OSCIL_TABLE_FINE, so the notes with more harmonics only miss those above
+ * 0.9 * nyquist. The lowest notes (below 86Hz at 44.1kHz) get one table per
+ * octave and may miss those above nyquist / 2.
+ *
+ * That is at most ~80 tables, i.e. 300kB at the default oscilsize of 1024.
+ * With large oscilsizes the tables with the most harmonics are left out to
+ * stay within OSCIL_TABLE_BYTES, and the notes needing them compute their
+ * wave with get() as before (at 16384 only notes above ~670Hz use tables).
+ * They are computed outside of the realtime thread (see OscilGen::get()).
+ */
+struct OscilTables
+{
+    OscilTables(const fft_t *src, int oscilsize, float nyqfreq);
+    ~OscilTables();
+
+    //Harmonics get() keeps for freq
+    int  count(float freq) const;
+    //Index of the table to be used for freq or -1 if there is none
+    int  lookup(float freq) const;
+    const float *table(int k) const { return smps + k * oscilsize; }
+
+    //Drop the buffers handed out to the notes (realtime side only, the
+    //destructor frees what is left with the allocator no longer in use)
+    void release(void) REALTIME;
+    //True while buffers are handed out
+    bool inuse(void) const;
+
+    const fft_t *src;       //the spectrum the tables were computed from
+    unsigned     revision;  //and its OscilGen::revision
+    int          oscilsize;
+    float        nyqfreq;
+    int          n;         //number of tables
+    int          beyond;    //harmonic count from which there are no tables
+    int         *harmonics; //n ascending harmonic counts, the last one all
+    float       *smps;      //n * oscilsize samples
+    OscilBuffer **shared;   //n buffers, created on first use
+};
+
 class OscilGen:public Presets
 {
     public:
@@ -36,6 +121,29 @@ class OscilGen:public Presets
         short get(float *smps, float freqHz, int resonance = 0);
         //if freqHz is smaller than 0, return the "un-randomized" sample for UI
 
+        //Same as above, but the randomness is drawn from rng
+        short get(float *smps, float freqHz, int resonance, RandomStream &rng);
+
+        /**Returns a new reference to the output of get() if it can be shared
+         * by every note (extra samples are appended as by ADnote)
+         * or NULL if get() needs to be called instead
+         * @param start is set to the return value of get()*/
+        OscilBuffer *getshared(float freqHz, int resonance, RandomStream &rng,
+                               Allocator &memory, int extra,
+                               short &start) REALTIME;
+
+        /**computes the band limited tables for the spectrum freqs (as
+         * returned by prepare(fft_t*)) */
+        OscilTables *maketables(const fft_t *freqs) const NONREALTIME;
+        /**prepare() and replace the tables; only for instances which are
+         * not shared with the realtime thread (e.g. while loading)*/
+        void preparetables(void) NONREALTIME;
+        /**delete the tables, under the same conditions as preparetables()*/
+        void droptables(void) NONREALTIME;
+        /**drop the buffers handed out by getshared() before the instance
+         * leaves the realtime thread (they are in its allocator)*/
+        void releasetables(void) REALTIME;
+
         void getbasefunction(float *smps);
 
         //called by UI
@@ -117,6 +225,16 @@ class OscilGen:public Presets
         fft_t *oscilFFTfreqs;
 
         fft_t *pendingfreqs;
+
+        /* Precomputed output of get() for oscilFFTfreqs (may be NULL).
+         *  They are skipped when the output depends upon more than the
+         *  frequency (per harmonic randomness, amplitude randomness,
+         *  adaptive harmonics or resonance), in which case get() computes
+         *  the oscillator from the spectrum as before */
+        OscilTables *tables;
+        /* Counts the prepare()s changing oscilFFTfreqs in place, which
+         *  leave the tables outdated until new ones are handed over */
+        unsigned revision;
     private:
         //This array stores some termporary data and it has OSCIL_SIZE elements
         float *tmpsmps;
@@ -151,6 +269,12 @@ class OscilGen:public Presets
         bool needPrepare(void);
     private:
 
+        //Table to be used by get() or -1 if it needs to be computed
+        int tableindex(float freqHz, int resonance) const;
+
+        //Random start position of the wave (block type randomness)
+        int randpos(RandomStream &rng) const;
+
         //Do the adaptive harmonic stuff
         void adaptiveharmonic(fft_t *f, float freq);
 
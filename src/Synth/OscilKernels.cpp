@@ -0,0 +1,465 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  OscilKernels.cpp - Vectorized Unison Oscillator Kernels For ADnote
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "OscilKernels.h"
+#include "../Misc/Simd.h"
+#include "../globals.h"
+#include <cmath>
+
+namespace zyn {
+
+//Samples computed per lane before they are copied to the voices
+#define OSCIL_BLOCK 16
+
+/*
+ * Unused lanes run with a zero phase and increment, so they only ever read
+ * smps[0] and smps[1] and are not written back.
+ *
+ * B samples of every lane are kept in v[] and then copied to the voices.
+ */
+#ifdef ZYN_SIMD_VECTOR
+template<int B>
+static ZYN_KERNEL void oscilLinearBody(const float *smps, int mask,
+                                       UnisonPhase &ph, int nvoices,
+                                       float *const *out, int n)
+{
+    static_assert(OSCIL_LANES == 8, "oscilLinearBody works on vint8");
+    vint8 hi, lo, freqhi, freqlo;
+    for(int l = 0; l < OSCIL_LANES; ++l) {
+        const bool used = l < nvoices;
+        hi[l]     = used ? ph.hi[l] : 0;
+        lo[l]     = used ? ph.lo[l] : 0;
+        freqhi[l] = used ? ph.freqhi[l] : 0;
+        freqlo[l] = used ? ph.freqlo[l] : 0;
+    }
+
+    for(int i0 = 0; i0 < n; i0 += B) {
+        const int m = n - i0 < B ? n - i0 : B;
+        vfloat8 v[B];
+        for(int j = 0; j < m; ++j) {
+            //There is no gather before AVX2, so the loads stay scalar
+            vfloat8 a, b;
+            for(int l = 0; l < OSCIL_LANES; ++l) {
+                a[l] = smps[hi[l]];
+                b[l] = smps[hi[l] + 1];
+            }
+            v[j] = (a * vtofloat((1<<24) - lo) + b * vtofloat(lo))
+                   / (1.0f * (1<<24));
+            lo += freqlo;
+            hi += freqhi + (lo >> 24);
+            lo &= 0xffffff;
+            hi &= mask;
+        }
+        for(int l = 0; l < nvoices; ++l)
+            for(int j = 0; j < m; ++j)
+                out[l][i0 + j] = v[j][l];
+    }
+
+    for(int l = 0; l < nvoices; ++l) {
+        ph.hi[l] = hi[l];
+        ph.lo[l] = lo[l];
+    }
+}
+#else
+template<int B>
+static ZYN_KERNEL void oscilLinearBody(const float *smps, int mask,
+                                       UnisonPhase &ph, int nvoices,
+                                       float *const *out, int n)
+{
+    const int L = OSCIL_LANES;
+    int32_t hi[L], lo[L], freqhi[L], freqlo[L];
+    for(int l = 0; l < L; ++l) {
+        const bool used = l < nvoices;
+        hi[l]     = used ? ph.hi[l] : 0;
+        lo[l]     = used ? ph.lo[l] : 0;
+        freqhi[l] = used ? ph.freqhi[l] : 0;
+        freqlo[l] = used ? ph.freqlo[l] : 0;
+    }
+
+    for(int i0 = 0; i0 < n; i0 += B) {
+        const int m = n - i0 < B ? n - i0 : B;
+        float v[B][L];
+        for(int j = 0; j < m; ++j)
+            for(int l = 0; l < L; ++l) {
+                v[j][l] = (smps[hi[l]] * ((1<<24) - lo[l])
+                           + smps[hi[l] + 1] * lo[l]) / (1.0f * (1<<24));
+                lo[l]  += freqlo[l];
+                hi[l]  += freqhi[l] + (lo[l] >> 24);
+                lo[l]  &= 0xffffff;
+                hi[l]  &= mask;
+            }
+        for(int l = 0; l < nvoices; ++l)
+            for(int j = 0; j < m; ++j)
+                out[l][i0 + j] = v[j][l];
+    }
+
+    for(int l = 0; l < nvoices; ++l) {
+        ph.hi[l] = hi[l];
+        ph.lo[l] = lo[l];
+    }
+}
+#endif
+
+/*
+ * The modulation in tw is split like F2I() and ADnote always did it, the
+ * fraction is added to the integer carrier fraction before truncating.
+ */
+#ifdef ZYN_SIMD_VECTOR
+template<int B>
+static ZYN_KERNEL void oscilModulatedBody(const float *smps, int mask,
+                                          UnisonPhase &ph,
+                                          const int32_t *offset, int nvoices,
+                                          float *const *tw, int n)
+{
+    vint8 hi, lo, freqhi, freqlo, off;
+    for(int l = 0; l < OSCIL_LANES; ++l) {
+        const bool used = l < nvoices;
+        hi[l]     = used ? ph.hi[l] : 0;
+        lo[l]     = used ? ph.lo[l] : 0;
+        freqhi[l] = used ? ph.freqhi[l] : 0;
+        freqlo[l] = used ? ph.freqlo[l] : 0;
+        off[l]    = used ? offset[l] : 0;
+    }
+
+    for(int i0 = 0; i0 < n; i0 += B) {
+        const int m = n - i0 < B ? n - i0 : B;
+        vfloat8 v[B];
+        for(int j = 0; j < m; ++j)
+            for(int l = 0; l < OSCIL_LANES; ++l)
+                v[j][l] = l < nvoices ? tw[l][i0 + j] : 0.0f;
+
+        for(int j = 0; j < m; ++j) {
+            const vfloat8 f   = v[j];
+            const vint8   pos = f > 0.0f;
+            const vint8   modhi = (vtoint(f) & pos) | (vtoint(f - 1.0f) & ~pos);
+            const vfloat8 modlo = (f - vtofloat(modhi))
+                                  + vtofloat(-(modhi < 0));
+
+            vint8 carhi = hi + modhi + off;
+            vint8 carlo = vtoint(vtofloat(lo) + modlo);
+            carhi += carlo >> 24;
+            carlo &= 0xffffff;
+            carhi &= mask;
+
+            vfloat8 a, b;
+            for(int l = 0; l < OSCIL_LANES; ++l) {
+                a[l] = smps[carhi[l]];
+                b[l] = smps[carhi[l] + 1];
+            }
+            v[j] = (a * vtofloat((1<<24) - carlo) + b * vtofloat(carlo))
+                   / (1.0f * (1<<24));
+
+            lo += freqlo;
+            hi += freqhi + (lo >> 24);
+            lo &= 0xffffff;
+            hi &= mask;
+        }
+
+        for(int l = 0; l < nvoices; ++l)
+            for(int j = 0; j < m; ++j)
+                tw[l][i0 + j] = v[j][l];
+    }
+
+    for(int l = 0; l < nvoices; ++l) {
+        ph.hi[l] = hi[l];
+        ph.lo[l] = lo[l];
+    }
+}
+
+template<int B, bool ring>
+static ZYN_KERNEL void modulatorMixBody(const float *smps, int mask,
+                                        ModulatorPhase &ph, int nvoices,
+                                        float *const *tw, int n,
+                                        float ampold, float ampnew)
+{
+    vint8   hi, freqhi;
+    vfloat8 lo, freqlo;
+    for(int l = 0; l < OSCIL_LANES; ++l) {
+        const bool used = l < nvoices;
+        hi[l]     = used ? ph.hi[l] : 0;
+        lo[l]     = used ? ph.lo[l] : 0.0f;
+        freqhi[l] = used ? ph.freqhi[l] : 0;
+        freqlo[l] = used ? ph.freqlo[l] : 0.0f;
+    }
+
+    for(int i0 = 0; i0 < n; i0 += B) {
+        const int m = n - i0 < B ? n - i0 : B;
+        vfloat8 v[B];
+        float   amp[B];
+        for(int j = 0; j < m; ++j) {
+            vfloat8 a, b;
+            for(int l = 0; l < OSCIL_LANES; ++l) {
+                a[l] = smps[hi[l]];
+                b[l] = smps[hi[l] + 1];
+            }
+            v[j]   = a * (1.0f - lo) + b * lo;
+            amp[j] = ampold + (ampnew - ampold) * (float)(i0 + j) / (float)n;
+
+            lo += freqlo;
+            const vint8 wrap = lo >= 1.0f;
+            lo -= vtofloat(-wrap);
+            hi += freqhi - wrap;
+            hi &= mask;
+        }
+
+        for(int l = 0; l < nvoices; ++l) {
+            float *x = tw[l] + i0;
+            for(int j = 0; j < m; ++j)
+                if(ring)
+                    x[j] *= v[j][l] * amp[j] + (1.0f - amp[j]);
+                else
+                    x[j] = x[j] * (1.0f - amp[j]) + amp[j] * v[j][l];
+        }
+    }
+
+    for(int l = 0; l < nvoices; ++l) {
+        ph.hi[l] = hi[l];
+        ph.lo[l] = lo[l];
+    }
+}
+#endif
+
+/*
+ * One voice after the other, as ADnote did before the kernels. Where a
+ * vfloat8 takes two registers (SSE2, NEON), moving the phases between the
+ * integer and the float lanes costs more than the lanes save: the two kernels
+ * above ran at 0.75-0.85x of these loops. So only the AVX2 build uses them.
+ */
+static ZYN_KERNEL void oscilModulatedVoices(const float *smps, int mask,
+                                            UnisonPhase &ph,
+                                            const int32_t *offset,
+                                            int nvoices, float *const *tw,
+                                            int n)
+{
+    for(int l = 0; l < nvoices; ++l) {
+        int    poshi = ph.hi[l], poslo = ph.lo[l];
+        float *x     = tw[l];
+        for(int i = 0; i < n; ++i) {
+            int modhi = 0;
+            F2I(x[i], modhi);
+            float modlo = x[i] - modhi;
+            if(modhi < 0)
+                modlo++;
+
+            int carposhi = poshi + modhi + offset[l];
+            int carposlo = poslo + modlo;
+            if(carposlo >= (1<<24)) {
+                carposhi++;
+                carposlo &= 0xffffff;
+            }
+            carposhi &= mask;
+
+            x[i] = (smps[carposhi] * ((1<<24) - carposlo)
+                    + smps[carposhi + 1] * carposlo) / (1.0f * (1<<24));
+
+            poslo += ph.freqlo[l];
+            poshi += ph.freqhi[l] + (poslo >> 24);
+            poslo &= 0xffffff;
+            poshi &= mask;
+        }
+        ph.hi[l] = poshi;
+        ph.lo[l] = poslo;
+    }
+}
+
+template<bool ring>
+static ZYN_KERNEL void modulatorMixVoices(const float *smps, int mask,
+                                          ModulatorPhase &ph, int nvoices,
+                                          float *const *tw, int n,
+                                          float ampold, float ampnew)
+{
+    for(int l = 0; l < nvoices; ++l) {
+        int    poshi = ph.hi[l];
+        float  poslo = ph.lo[l];
+        float *x     = tw[l];
+        for(int i = 0; i < n; ++i) {
+            const float amp = ampold + (ampnew - ampold) * (float)i / (float)n;
+            const float v   = smps[poshi] * (1.0f - poslo)
+                              + smps[poshi + 1] * poslo;
+            if(ring)
+                x[i] *= v * amp + (1.0f - amp);
+            else
+                x[i] = x[i] * (1.0f - amp) + amp * v;
+            poslo += ph.freqlo[l];
+            if(poslo >= 1.0f) {
+                poslo -= 1.0f;
+                poshi++;
+            }
+            poshi += ph.freqhi[l];
+            poshi &= mask;
+        }
+        ph.hi[l] = poshi;
+        ph.lo[l] = poslo;
+    }
+}
+
+/*
+ * One pass over the output per voice, which writes both channels at once
+ * instead of going over the voice a second time for the right channel.
+ */
+template<bool stereo>
+static ZYN_KERNEL void unisonMixBody(const float *const *in,
+                                     const float *lvol, const float *rvol,
+                                     int nvoices, float *outl, float *outr,
+                                     int n)
+{
+    for(int k = 0; k < nvoices; ++k) {
+        const float *x = in[k];
+        const float  l = lvol[k];
+        const float  r = stereo ? rvol[k] : 0.0f;
+        for(int i = 0; i < n; ++i) {
+            outl[i] += x[i] * l;
+            if(stereo)
+                outr[i] += x[i] * r;
+        }
+    }
+}
+
+static void oscilLinearBase(const float *smps, int mask, UnisonPhase &ph,
+                            int nvoices, float *const *out, int n)
+{
+    oscilLinearBody<OSCIL_BLOCK>(smps, mask, ph, nvoices, out, n);
+}
+
+static void oscilModulatedBase(const float *smps, int mask, UnisonPhase &ph,
+                               const int32_t *offset, int nvoices,
+                               float *const *tw, int n)
+{
+    oscilModulatedVoices(smps, mask, ph, offset, nvoices, tw, n);
+}
+
+static void modulatorMixBase(const float *smps, int mask, ModulatorPhase &ph,
+                             int nvoices, float *const *tw, int n,
+                             float ampold, float ampnew, bool ring)
+{
+    if(ring)
+        modulatorMixVoices<true>(smps, mask, ph, nvoices, tw, n, ampold,
+                                 ampnew);
+    else
+        modulatorMixVoices<false>(smps, mask, ph, nvoices, tw, n, ampold,
+                                  ampnew);
+}
+
+static void unisonMixBase(const float *const *in, const float *lvol,
+                          const float *rvol, int nvoices, float *outl,
+                          float *outr, int n)
+{
+    if(outr)
+        unisonMixBody<true>(in, lvol, rvol, nvoices, outl, outr, n);
+    else
+        unisonMixBody<false>(in, lvol, rvol, nvoices, outl, outr, n);
+}
+
+#ifdef ZYN_SIMD_AVX2
+ZYN_TARGET_AVX2
+static void oscilLinearAVX2(const float *smps, int mask, UnisonPhase &ph,
+                            int nvoices, float *const *out, int n)
+{
+    oscilLinearBody<OSCIL_BLOCK>(smps, mask, ph, nvoices, out, n);
+}
+
+#ifdef ZYN_SIMD_VECTOR
+ZYN_TARGET_AVX2
+static void oscilModulatedAVX2(const float *smps, int mask, UnisonPhase &ph,
+                               const int32_t *offset, int nvoices,
+                               float *const *tw, int n)
+{
+    oscilModulatedBody<OSCIL_BLOCK>(smps, mask, ph, offset, nvoices, tw, n);
+}
+
+ZYN_TARGET_AVX2
+static void modulatorMixAVX2(const float *smps, int mask, ModulatorPhase &ph,
+                             int nvoices, float *const *tw, int n,
+                             float ampold, float ampnew, bool ring)
+{
+    if(ring)
+        modulatorMixBody<OSCIL_BLOCK, true>(smps, mask, ph, nvoices, tw, n,
+                                            ampold, ampnew);
+    else
+        modulatorMixBody<OSCIL_BLOCK, false>(smps, mask, ph, nvoices, tw, n,
+                                             ampold, ampnew);
+}
+#endif
+
+ZYN_TARGET_AVX2
+static void unisonMixAVX2(const float *const *in, const float *lvol,
+                          const float *rvol, int nvoices, float *outl,
+                          float *outr, int n)
+{
+    if(outr)
+        unisonMixBody<true>(in, lvol, rvol, nvoices, outl, outr, n);
+    else
+        unisonMixBody<false>(in, lvol, rvol, nvoices, outl, outr, n);
+}
+#endif
+
+void oscilLinear(const float *smps, int mask, UnisonPhase &ph, int nvoices,
+                 float *const *out, int n)
+{
+#ifdef ZYN_SIMD_AVX2
+    if(cpuHasAVX2())
+        return oscilLinearAVX2(smps, mask, ph, nvoices, out, n);
+#endif
+    oscilLinearBase(smps, mask, ph, nvoices, out, n);
+}
+
+void oscilModulated(const float *smps, int mask, UnisonPhase &ph,
+                    const int32_t *offset, int nvoices, float *const *tw,
+                    int n)
+{
+#if defined(ZYN_SIMD_AVX2) && defined(ZYN_SIMD_VECTOR)
+    if(cpuHasAVX2())
+        return oscilModulatedAVX2(smps, mask, ph, offset, nvoices, tw, n);
+#endif
+    oscilModulatedBase(smps, mask, ph, offset, nvoices, tw, n);
+}
+
+void modulatorMix(const float *smps, int mask, ModulatorPhase &ph,
+                  int nvoices, float *const *tw, int n, float ampold,
+                  float ampnew, bool ring)
+{
+#if defined(ZYN_SIMD_AVX2) && defined(ZYN_SIMD_VECTOR)
+    if(cpuHasAVX2())
+        return modulatorMixAVX2(smps, mask, ph, nvoices, tw, n, ampold, ampnew,
+                                ring);
+#endif
+    modulatorMixBase(smps, mask, ph, nvoices, tw, n, ampold, ampnew, ring);
+}
+
+/*
+ * The sum hardly ever leaves (-oscilsize, oscilsize), where fmod() returns it
+ * unchanged, so the library call is only made for the rare wrap around.
+ */
+void fmIntegrate(float *tw, float &fmold, float normalize, int oscilsize,
+                 int n)
+{
+    const float size = oscilsize;
+    float sum = fmold;
+    for(int i = 0; i < n; ++i) {
+        sum = sum + tw[i] * normalize;
+        if(sum >= size || sum <= -size)
+            sum = fmod(sum, oscilsize);
+        tw[i] = sum;
+    }
+    fmold = sum;
+}
+
+void unisonMix(const float *const *in, const float *lvol, const float *rvol,
+               int nvoices, float *outl, float *outr, int n)
+{
+#ifdef ZYN_SIMD_AVX2
+    if(cpuHasAVX2())
+        return unisonMixAVX2(in, lvol, rvol, nvoices, outl, outr, n);
+#endif
+    unisonMixBase(in, lvol, rvol, nvoices, outl, outr, n);
+}
+
+}
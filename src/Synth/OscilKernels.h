@@ -0,0 +1,94 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  OscilKernels.h - Vectorized Unison Oscillator Kernels For ADnote
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <stdint.h>
+
+namespace zyn {
+
+//Number of unison voices processed together by the kernels
+#define OSCIL_LANES 8
+
+/**
+ * Phase state of a group of unison voices (one lane per voice).
+ *
+ * Positions and increments are fixed point, hi is the sample index and lo
+ * the fractional part with 24 bits of precision.
+ */
+struct UnisonPhase
+{
+    int32_t hi[OSCIL_LANES];
+    int32_t lo[OSCIL_LANES];
+    int32_t freqhi[OSCIL_LANES];
+    int32_t freqlo[OSCIL_LANES];
+};
+
+/**
+ * Phase of a group of modulators which keep the fractional part as a float
+ * (the MIX and RING_MOD paths of ADnote).
+ */
+struct ModulatorPhase
+{
+    int32_t hi[OSCIL_LANES];
+    float   lo[OSCIL_LANES];
+    int32_t freqhi[OSCIL_LANES];
+    float   freqlo[OSCIL_LANES];
+};
+
+/**
+ * Linear interpolated oscillator for up to OSCIL_LANES unison voices.
+ *
+ * Gives the same output as computing the voices one after another.
+ * @param smps oscillator with at least one extra sample at the end
+ * @param mask oscilsize - 1
+ * @param ph phase of each voice, advanced by n samples
+ * @param nvoices number of voices (lanes) in use
+ * @param out out[k][0..n) receives voice k
+ */
+void oscilLinear(const float *smps, int mask, UnisonPhase &ph, int nvoices,
+                 float *const *out, int n);
+
+/**
+ * Phase modulated version of oscilLinear().
+ *
+ * @param offset offset[k] is added to the position of voice k (PWM)
+ * @param tw on input tw[k][i] is the modulation of voice k in samples, on
+ *           output it is the oscillator
+ */
+void oscilModulated(const float *smps, int mask, UnisonPhase &ph,
+                    const int32_t *offset, int nvoices, float *const *tw,
+                    int n);
+
+/**
+ * Applies a linear interpolated modulator to the voices in tw, either
+ * crossfading to it (MIX) or ring modulating with it. The modulator
+ * amplitude goes from ampold to ampnew over n samples.
+ */
+void modulatorMix(const float *smps, int mask, ModulatorPhase &ph,
+                  int nvoices, float *const *tw, int n, float ampold,
+                  float ampnew, bool ring);
+
+/**
+ * Integrates the frequency modulation of one voice:
+ * fmold = fmod(fmold + tw[i] * normalize, oscilsize) and tw[i] = fmold
+ */
+void fmIntegrate(float *tw, float &fmold, float normalize, int oscilsize,
+                 int n);
+
+/**
+ * Mixes unison voices down to one or two channels:
+ * outl[i] += in[0][i]*lvol[0] + ... + in[nvoices-1][i]*lvol[nvoices-1]
+ * (summed in this order) and likewise for outr when it is not NULL.
+ */
+void unisonMix(const float *const *in, const float *lvol, const float *rvol,
+               int nvoices, float *outl, float *outr, int n);
+
+}
@@ -0,0 +1,266 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PADKernels.cpp - Vectorized Sample Interpolation Kernels For PADnote
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "PADKernels.h"
+#include "../Misc/Simd.h"
+#include "../Params/PADnoteParameters.h"
+#include <cstring>
+
+namespace zyn {
+
+//Output samples ahead of the current ones whose reads are prefetched
+#define PAD_PREFETCH 64
+
+/*
+ * Decoding of each PADformat, both for a single value and for PAD_LANES
+ * values at once. Decoding happens after the loads, so the 16 bit formats
+ * only move half the data.
+ */
+struct FloatFormat {
+    typedef float raw_t;
+    static float scalar(raw_t x) { return x; }
+#ifdef ZYN_SIMD_VECTOR
+    typedef vfloat8 vraw_t;
+    static ZYN_KERNEL void vector(const vfloat8 &x, vfloat8 *out) { *out = x; }
+#endif
+};
+
+struct HalfFormat {
+    typedef uint16_t raw_t;
+    static float scalar(raw_t x) { return half2float(x); }
+#ifdef ZYN_SIMD_VECTOR
+    typedef vuint8 vraw_t;
+    //half2float() for each lane
+    static ZYN_KERNEL void vector(const vuint8 &x, vfloat8 *out)
+    {
+        const vuint8  bits = (x & 0x7fffu) << 13;
+        const vfloat8 f    = (vfloat8)bits * 5.192296858534828e+33f;
+        *out = (vfloat8)((vuint8)f | ((x & 0x8000u) << 16));
+    }
+#endif
+};
+
+struct Int16Format {
+    typedef int16_t raw_t;
+    static float scalar(raw_t x) { return x * (PAD_INT16_RANGE / 32767.0f); }
+#ifdef ZYN_SIMD_VECTOR
+    typedef vint8 vraw_t;
+    static ZYN_KERNEL void vector(const vint8 &x, vfloat8 *out)
+    {
+        *out = vtofloat(x) * (PAD_INT16_RANGE / 32767.0f);
+    }
+#endif
+};
+
+/*
+ * The positions of a block of PAD_LANES output samples are stepped forward
+ * one after another, exactly like PADnote always did, as each one depends
+ * on the previous fraction. The loads, decoding and interpolation then run
+ * on all lanes at once. Unused lanes of the last block read position 0.
+ */
+#ifdef ZYN_SIMD_VECTOR
+template<class F>
+static ZYN_KERNEL void load(const typename F::raw_t *raw, const int32_t *pos,
+                            int offset, vfloat8 *out)
+{
+    static_assert(PAD_LANES == 8, "load works on vfloat8");
+    //There is no gather before AVX2, so the loads stay scalar
+    typename F::vraw_t v;
+    for(int l = 0; l < PAD_LANES; ++l)
+        v[l] = raw[pos[l] + offset];
+    F::vector(v, out);
+}
+
+template<class F, bool cubic>
+static ZYN_KERNEL void interpolate(const typename F::raw_t *raw,
+                                   const int32_t *pos, const vfloat8 &x,
+                                   vfloat8 *out)
+{
+    vfloat8 xm1, x0;
+    load<F>(raw, pos, 0, &xm1);
+    load<F>(raw, pos, 1, &x0);
+    if(!cubic) {
+        *out = xm1 * (1.0f - x) + x0 * x;
+        return;
+    }
+
+    vfloat8 x1, x2;
+    load<F>(raw, pos, 2, &x1);
+    load<F>(raw, pos, 3, &x2);
+    const vfloat8 a = (3.0f * (x0 - x1) - xm1 + x2) * 0.5f;
+    const vfloat8 b = 2.0f * x1 + xm1 - (5.0f * x0 + x2) * 0.5f;
+    const vfloat8 c = (x1 - xm1) * 0.5f;
+    *out = (((a * x) + b) * x + c) * x + x0;
+}
+
+template<class F, bool cubic>
+static ZYN_KERNEL void padBody(const float *smp, int size, PADPhase &ph,
+                               int freqhi, float freqlo, float *outl,
+                               float *outr, int n)
+{
+    const typename F::raw_t *raw = (const typename F::raw_t *)smp;
+    int32_t   hi_l  = ph.hi_l, hi_r = ph.hi_r;
+    float     lo    = ph.lo;
+    const int ahead = (int)(PAD_PREFETCH * (freqhi + freqlo));
+
+    for(int i0 = 0; i0 < n; i0 += PAD_LANES) {
+        const int m = n - i0 < PAD_LANES ? n - i0 : PAD_LANES;
+        int32_t pos_l[PAD_LANES] = {0}, pos_r[PAD_LANES] = {0};
+        vfloat8 x = {0};
+        for(int j = 0; j < m; ++j) {
+            hi_l += freqhi;
+            hi_r += freqhi;
+            lo   += freqlo;
+            if(lo >= 1.0f) {
+                hi_l += 1;
+                hi_r += 1;
+                lo   -= 1.0f;
+            }
+            if(hi_l >= size)
+                hi_l %= size;
+            if(hi_r >= size)
+                hi_r %= size;
+            pos_l[j] = hi_l;
+            pos_r[j] = hi_r;
+            x[j]     = lo;
+        }
+
+        ZYN_PREFETCH(raw + (hi_l + ahead) % size);
+        ZYN_PREFETCH(raw + (hi_r + ahead) % size);
+
+        vfloat8 l, r;
+        interpolate<F, cubic>(raw, pos_l, x, &l);
+        interpolate<F, cubic>(raw, pos_r, x, &r);
+        if(m == PAD_LANES) {
+            memcpy(outl + i0, &l, sizeof(l));
+            memcpy(outr + i0, &r, sizeof(r));
+        }
+        else
+            for(int j = 0; j < m; ++j) {
+                outl[i0 + j] = l[j];
+                outr[i0 + j] = r[j];
+            }
+    }
+
+    ph.hi_l = hi_l;
+    ph.hi_r = hi_r;
+    ph.lo   = lo;
+}
+#else
+template<class F, bool cubic>
+static ZYN_KERNEL float interpolate(const typename F::raw_t *raw, int pos,
+                                    float x)
+{
+    if(!cubic)
+        return F::scalar(raw[pos]) * (1.0f - x) + F::scalar(raw[pos + 1]) * x;
+
+    const float xm1 = F::scalar(raw[pos]);
+    const float x0  = F::scalar(raw[pos + 1]);
+    const float x1  = F::scalar(raw[pos + 2]);
+    const float x2  = F::scalar(raw[pos + 3]);
+    const float a   = (3.0f * (x0 - x1) - xm1 + x2) * 0.5f;
+    const float b   = 2.0f * x1 + xm1 - (5.0f * x0 + x2) * 0.5f;
+    const float c   = (x1 - xm1) * 0.5f;
+    return (((a * x) + b) * x + c) * x + x0;
+}
+
+template<class F, bool cubic>
+static ZYN_KERNEL void padBody(const float *smp, int size, PADPhase &ph,
+                               int freqhi, float freqlo, float *outl,
+                               float *outr, int n)
+{
+    const typename F::raw_t *raw = (const typename F::raw_t *)smp;
+    int32_t   hi_l  = ph.hi_l, hi_r = ph.hi_r;
+    float     lo    = ph.lo;
+    const int ahead = (int)(PAD_PREFETCH * (freqhi + freqlo));
+
+    for(int i = 0; i < n; ++i) {
+        hi_l += freqhi;
+        hi_r += freqhi;
+        lo   += freqlo;
+        if(lo >= 1.0f) {
+            hi_l += 1;
+            hi_r += 1;
+            lo   -= 1.0f;
+        }
+        if(hi_l >= size)
+            hi_l %= size;
+        if(hi_r >= size)
+            hi_r %= size;
+
+        if(i % PAD_LANES == 0) {
+            ZYN_PREFETCH(raw + (hi_l + ahead) % size);
+            ZYN_PREFETCH(raw + (hi_r + ahead) % size);
+        }
+
+        outl[i] = interpolate<F, cubic>(raw, hi_l, lo);
+        outr[i] = interpolate<F, cubic>(raw, hi_r, lo);
+    }
+
+    ph.hi_l = hi_l;
+    ph.hi_r = hi_r;
+    ph.lo   = lo;
+}
+#endif
+
+template<bool cubic>
+static ZYN_KERNEL void padFormat(const float *smp, int format, int size,
+                                 PADPhase &ph, int freqhi, float freqlo,
+                                 float *outl, float *outr, int n)
+{
+    if(format == PAD_HALF)
+        padBody<HalfFormat, cubic>(smp, size, ph, freqhi, freqlo,
+                                   outl, outr, n);
+    else if(format == PAD_INT16)
+        padBody<Int16Format, cubic>(smp, size, ph, freqhi, freqlo,
+                                    outl, outr, n);
+    else
+        padBody<FloatFormat, cubic>(smp, size, ph, freqhi, freqlo,
+                                    outl, outr, n);
+}
+
+static void padInterpolateBase(const float *smp, int format, int size,
+                               PADPhase &ph, int freqhi, float freqlo,
+                               bool cubic, float *outl, float *outr, int n)
+{
+    if(cubic)
+        padFormat<true>(smp, format, size, ph, freqhi, freqlo, outl, outr, n);
+    else
+        padFormat<false>(smp, format, size, ph, freqhi, freqlo, outl, outr, n);
+}
+
+#ifdef ZYN_SIMD_AVX2
+ZYN_TARGET_AVX2
+static void padInterpolateAVX2(const float *smp, int format, int size,
+                               PADPhase &ph, int freqhi, float freqlo,
+                               bool cubic, float *outl, float *outr, int n)
+{
+    if(cubic)
+        padFormat<true>(smp, format, size, ph, freqhi, freqlo, outl, outr, n);
+    else
+        padFormat<false>(smp, format, size, ph, freqhi, freqlo, outl, outr, n);
+}
+#endif
+
+void padInterpolate(const float *smp, int format, int size, PADPhase &ph,
+                    int freqhi, float freqlo, bool cubic, float *outl,
+                    float *outr, int n)
+{
+#ifdef ZYN_SIMD_AVX2
+    if(cpuHasAVX2())
+        return padInterpolateAVX2(smp, format, size, ph, freqhi, freqlo,
+                                  cubic, outl, outr, n);
+#endif
+    padInterpolateBase(smp, format, size, ph, freqhi, freqlo, cubic,
+                       outl, outr, n);
+}
+
+}
@@ -0,0 +1,46 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PADKernels.h - Vectorized Sample Interpolation Kernels For PADnote
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <stdint.h>
+
+namespace zyn {
+
+//Output samples computed per iteration of the kernels
+#define PAD_LANES 8
+
+/**
+ * Playback position of both channels of a PADnote.
+ *
+ * hi is the sample index of each channel and lo the fraction they share.
+ */
+struct PADPhase
+{
+    int32_t hi_l, hi_r;
+    float   lo;
+};
+
+/**
+ * Interpolated playback of a PADsynth sample for both channels.
+ *
+ * Gives the same output as advancing the position and interpolating one
+ * output sample at a time.
+ * @param smp sample data in the given PADformat, followed by the extra
+ *            samples for the interpolation (see PADnoteParameters::Sample)
+ * @param size number of samples without the extra ones
+ * @param ph position, advanced by n samples of freqhi + freqlo each
+ * @param cubic cubic instead of linear interpolation
+ */
+void padInterpolate(const float *smp, int format, int size, PADPhase &ph,
+                    int freqhi, float freqlo, bool cubic, float *outl,
+                    float *outr, int n);
+
+}
@@ -13,6 +13,7 @@
 #include <cassert>
 #include <cmath>
 #include "PADnote.h"
+#include "PADKernels.h"
 #include "ModFilter.h"
 #include "../Misc/Config.h"
 #include "../Misc/Allocator.h"
@@ -81,7 +82,10 @@ void PADnote::setup(float freq,
 
 
     //find out the closest note
-    float logfreq = logf(basefreq * powf(2.0f, NoteGlobalPar.Detune / 1200.0f));
+    const float notefreq = basefreq * powf(2.0f, NoteGlobalPar.Detune / 1200.0f);
+    float logfreq = logf(notefreq);
+    if(pars.Plazy)
+        pars.markplayed(notefreq);
     float mindist = fabs(logfreq - logf(pars.sample[0].basefreq + 0.0001f));
     nsample = 0;
     for(int i = 1; i < PAD_MAX_SAMPLES; ++i) {
@@ -101,7 +105,7 @@ void PADnote::setup(float freq,
 
 
     if(!legato) { //not sure
-        poshi_l = (int)(RND * (size - 1));
+        poshi_l = (int)(rng.rnd() * (size - 1));
         if(pars.PStereo)
             poshi_r = (poshi_l + size / 2) % size;
         else
@@ -111,7 +115,7 @@ void PADnote::setup(float freq,
 
 
     if(pars.PPanning == 0)
-        NoteGlobalPar.Panning = RND;
+        NoteGlobalPar.Panning = rng.rnd();
     else
         NoteGlobalPar.Panning = pars.PPanning / 128.0f;
 
@@ -142,14 +146,14 @@ void PADnote::setup(float freq,
                     wm, (pre+"FreqEnvelope/").c_str);
         NoteGlobalPar.FreqLfo      =
             memory.alloc<LFO>(*pars.FreqLfo, basefreq, time,
-                    wm, (pre+"FreqLfo/").c_str);
+                    wm, (pre+"FreqLfo/").c_str, &rng);
 
         NoteGlobalPar.AmpEnvelope =
             memory.alloc<Envelope>(*pars.AmpEnvelope, basefreq, synth.dt(),
                     wm, (pre+"AmpEnvelope/").c_str);
         NoteGlobalPar.AmpLfo      =
             memory.alloc<LFO>(*pars.AmpLfo, basefreq, time,
-                    wm, (pre+"AmpLfo/").c_str);
+                    wm, (pre+"AmpLfo/").c_str, &rng);
     }
 
     NoteGlobalPar.Volume = 4.0f
@@ -174,7 +178,7 @@ void PADnote::setup(float freq,
         env = memory.alloc<Envelope>(*pars.FilterEnvelope, basefreq,
                 synth.dt(), wm, (pre+"FilterEnvelope/").c_str);
         lfo = memory.alloc<LFO>(*pars.FilterLfo, basefreq, time,
-                wm, (pre+"FilterLfo/").c_str);
+                wm, (pre+"FilterLfo/").c_str, &rng);
         flt->addMod(*env);
         flt->addMod(*lfo);
     }
@@ -194,9 +198,9 @@ void PADnote::setup(float freq,
 
 SynthNote *PADnote::cloneLegato(void)
 {
-    SynthParams sp{memory, ctl, synth, time, legato.param.freq, velocity, 
-                   (bool)portamento, legato.param.midinote, true};
-    return memory.alloc<PADnote>(&pars, sp, interpolation);
+    SynthParams sp{parentMemory(), ctl, synth, time, legato.param.freq, velocity, 
+                   (bool)portamento, legato.param.midinote, true, &rng};
+    return create<PADnote>(&pars, sp, interpolation);
 }
 
 void PADnote::legatonote(LegatoParams pars)
@@ -276,77 +280,31 @@ int PADnote::Compute_Linear(float *outl,
                             int freqhi,
                             float freqlo)
 {
-    float *smps = pars.sample[nsample].smp;
-    if(smps == NULL) {
-        finished_ = true;
-        return 1;
-    }
-    int size = pars.sample[nsample].size;
-    for(int i = 0; i < synth.buffersize; ++i) {
-        poshi_l += freqhi;
-        poshi_r += freqhi;
-        poslo   += freqlo;
-        if(poslo >= 1.0f) {
-            poshi_l += 1;
-            poshi_r += 1;
-            poslo   -= 1.0f;
-        }
-        if(poshi_l >= size)
-            poshi_l %= size;
-        if(poshi_r >= size)
-            poshi_r %= size;
-
-        outl[i] = smps[poshi_l] * (1.0f - poslo) + smps[poshi_l + 1] * poslo;
-        outr[i] = smps[poshi_r] * (1.0f - poslo) + smps[poshi_r + 1] * poslo;
-    }
-    return 1;
+    return interpolate(outl, outr, freqhi, freqlo, false);
 }
+
 int PADnote::Compute_Cubic(float *outl,
                            float *outr,
                            int freqhi,
                            float freqlo)
 {
-    float *smps = pars.sample[nsample].smp;
-    if(smps == NULL) {
+    return interpolate(outl, outr, freqhi, freqlo, true);
+}
+
+int PADnote::interpolate(float *outl, float *outr, int freqhi, float freqlo,
+                         bool cubic)
+{
+    const PADnoteParameters::Sample &s = pars.sample[nsample];
+    if(s.smp == NULL) {
         finished_ = true;
         return 1;
     }
-    int   size = pars.sample[nsample].size;
-    float xm1, x0, x1, x2, a, b, c;
-    for(int i = 0; i < synth.buffersize; ++i) {
-        poshi_l += freqhi;
-        poshi_r += freqhi;
-        poslo   += freqlo;
-        if(poslo >= 1.0f) {
-            poshi_l += 1;
-            poshi_r += 1;
-            poslo   -= 1.0f;
-        }
-        if(poshi_l >= size)
-            poshi_l %= size;
-        if(poshi_r >= size)
-            poshi_r %= size;
-
-
-        //left
-        xm1     = smps[poshi_l];
-        x0      = smps[poshi_l + 1];
-        x1      = smps[poshi_l + 2];
-        x2      = smps[poshi_l + 3];
-        a       = (3.0f * (x0 - x1) - xm1 + x2) * 0.5f;
-        b       = 2.0f * x1 + xm1 - (5.0f * x0 + x2) * 0.5f;
-        c       = (x1 - xm1) * 0.5f;
-        outl[i] = (((a * poslo) + b) * poslo + c) * poslo + x0;
-        //right
-        xm1     = smps[poshi_r];
-        x0      = smps[poshi_r + 1];
-        x1      = smps[poshi_r + 2];
-        x2      = smps[poshi_r + 3];
-        a       = (3.0f * (x0 - x1) - xm1 + x2) * 0.5f;
-        b       = 2.0f * x1 + xm1 - (5.0f * x0 + x2) * 0.5f;
-        c       = (x1 - xm1) * 0.5f;
-        outr[i] = (((a * poslo) + b) * poslo + c) * poslo + x0;
-    }
+    PADPhase ph = {poshi_l, poshi_r, poslo};
+    padInterpolate(s.smp, s.format, s.size, ph, freqhi, freqlo, cubic,
+                   outl, outr, synth.buffersize);
+    poshi_l = ph.hi_l;
+    poshi_r = ph.hi_r;
+    poslo   = ph.lo;
     return 1;
 }
 
@@ -62,6 +62,12 @@ class PADnote:public SynthNote
                           float *outr,
                           int freqhi,
                           float freqlo);
+        //Both of the above (see padInterpolate())
+        int interpolate(float *outl,
+                        float *outr,
+                        int freqhi,
+                        float freqlo,
+                        bool cubic);
 
 
         struct {
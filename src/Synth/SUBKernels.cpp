@@ -0,0 +1,138 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  SUBKernels.cpp - Vectorized Band Pass Filter Banks For SUBnote
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include "SUBKernels.h"
+#include "../Misc/Simd.h"
+
+namespace zyn {
+
+/*
+ * Every stage runs over a block of B samples for all lanes at once. The
+ * feedback of a stage makes each sample wait for the previous one, so G banks
+ * are filtered side by side to have independent work in between.
+ *
+ * The weighted lanes of all banks are accumulated per sample and only summed
+ * horizontally once per sample at the end.
+ *
+ * Ramping coefficients are constant within the block (see SUBBank::ramp).
+ */
+template<int B, int G>
+static ZYN_KERNEL void subFilterGroup(SUBBank *bank, int nstages,
+                                      const float *in, float acc[][SUB_LANES],
+                                      int m)
+{
+    const int L = SUB_LANES;
+    float v[B][G][L];
+    for(int j = 0; j < m; ++j)
+        for(int g = 0; g < G; ++g)
+            for(int l = 0; l < L; ++l)
+                v[j][g][l] = in[j];
+
+    for(int s = 0; s < nstages; ++s) {
+        float b0[G][L], b2[G][L], a1[G][L], a2[G][L];
+        float x1[G][L], x2[G][L], y1[G][L], y2[G][L];
+        for(int g = 0; g < G; ++g) {
+            const float r = bank[g].ramp > 0 ? bank[g].ramp - 1 : 0;
+            for(int l = 0; l < L; ++l) {
+                b0[g][l] = bank[g].b0[s][l] - bank[g].db0[s][l] * r;
+                b2[g][l] = bank[g].b2[s][l] - bank[g].db2[s][l] * r;
+                a1[g][l] = bank[g].da1[s][l] * r - bank[g].a1[s][l];
+                a2[g][l] = bank[g].da2[s][l] * r - bank[g].a2[s][l];
+                x1[g][l] = bank[g].x1[s][l];
+                x2[g][l] = bank[g].x2[s][l];
+                y1[g][l] = bank[g].y1[s][l];
+                y2[g][l] = bank[g].y2[s][l];
+            }
+        }
+        for(int j = 0; j < m; ++j)
+            for(int g = 0; g < G; ++g)
+                for(int l = 0; l < L; ++l) {
+                    const float x = v[j][g][l];
+                    const float y = x * b0[g][l] + x2[g][l] * b2[g][l]
+                                    + y1[g][l] * a1[g][l] + y2[g][l] * a2[g][l];
+                    x2[g][l]   = x1[g][l];
+                    x1[g][l]   = x;
+                    y2[g][l]   = y1[g][l];
+                    y1[g][l]   = y;
+                    v[j][g][l] = y;
+                }
+        for(int g = 0; g < G; ++g)
+            for(int l = 0; l < L; ++l) {
+                bank[g].x1[s][l] = x1[g][l];
+                bank[g].x2[s][l] = x2[g][l];
+                bank[g].y1[s][l] = y1[g][l];
+                bank[g].y2[s][l] = y2[g][l];
+            }
+    }
+
+    for(int j = 0; j < m; ++j)
+        for(int g = 0; g < G; ++g)
+            for(int l = 0; l < L; ++l)
+                acc[j][l] += v[j][g][l] * bank[g].gain[l];
+
+    for(int g = 0; g < G; ++g)
+        if(bank[g].ramp > 0)
+            --bank[g].ramp;
+}
+
+template<int B>
+static ZYN_KERNEL void subFilterBody(SUBBank *banks, int nbanks, int nstages,
+                                     const float *in, float *out, int n)
+{
+    const int L = SUB_LANES;
+    for(int i0 = 0; i0 < n; i0 += B) {
+        const int m = n - i0 < B ? n - i0 : B;
+        float acc[B][L];
+        for(int j = 0; j < m; ++j)
+            for(int l = 0; l < L; ++l)
+                acc[j][l] = 0.0f;
+
+        int k = 0;
+        for(; k + 2 <= nbanks; k += 2)
+            subFilterGroup<B, 2>(banks + k, nstages, in + i0, acc, m);
+        if(k < nbanks)
+            subFilterGroup<B, 1>(banks + k, nstages, in + i0, acc, m);
+
+        for(int j = 0; j < m; ++j) {
+            float sum = 0.0f;
+            for(int l = 0; l < L; ++l)
+                sum += acc[j][l];
+            out[i0 + j] += sum;
+        }
+    }
+}
+
+static void subFilterBanksBase(SUBBank *banks, int nbanks, int nstages,
+                               const float *in, float *out, int n)
+{
+    subFilterBody<SUB_BLOCK>(banks, nbanks, nstages, in, out, n);
+}
+
+#ifdef ZYN_SIMD_AVX2
+ZYN_TARGET_AVX2
+static void subFilterBanksAVX2(SUBBank *banks, int nbanks, int nstages,
+                               const float *in, float *out, int n)
+{
+    subFilterBody<SUB_BLOCK>(banks, nbanks, nstages, in, out, n);
+}
+#endif
+
+void subFilterBanks(SUBBank *banks, int nbanks, int nstages, const float *in,
+                    float *out, int n)
+{
+#ifdef ZYN_SIMD_AVX2
+    if(cpuHasAVX2())
+        return subFilterBanksAVX2(banks, nbanks, nstages, in, out, n);
+#endif
+    subFilterBanksBase(banks, nbanks, nstages, in, out, n);
+}
+
+}
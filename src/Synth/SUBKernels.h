@@ -0,0 +1,89 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  SUBKernels.h - Vectorized Band Pass Filter Banks For SUBnote
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+
+namespace zyn {
+
+//Harmonics filtered together by the kernels
+#define SUB_LANES 8
+//Most filter stages per harmonic (SUBnoteParameters::Pnumstages)
+#define SUB_MAX_STAGES 5
+//Samples filtered per stage before moving to the next one; the
+//coefficients are stepped once per such sub-block
+#define SUB_BLOCK 32
+
+/**
+ * Band pass filters of SUB_LANES harmonics with all their stages (one lane
+ * per harmonic).
+ *
+ * Each stage computes y = b0*x + b2*x2 - a1*y1 - a2*y2 (b1 is zero).
+ * A value initialized bank has all lanes silent.
+ *
+ * While ramp is positive the coefficients are on their way to b0, b2, a1, a2:
+ * a sub-block uses b0 - db0*(ramp - 1) (likewise the others) and ramp is
+ * decremented after it.
+ */
+struct SUBBank
+{
+    //coefficients
+    float b0[SUB_MAX_STAGES][SUB_LANES], b2[SUB_MAX_STAGES][SUB_LANES];
+    float a1[SUB_MAX_STAGES][SUB_LANES], a2[SUB_MAX_STAGES][SUB_LANES];
+    //steps of the coefficients per sub-block
+    float db0[SUB_MAX_STAGES][SUB_LANES], db2[SUB_MAX_STAGES][SUB_LANES];
+    float da1[SUB_MAX_STAGES][SUB_LANES], da2[SUB_MAX_STAGES][SUB_LANES];
+    //input and output history
+    float x1[SUB_MAX_STAGES][SUB_LANES], x2[SUB_MAX_STAGES][SUB_LANES];
+    float y1[SUB_MAX_STAGES][SUB_LANES], y2[SUB_MAX_STAGES][SUB_LANES];
+    //weight of each harmonic in the output
+    float gain[SUB_LANES];
+    //sub-blocks left until the coefficients are reached
+    int ramp;
+};
+
+/**
+ * Starts a ramp of steps sub-blocks from the coefficients the bank is at to
+ * the ones computed by set, which writes the targets into b0, b2, a1, a2.
+ * With steps = 0 the bank jumps to the targets.
+ */
+template<class F>
+void subRampBank(SUBBank &bank, int nstages, int steps, F set)
+{
+    const float r = bank.ramp;
+    float (*c[4])[SUB_LANES] = {bank.b0, bank.b2, bank.a1, bank.a2};
+    float (*d[4])[SUB_LANES] = {bank.db0, bank.db2, bank.da1, bank.da2};
+    //keep the coefficients of the last sub-block in the steps
+    for(int k = 0; k < 4; ++k)
+        for(int s = 0; s < nstages; ++s)
+            for(int l = 0; l < SUB_LANES; ++l)
+                d[k][s][l] = c[k][s][l] - d[k][s][l] * r;
+    set();
+    bank.ramp = steps;
+    if(!steps)
+        return;
+    const float inv = 1.0f / steps;
+    for(int k = 0; k < 4; ++k)
+        for(int s = 0; s < nstages; ++s)
+            for(int l = 0; l < SUB_LANES; ++l)
+                d[k][s][l] = (c[k][s][l] - d[k][s][l]) * inv;
+}
+
+/**
+ * Filters in through the stage cascade of every lane of the banks and adds
+ * the gain weighted sum of all lanes to out.
+ *
+ * Each lane gives the same output as the scalar filter of SUBnote, only the
+ * order the harmonics are summed in differs.
+ */
+void subFilterBanks(SUBBank *banks, int nbanks, int nstages, const float *in,
+                    float *out, int n);
+
+}
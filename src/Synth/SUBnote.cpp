@@ -11,6 +11,7 @@
   of the License, or (at your option) any later version.
 */
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <cstdio>
@@ -43,7 +44,9 @@ SUBnote::SUBnote(const SUBnoteParameters *parameters, SynthParams &spars, WatchM
     GlobalFilter(nullptr),
     GlobalFilterEnvelope(nullptr),
     NoteEnabled(true),
-    lfilter(nullptr), rfilter(nullptr)
+    lfilter(nullptr), rfilter(nullptr),
+    lbank(nullptr), rbank(nullptr), numbanks(0),
+    ctlcounter(0), ctlenvfreq(0.0f), ctlenvbw(0.0f)
 {
     setup(spars.frequency, spars.velocity, spars.portamento, spars.note, false, wm, prefix);
 }
@@ -73,17 +76,29 @@ float SUBnote::setupFilters(int *pos, bool automation)
             float amp = 1.0f;
             if(nph == 0)
                 amp = gain;
-            initfilter(lfilter[nph + n * numstages], freq + OffsetHz, bw,
-                       amp, hgain, automation);
+            initfilter(lfilter[nph + n * numstages], lbank[n / SUB_LANES],
+                       n % SUB_LANES, nph, freq + OffsetHz, bw, amp, hgain,
+                       automation);
             if(stereo)
-                initfilter(rfilter[nph + n * numstages], freq + OffsetHz, bw,
-                           amp, hgain, automation);
+                initfilter(rfilter[nph + n * numstages], rbank[n / SUB_LANES],
+                           n % SUB_LANES, nph, freq + OffsetHz, bw, amp, hgain,
+                           automation);
         }
     }
 
     if(reduceamp < 0.001f)
         reduceamp = 1.0f;
 
+    //the filters are not ramped from their old coefficients, and the next
+    //tick computes the complete ones
+    for(int k = 0; k < numbanks; ++k) {
+        lbank[k].ramp = 0;
+        if(stereo)
+            rbank[k].ramp = 0;
+    }
+    ctlcounter = 0;
+    ctlenvfreq = ctlenvbw = 0.0f;
+
     return reduceamp;
 }
 
@@ -103,7 +118,7 @@ void SUBnote::setup(float freq,
     if(pars.PPanning != 0)
         panning = pars.PPanning / 127.0f;
     else
-        panning = RND;
+        panning = rng.rnd();
 
     if(!legato) { //normal note
         numstages = pars.Pnumstages;
@@ -161,11 +176,8 @@ void SUBnote::setup(float freq,
     }
 
 
-    if(!legato) { //normal note
-        lfilter = memory.valloc<bpfilter>(numstages * numharmonics);
-        if(stereo)
-            rfilter = memory.valloc<bpfilter>(numstages * numharmonics);
-    }
+    if(!legato) //normal note
+        allocfilters();
 
     //how much the amplitude is normalised (because the harmonics)
     float reduceamp = setupFilters(pos, false);
@@ -196,9 +208,9 @@ void SUBnote::setup(float freq,
 
 SynthNote *SUBnote::cloneLegato(void)
 {
-    SynthParams sp{memory, ctl, synth, time, legato.param.freq, velocity,
-                   portamento, legato.param.midinote, true};
-    return memory.alloc<SUBnote>(&pars, sp);
+    SynthParams sp{parentMemory(), ctl, synth, time, legato.param.freq, velocity,
+                   portamento, legato.param.midinote, true, &rng};
+    return create<SUBnote>(&pars, sp);
 }
 
 void SUBnote::legatonote(LegatoParams pars)
@@ -227,9 +239,7 @@ SUBnote::~SUBnote()
 void SUBnote::KillNote()
 {
     if(NoteEnabled) {
-        memory.devalloc(numstages * numharmonics, lfilter);
-        if(stereo)
-            memory.devalloc(numstages * numharmonics, rfilter);
+        freefilters();
         memory.dealloc(AmpEnvelope);
         memory.dealloc(FreqEnvelope);
         memory.dealloc(BandWidthEnvelope);
@@ -240,10 +250,36 @@ void SUBnote::KillNote()
 }
 
 
+/*
+ * Allocate the filters of all harmonics
+ */
+void SUBnote::allocfilters(void)
+{
+    numbanks = (numharmonics + SUB_LANES - 1) / SUB_LANES;
+    //banks are value initialized, so the lanes without a harmonic are silent
+    lfilter = memory.valloc<bpfilter>(numstages * numharmonics);
+    lbank   = memory.valloc<SUBBank>(numbanks);
+    if(stereo) {
+        rfilter = memory.valloc<bpfilter>(numstages * numharmonics);
+        rbank   = memory.valloc<SUBBank>(numbanks);
+    }
+}
+
+void SUBnote::freefilters(void)
+{
+    memory.devalloc(lfilter);
+    memory.devalloc(rfilter);
+    memory.devalloc(lbank);
+    memory.devalloc(rbank);
+}
+
 /*
  * Compute the filters coefficients
  */
-void SUBnote::computefiltercoefs(bpfilter &filter,
+void SUBnote::computefiltercoefs(const bpfilter &filter,
+                                 SUBBank &bank,
+                                 int lane,
+                                 int stage,
                                  float freq,
                                  float bw,
                                  float gain)
@@ -262,10 +298,10 @@ void SUBnote::computefiltercoefs(bpfilter &filter,
     if(alpha > bw)
         alpha = bw;
 
-    filter.b0 = alpha / (1.0f + alpha) * filter.amp * gain;
-    filter.b2 = -alpha / (1.0f + alpha) * filter.amp * gain;
-    filter.a1 = -2.0f * cs / (1.0f + alpha);
-    filter.a2 = (1.0f - alpha) / (1.0f + alpha);
+    bank.b0[stage][lane] = alpha / (1.0f + alpha) * filter.amp * gain;
+    bank.b2[stage][lane] = -alpha / (1.0f + alpha) * filter.amp * gain;
+    bank.a1[stage][lane] = -2.0f * cs / (1.0f + alpha);
+    bank.a2[stage][lane] = (1.0f - alpha) / (1.0f + alpha);
 }
 
 
@@ -273,6 +309,9 @@ void SUBnote::computefiltercoefs(bpfilter &filter,
  * Initialise the filters
  */
 void SUBnote::initfilter(bpfilter &filter,
+                         SUBBank &bank,
+                         int lane,
+                         int stage,
                          float freq,
                          float bw,
                          float amp,
@@ -280,26 +319,27 @@ void SUBnote::initfilter(bpfilter &filter,
                          bool automation)
 {
     if(!automation) {
-        filter.xn1 = 0.0f;
-        filter.xn2 = 0.0f;
+        bank.x1[stage][lane] = 0.0f;
+        bank.x2[stage][lane] = 0.0f;
 
         if(start == 0) {
-            filter.yn1 = 0.0f;
-            filter.yn2 = 0.0f;
+            bank.y1[stage][lane] = 0.0f;
+            bank.y2[stage][lane] = 0.0f;
         }
         else {
             float a = 0.1f * mag; //empirically
-            float p = RND * 2.0f * PI;
+            float p = rng.rnd() * 2.0f * PI;
             if(start == 1)
-                a *= RND;
-            filter.yn1 = a * cosf(p);
-            filter.yn2 = a * cosf(p + freq * 2.0f * PI / synth.samplerate_f);
+                a *= rng.rnd();
+            bank.y1[stage][lane] = a * cosf(p);
+            bank.y2[stage][lane] = a * cosf(p + freq * 2.0f * PI
+                                            / synth.samplerate_f);
 
             //correct the error of computation the start amplitude
             //at very high frequencies
             if(freq > synth.samplerate_f * 0.96f) {
-                filter.yn1 = 0.0f;
-                filter.yn2 = 0.0f;
+                bank.y1[stage][lane] = 0.0f;
+                bank.y2[stage][lane] = 0.0f;
             }
         }
     }
@@ -307,49 +347,7 @@ void SUBnote::initfilter(bpfilter &filter,
     filter.amp  = amp;
     filter.freq = freq;
     filter.bw   = bw;
-    computefiltercoefs(filter, freq, bw, 1.0f);
-}
-
-/*
- * Do the filtering
- */
-
-inline void SubFilterA(const float coeff[4], float &src, float work[4])
-{
-    work[3] = src*coeff[0]+work[1]*coeff[1]+work[2]*coeff[2]+work[3]*coeff[3];
-    work[1] = src;
-    src     = work[3];
-}
-
-inline void SubFilterB(const float coeff[4], float &src, float work[4])
-{
-    work[2] = src*coeff[0]+work[0]*coeff[1]+work[3]*coeff[2]+work[2]*coeff[3];
-    work[0] = src;
-    src     = work[2];
-}
-
-//This dance is designed to minimize unneeded memory operations which can result
-//in quite a bit of wasted time
-void SUBnote::filter(bpfilter &filter, float *smps)
-{
-    assert(synth.buffersize % 8 == 0);
-    float coeff[4] = {filter.b0, filter.b2,  -filter.a1, -filter.a2};
-    float work[4]  = {filter.xn1, filter.xn2, filter.yn1, filter.yn2};
-
-    for(int i = 0; i < synth.buffersize; i += 8) {
-        SubFilterA(coeff, smps[i + 0], work);
-        SubFilterB(coeff, smps[i + 1], work);
-        SubFilterA(coeff, smps[i + 2], work);
-        SubFilterB(coeff, smps[i + 3], work);
-        SubFilterA(coeff, smps[i + 4], work);
-        SubFilterB(coeff, smps[i + 5], work);
-        SubFilterA(coeff, smps[i + 6], work);
-        SubFilterB(coeff, smps[i + 7], work);
-    }
-    filter.xn1 = work[0];
-    filter.xn2 = work[1];
-    filter.yn1 = work[2];
-    filter.yn2 = work[3];
+    computefiltercoefs(filter, bank, lane, stage, freq, bw, 1.0f);
 }
 
 /*
@@ -420,13 +418,9 @@ void SUBnote::computecurrentparameters()
 
         bool delta_harmonics = (harmonics != numharmonics);
         if(delta_harmonics) {
-            memory.devalloc(lfilter);
-            memory.devalloc(rfilter);
-
+            freefilters();
             firstnumharmonics = numharmonics = harmonics;
-            lfilter = memory.valloc<bpfilter>(numstages * numharmonics);
-            if(stereo)
-                rfilter = memory.valloc<bpfilter>(numstages * numharmonics);
+            allocfilters();
         }
 
         float reduceamp = setupFilters(pos, !delta_harmonics);
@@ -434,10 +428,16 @@ void SUBnote::computecurrentparameters()
         oldreduceamp = reduceamp;
     }
 
+    //The coefficients are computed every Pctlrate buffers (and ramped to in
+    //between, see subRampBank()); nothing is recomputed while the envelopes
+    //and controllers stay put, as on a sustain plateau
+    if(ctlcounter > 0)
+        --ctlcounter;
+
     if(FreqEnvelope || BandWidthEnvelope
        || (oldpitchwheel != ctl.pitchwheel.data)
        || (oldbandwidth != ctl.bandwidth.data)
-       || portamento) {
+       || portamento || !ctlenvfreq) {
         float envfreq = 1.0f;
         float envbw   = 1.0f;
 
@@ -450,11 +450,8 @@ void SUBnote::computecurrentparameters()
             powf(ctl.pitchwheel.relfreq, BendAdjust); //pitch wheel
 
         //Update frequency while portamento is converging
-        if(portamento) {
+        if(portamento)
             envfreq *= ctl.portamento.freqrap;
-            if(!ctl.portamento.used) //the portamento has finished
-                portamento = false;
-        }
 
         if(BandWidthEnvelope) {
             envbw = BandWidthEnvelope->envout();
@@ -463,21 +460,35 @@ void SUBnote::computecurrentparameters()
 
         envbw *= ctl.bandwidth.relbw; //bandwidth controller
 
+        if(!ctlcounter) {
+            if(portamento && !ctl.portamento.used) //the portamento has finished
+                portamento = false;
+            oldbandwidth  = ctl.bandwidth.data;
+            oldpitchwheel = ctl.pitchwheel.data;
+        }
 
-        //Recompute High Frequency Dampening Terms
-        for(int n = 0; n < numharmonics; ++n)
-            overtone_rolloff[n] = computerolloff(overtone_freq[n] * envfreq);
-
-
-        //Recompute Filter Coefficients
-        float tmpgain = 1.0f / sqrt(envbw * envfreq);
-        computeallfiltercoefs(lfilter, envfreq, envbw, tmpgain);
-        if(stereo)
-            computeallfiltercoefs(rfilter, envfreq, envbw, tmpgain);
-
-
-        oldbandwidth  = ctl.bandwidth.data;
-        oldpitchwheel = ctl.pitchwheel.data;
+        if(!ctlcounter && (envfreq != ctlenvfreq || envbw != ctlenvbw)) {
+            //Updated every buffer the coefficients step as they always did;
+            //neither is the first computation after setupFilters() ramped
+            const int steps = ctlenvfreq && pars.Pctlrate > 1 ? pars.Pctlrate
+                * ((synth.buffersize + SUB_BLOCK - 1) / SUB_BLOCK) : 0;
+            ctlcounter = pars.Pctlrate;
+            ctlenvfreq = envfreq;
+            ctlenvbw   = envbw;
+
+            //Recompute High Frequency Dampening Terms
+            for(int n = 0; n < numharmonics; ++n)
+                overtone_rolloff[n] =
+                    computerolloff(overtone_freq[n] * envfreq);
+
+            //Recompute Filter Coefficients
+            float tmpgain = 1.0f / sqrt(envbw * envfreq);
+            computeallfiltercoefs(lfilter, lbank, envfreq, envbw, tmpgain,
+                                  steps);
+            if(stereo)
+                computeallfiltercoefs(rfilter, rbank, envfreq, envbw,
+                                      tmpgain, steps);
+        }
     }
     newamplitude = volume * AmpEnvelope->envout_dB() * 2.0f;
 
@@ -487,38 +498,39 @@ void SUBnote::computecurrentparameters()
                              ctl.filterq.relq);
 }
 
-void SUBnote::computeallfiltercoefs(bpfilter *filters, float envfreq,
-        float envbw, float gain)
+void SUBnote::computeallfiltercoefs(bpfilter *filters, SUBBank *banks,
+        float envfreq, float envbw, float gain, int steps)
 {
-    for(int n = 0; n < numharmonics; ++n)
-        for(int nph = 0; nph < numstages; ++nph)
-            computefiltercoefs(filters[nph + n * numstages],
-                    filters[nph + n * numstages].freq * envfreq,
-                    filters[nph + n * numstages].bw * envbw,
-                    nph == 0 ? gain : 1.0);
+    for(int k = 0; k < numbanks; ++k) {
+        const int last = std::min(numharmonics, (k + 1) * SUB_LANES);
+        subRampBank(banks[k], numstages, steps, [&]() {
+            for(int n = k * SUB_LANES; n < last; ++n)
+                for(int nph = 0; nph < numstages; ++nph)
+                    computefiltercoefs(filters[nph + n * numstages],
+                            banks[k], n % SUB_LANES, nph,
+                            filters[nph + n * numstages].freq * envfreq,
+                            filters[nph + n * numstages].bw * envbw,
+                            nph == 0 ? gain : 1.0);
+        });
+    }
 }
 
-void SUBnote::chanOutput(float *out, bpfilter *bp, int buffer_size)
+void SUBnote::chanOutput(float *out, SUBBank *banks, int buffer_size)
 {
     float tmprnd[buffer_size];
-    float tmpsmp[buffer_size];
 
     //Initialize Random Input
-    for(int i = 0; i < buffer_size; ++i)
-        tmprnd[i] = RND * 2.0f - 1.0f;
+    rng.white(tmprnd, buffer_size);
 
-    //For each harmonic apply the filter on the random input stream
-    //Sum the filter outputs to obtain the output signal
-    for(int n = 0; n < numharmonics; ++n) {
-        float rolloff = overtone_rolloff[n];
-        memcpy(tmpsmp, tmprnd, synth.bufferbytes);
-
-        for(int nph = 0; nph < numstages; ++nph)
-            filter(bp[nph + n * numstages], tmpsmp);
+    //Harmonics dropped by a legato note stay in their lanes, but silent
+    for(int n = 0; n < numbanks * SUB_LANES; ++n)
+        banks[n / SUB_LANES].gain[n % SUB_LANES] =
+            n < numharmonics ? overtone_rolloff[n] : 0.0f;
 
-        for(int i = 0; i < synth.buffersize; ++i)
-            out[i] += tmpsmp[i] * rolloff;
-    }
+    //Apply the filters of each harmonic on the random input stream and sum
+    //the filter outputs to obtain the output signal
+    subFilterBanks(banks, (numharmonics + SUB_LANES - 1) / SUB_LANES,
+                   numstages, tmprnd, out, buffer_size);
 }
 
 /*
@@ -533,14 +545,14 @@ int SUBnote::noteout(float *outl, float *outr)
         return 0;
 
     if(stereo) {
-        chanOutput(outl, lfilter, synth.buffersize);
-        chanOutput(outr, rfilter, synth.buffersize);
+        chanOutput(outl, lbank, synth.buffersize);
+        chanOutput(outr, rbank, synth.buffersize);
 
         if(GlobalFilter)
             GlobalFilter->filter(outl, outr);
 
     } else {
-        chanOutput(outl, lfilter, synth.buffersize);
+        chanOutput(outl, lbank, synth.buffersize);
 
         if(GlobalFilter)
             GlobalFilter->filter(outl, 0);
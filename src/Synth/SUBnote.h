@@ -15,6 +15,7 @@
 #define SUB_NOTE_H
 
 #include "SynthNote.h"
+#include "SUBKernels.h"
 #include "../globals.h"
 
 namespace zyn {
@@ -76,32 +77,50 @@ class SUBnote:public SynthNote
 
         struct bpfilter {
             float freq, bw, amp; //filter parameters
-            float a1, a2, b0, b2; //filter coefs. b1=0
-            float xn1, xn2, yn1, yn2; //filter internal values
         };
 
-        void chanOutput(float *out, bpfilter *bp, int buffer_size);
+        //Filters of harmonic n are in lane n % SUB_LANES of bank
+        //n / SUB_LANES (coefficients and state, see SUBKernels.h)
+        void chanOutput(float *out, SUBBank *banks, int buffer_size);
 
         void initfilter(bpfilter &filter,
+                        SUBBank &bank,
+                        int lane,
+                        int stage,
                         float freq,
                         float bw,
                         float amp,
                         float mag,
                         bool automation);
         float computerolloff(float freq);
-        void computeallfiltercoefs(bpfilter *filters, float envfreq, float envbw, float gain);
-        void computefiltercoefs(bpfilter &filter,
+        //Ramps the banks to the new coefficients over steps sub-blocks
+        //(see subRampBank())
+        void computeallfiltercoefs(bpfilter *filters, SUBBank *banks,
+                                   float envfreq, float envbw, float gain,
+                                   int steps);
+        void computefiltercoefs(const bpfilter &filter,
+                                SUBBank &bank,
+                                int lane,
+                                int stage,
                                 float freq,
                                 float bw,
                                 float gain);
-        inline void filter(bpfilter &filter, float *smps);
+        void allocfilters(void);
+        void freefilters(void);
 
         bpfilter *lfilter, *rfilter;
+        SUBBank  *lbank, *rbank;
+        int       numbanks; //allocated for firstnumharmonics
 
         float overtone_rolloff[MAX_SUB_HARMONICS];
         float overtone_freq[MAX_SUB_HARMONICS];
 
         int   oldpitchwheel, oldbandwidth;
+        //Control rate of the filter coefficients: buffers until the next
+        //update, and the envelope values of the last one (the update is
+        //skipped while they stay the same)
+        int   ctlcounter;
+        float ctlenvfreq, ctlenvbw;
         float globalfiltercenterq;
         float velocity;
         WatchManager *wm;
@@ -20,9 +20,22 @@ namespace zyn {
 SynthNote::SynthNote(SynthParams &pars)
     :memory(pars.memory),
     legato(pars.synth, pars.frequency, pars.velocity, pars.portamento,
-            pars.note, pars.quiet), ctl(pars.ctl), synth(pars.synth), time(pars.time)
+            pars.note, pars.quiet), ctl(pars.ctl), synth(pars.synth), time(pars.time),
+    rng(pars.rng ? pars.rng->split() : RandomStream::global()), arena(nullptr)
 {}
 
+void SynthNote::destroy(SynthNote *note)
+{
+    NoteArena *arena = note->arena;
+    note->memory.dealloc(note);
+    NoteArena::destroy(arena);
+}
+
+Allocator &SynthNote::parentMemory(void) const
+{
+    return arena ? arena->parent : memory;
+}
+
 SynthNote::Legato::Legato(const SYNTH_T &synth_, float freq, float vel, int port,
                           int note, bool quiet)
     :synth(synth_)
@@ -13,6 +13,8 @@
 #ifndef SYNTH_NOTE_H
 #define SYNTH_NOTE_H
 #include "../globals.h"
+#include "../Misc/Util.h"
+#include "../Misc/Allocator.h"
 
 namespace zyn {
 
@@ -29,6 +31,8 @@ struct SynthParams
     bool      portamento;//True if portamento is used for this note
     int       note;      //Integer value of the note
     bool      quiet;     //Initial output condition for legato notes
+    RandomStream *rng;   //Stream to derive the note's one from
+                         //(NULL uses the global generator)
 };
 
 struct LegatoParams
@@ -68,9 +72,29 @@ class SynthNote
         /* For polyphonic aftertouch needed */
         void setVelocity(float velocity_);
 
+        /**Builds a note in an arena of its own, sized by the NoteLayout of
+         * its parameters, so that it takes one allocation from pars.memory
+         * @throw std::bad_alloc if no memory could be allocated*/
+        template<class T, class Params, class... Ts>
+        static T *create(Params *params, SynthParams &pars, Ts&&... ts);
+
+        /**Grows the NoteLayout of params to hold a throwaway note built
+         * from pars.memory, so the first notes of the realtime thread do not
+         * have to learn it
+         * @throw std::bad_alloc if no memory could be allocated*/
+        template<class T, class Params, class... Ts>
+        static void measure(Params *params, SynthParams &pars,
+                            Ts&&... ts) NONREALTIME;
+
+        /**Destroys a note along with the memory it was built in*/
+        static void destroy(SynthNote *note);
+
         //Realtime Safe Memory Allocator For notes
         class Allocator  &memory;
     protected:
+        //Allocator the arena of the note was taken from (for legato clones)
+        Allocator &parentMemory(void) const;
+
         // Legato transitions
         class Legato
         {
@@ -111,8 +135,44 @@ class SynthNote
         const SYNTH_T    &synth;
         const AbsTime    &time;
         WatchManager     *wm;
+
+        //Random numbers for this note (and its LFOs/oscillators) only
+        RandomStream      rng;
+
+    private:
+        //Block holding the note and its subobjects (NULL if not created
+        //with create())
+        NoteArena *arena;
 };
 
+template<class T, class Params, class... Ts>
+T *SynthNote::create(Params *params, SynthParams &pars, Ts&&... ts)
+{
+    NoteArena *arena = NoteArena::create(pars.memory, params->layout.size);
+    if(!arena)
+        throw std::bad_alloc();
+
+    SynthParams sp{*arena, pars.ctl, pars.synth, pars.time, pars.frequency,
+                   pars.velocity, pars.portamento, pars.note, pars.quiet,
+                   pars.rng};
+    T *note = nullptr;
+    try {
+        note = arena->alloc<T>(params, sp, std::forward<Ts>(ts)...);
+    } catch(std::bad_alloc &) {
+        NoteArena::destroy(arena);
+        throw;
+    }
+    static_cast<SynthNote*>(note)->arena = arena;
+    params->layout.record(arena->used());
+    return note;
+}
+
+template<class T, class Params, class... Ts>
+void SynthNote::measure(Params *params, SynthParams &pars, Ts&&... ts)
+{
+    destroy(create<T>(params, pars, std::forward<Ts>(ts)...));
+}
+
 }
 
 #endif
@@ -22,6 +22,7 @@
 #include "WatchPoint.h"
 #include "../Misc/Util.h"
 #include <cstring>
+#include <mutex>
 #include <rtosc/thread-link.h>
 
 namespace zyn {
@@ -149,6 +150,7 @@ int WatchManager::samples(const char *id) const
 void WatchManager::satisfy(const char *id, float f)
 {
     //printf("trying to satisfy '%s'\n", id);
+    std::lock_guard<SpinLock> guard(lock);
     if(write_back)
         write_back->write(id, "f", f);
     del_watch(id);
@@ -156,6 +158,7 @@ void WatchManager::satisfy(const char *id, float f)
 
 void WatchManager::satisfy(const char *id, float *f, int n)
 {
+    std::lock_guard<SpinLock> guard(lock);
     int selected = -1;
     for(int i=0; i<MAX_WATCH; ++i)
         if(!strcmp(active_list[i], id))
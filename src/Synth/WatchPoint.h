@@ -12,6 +12,7 @@
 */
 
 #pragma once
+#include "../Misc/SpinLock.h"
 
 namespace rtosc {class ThreadLink;}
 
@@ -42,6 +43,7 @@ struct WatchManager
     float   data_list[MAX_SAMPLE][MAX_WATCH];
     int     sample_list[MAX_WATCH];
     bool    deactivate[MAX_WATCH];
+    SpinLock lock; //parts may satisfy watches from several render threads
 
     //External API
     WatchManager(thrlnk *link=0);
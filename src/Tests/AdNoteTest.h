@@ -18,6 +18,9 @@
 #include <fstream>
 #include <ctime>
 #include <string>
+#include <cstring>
+#include <rtosc/rtosc.h>
+#include <rtosc/ports.h>
 #include "../Misc/Master.h"
 #include "../Misc/Util.h"
 #include "../Misc/Allocator.h"
@@ -161,6 +164,119 @@ class AdNoteTest:public CxxTest::TestSuite
             TS_ASSERT_EQUALS(sampleCount, 9472);
         }
 
+        //Notes set a voice up again when this changes
+        void testVoiceUpdateTimestamp() {
+            TS_ASSERT_EQUALS(defaultPreset->getVoiceUpdateTimestamp(0), 0);
+            TS_ASSERT_EQUALS(defaultPreset->getVoiceUpdateTimestamp(1), 0);
+
+            (*time)++;
+            (*time)++;
+            defaultPreset->VoicePar[1].last_update_timestamp = time->time();
+            TS_ASSERT_EQUALS(defaultPreset->getVoiceUpdateTimestamp(0), 0);
+            TS_ASSERT_EQUALS(defaultPreset->getVoiceUpdateTimestamp(1), 2);
+
+            //Global parameters affect every voice
+            (*time)++;
+            defaultPreset->GlobalPar.last_update_timestamp = time->time();
+            TS_ASSERT_EQUALS(defaultPreset->getVoiceUpdateTimestamp(0), 3);
+            TS_ASSERT_EQUALS(defaultPreset->getVoiceUpdateTimestamp(1), 3);
+
+            note->noteout(outL, outR);
+
+            //A playing note sets the voice up again after an edit through
+            //any of the ports, like it does after stamping the voice by hand
+            ADnoteVoiceParam &voice = defaultPreset->VoicePar[0];
+            TS_ASSERT(voice.PFMEnabled);
+            const char *edits[] = {"octave", "coarsedetune", "FMoctave",
+                                   "FMcoarsedetune", "PFMVolume"};
+            for(const char *edit : edits) {
+                const unsigned short coarse   = voice.PCoarseDetune;
+                const unsigned short fmcoarse = voice.PFMCoarseDetune;
+                const float          fmvolume = voice.FMvolume;
+                auto restore = [&] {
+                    voice.PCoarseDetune   = coarse;
+                    voice.PFMCoarseDetune = fmcoarse;
+                    voice.FMvolume        = fmvolume;
+                };
+                float before[256], ported[256], stamped[256];
+
+                editedBlock(before, [&] {});
+
+                editedBlock(ported, [&] {
+                        char msg[64], loc[1024];
+                        rtosc_message(msg, sizeof(msg), edit, "i", 3);
+                        rtosc::RtData d;
+                        d.loc      = loc;
+                        d.loc_size = sizeof(loc);
+                        d.obj      = &voice;
+                        ADnoteVoiceParam::ports.dispatch(msg, d);
+                    });
+                const unsigned short newcoarse   = voice.PCoarseDetune;
+                const unsigned short newfmcoarse = voice.PFMCoarseDetune;
+                const float          newfmvolume = voice.FMvolume;
+                restore();
+
+                editedBlock(stamped, [&] {
+                        voice.PCoarseDetune   = newcoarse;
+                        voice.PFMCoarseDetune = newfmcoarse;
+                        voice.FMvolume        = newfmvolume;
+                        voice.last_update_timestamp = time->time();
+                    });
+                restore();
+
+                bool changed = false;
+                for(int i = 0; i < synth->buffersize; ++i) {
+                    TS_ASSERT_EQUALS(ported[i], stamped[i]);
+                    changed |= ported[i] != before[i];
+                }
+                TS_ASSERT(changed);
+            }
+        }
+
+        //Second block of a fresh note, with edit() applied after the first
+        template<class F>
+        void editedBlock(float *out, F edit) {
+            sprng(1);
+            SynthParams pars{memory, *controller, *synth, *time, 440.0f, 120,
+                             0, testnote, false};
+            ADnote n(defaultPreset, pars);
+            (*time)++;
+            n.noteout(outL, outR);
+            edit();
+            (*time)++;
+            n.noteout(outL, outR);
+            memcpy(out, outL, synth->bufferbytes);
+        }
+
+        //Once the layout is measured a note takes a single block, and the
+        //waves it shares outlive it
+        void testNoteArena() {
+            SynthParams pars{memory, *controller, *synth, *time, 440.0f, 120,
+                             0, testnote, false};
+            TS_ASSERT_EQUALS(defaultPreset->layout.size, 0u);
+
+            SynthNote::measure<ADnote>(defaultPreset, pars);
+            const size_t size = defaultPreset->layout.size;
+            TS_ASSERT(size > sizeof(ADnote));
+
+            //Drop the waves shared so far, the first note below shares new
+            //ones and the second one picks them up after it is destroyed
+            defaultPreset->releasetables();
+            float out[2][256];
+            for(int k = 0; k < 2; ++k) {
+                sprng(1);
+                SynthNote *n = SynthNote::create<ADnote>(defaultPreset, pars);
+                TS_ASSERT_EQUALS(defaultPreset->layout.size, size);
+                TS_ASSERT_EQUALS(((NoteArena&)n->memory).used(), size);
+                for(int i = 0; i < 10; ++i)
+                    n->noteout(outL, outR);
+                memcpy(out[k], outL, synth->bufferbytes);
+                SynthNote::destroy(n);
+            }
+            for(int i = 0; i < synth->buffersize; ++i)
+                TS_ASSERT_EQUALS(out[0][i], out[1][i]);
+        }
+
 #define OUTPUT_PROFILE
 #ifdef OUTPUT_PROFILE
         void testSpeed() {
@@ -16,6 +16,7 @@
 #include <fstream>
 #include <ctime>
 #include <cstring>
+#include <stdint.h>
 #include <string>
 #include <vector>
 #include "../Misc/Allocator.h"
@@ -105,4 +106,31 @@ class AllocatorTest:public CxxTest::TestSuite
             //delete [] bufB;
         }
 
+        void testNoteArena()
+        {
+            Allocator &memory = *memory_;
+            NoteArena *arena = NoteArena::create(memory, 100);
+            TS_ASSERT(arena);
+            char *a = (char*)arena->alloc_mem(10);
+            char *b = (char*)arena->alloc_mem(40);
+            TS_ASSERT(a && b);
+            //allocations are aligned and follow each other
+            TS_ASSERT_EQUALS((uintptr_t)a % 16, 0u);
+            TS_ASSERT_EQUALS(b - a, 16);
+            TS_ASSERT_EQUALS(arena->used(), 64u);
+
+            //what does not fit comes from the parent
+            char *c = (char*)arena->alloc_mem(64);
+            TS_ASSERT(c);
+            TS_ASSERT(c < a || c > b + 48);
+            TS_ASSERT_EQUALS(arena->used(), 128u);
+            memset(a, 0, 10);
+            memset(b, 0, 40);
+            memset(c, 0, 64);
+
+            arena->dealloc_mem(b);
+            arena->dealloc_mem(c);
+            NoteArena::destroy(arena);
+        }
+
 };
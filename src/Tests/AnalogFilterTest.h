@@ -0,0 +1,222 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  AnalogFilterTest.h - CxxTest for DSP/AnalogFilter
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include "../DSP/AnalogFilter.h"
+#include "../globals.h"
+#include "KernelCompare.h"
+
+using namespace std;
+using namespace zyn;
+
+#define SRATE   44100
+#define BUFSIZE 256
+
+class AnalogFilterTest:public CxxTest::TestSuite
+{
+    public:
+        float in[2][BUFSIZE], outl[BUFSIZE], outr[BUFSIZE];
+        float refl[BUFSIZE], refr[BUFSIZE];
+
+        void setUp() {
+            srand(11);
+            for(int c = 0; c < 2; ++c)
+                for(int i = 0; i < BUFSIZE; ++i)
+                    in[c][i] = rand() / (RAND_MAX + 1.0f) - 0.5f;
+        }
+
+        //The filter as it was before the stages ran in lanes: one stage after
+        //the other, and while a coefficient change is interpolated, the
+        //filter at the old coeffs runs on the output at the new ones
+        struct Reference {
+            AnalogFilter::Coeff coeff, oldCoeff;
+            int   type, order, stages;
+            float freq, q;
+            bool  interpolate;
+            AnalogFilter::fstage hist[MAX_FILTER_STAGES + 1],
+                                 oldHist[MAX_FILTER_STAGES + 1];
+
+            Reference(int type_, float freq_, float q_, int stages_)
+                :type(type_), stages(stages_), freq(freq_), q(q_),
+                  interpolate(false)
+            {
+                coeff = AnalogFilter::computeCoeff(type, freq, q, stages, 1.0f,
+                                                   SRATE, order);
+                memset(hist, 0, sizeof(hist));
+            }
+
+            void setfreq(float freq_) {
+                if(fmaxf(freq, freq_) / fminf(freq, freq_) > 3.0f) {
+                    oldCoeff = coeff;
+                    memcpy(oldHist, hist, sizeof(hist));
+                    interpolate = true;
+                }
+                freq  = freq_;
+                coeff = AnalogFilter::computeCoeff(type, freq, q, stages, 1.0f,
+                                                   SRATE, order);
+            }
+
+            static void biquadA(const float c[5], float &src, float w[4]) {
+                w[3] = src * c[0] + w[0] * c[1] + w[1] * c[2] + w[2] * c[3]
+                       + w[3] * c[4];
+                w[1] = src;
+                src  = w[3];
+            }
+
+            static void biquadB(const float c[5], float &src, float w[4]) {
+                w[2] = src * c[0] + w[1] * c[1] + w[0] * c[2] + w[3] * c[3]
+                       + w[2] * c[4];
+                w[0] = src;
+                src  = w[2];
+            }
+
+            void single(float *smp, AnalogFilter::fstage &h,
+                        const AnalogFilter::Coeff &co) {
+                if(order == 1)
+                    for(int i = 0; i < BUFSIZE; ++i) {
+                        const float y = smp[i] * co.c[0] + h.x1 * co.c[1]
+                                        + h.y1 * co.d[1];
+                        h.y1   = y;
+                        h.x1   = smp[i];
+                        smp[i] = y;
+                    }
+                else {
+                    const float c[5] = {co.c[0], co.c[1], co.c[2], co.d[1],
+                                        co.d[2]};
+                    float w[4] = {h.x1, h.x2, h.y1, h.y2};
+                    for(int i = 0; i < BUFSIZE; i += 2) {
+                        biquadA(c, smp[i], w);
+                        biquadB(c, smp[i + 1], w);
+                    }
+                    h.x1 = w[0];
+                    h.x2 = w[1];
+                    h.y1 = w[2];
+                    h.y2 = w[3];
+                }
+            }
+
+            void filterout(float *smp) {
+                for(int s = 0; s <= stages; ++s)
+                    single(smp, hist[s], coeff);
+                if(!interpolate)
+                    return;
+                float ismp[BUFSIZE];
+                memcpy(ismp, smp, sizeof(ismp));
+                for(int s = 0; s <= stages; ++s)
+                    single(ismp, oldHist[s], oldCoeff);
+                for(int i = 0; i < BUFSIZE; ++i) {
+                    const float x = (float)i / BUFSIZE;
+                    smp[i] = ismp[i] * (1.0f - x) + smp[i] * x;
+                }
+                interpolate = false;
+            }
+        };
+
+        void testMatchesReference() {
+            const int types[] = {0, 1, 2, 3, 4, 6}; //first and second order
+            for(int type : types)
+                for(int stages = 0; stages < MAX_FILTER_STAGES; ++stages) {
+                    AnalogFilter mono(type, 800.0f, 2.0f, stages, SRATE,
+                                      BUFSIZE);
+                    AnalogFilter l(type, 800.0f, 2.0f, stages, SRATE, BUFSIZE);
+                    AnalogFilter r(type, 800.0f, 2.0f, stages, SRATE, BUFSIZE);
+                    Reference ref(type, 800.0f, 2.0f, stages);
+                    Reference refr_(type, 800.0f, 2.0f, stages);
+                    for(int block = 0; block < 20; ++block) {
+                        memcpy(outl, in[0], sizeof(outl));
+                        memcpy(outr, in[1], sizeof(outr));
+                        memcpy(refl, in[0], sizeof(refl));
+                        memcpy(refr, in[1], sizeof(refr));
+                        l.filterout_stereo(outl, r, outr);
+                        ref.filterout(refl);
+                        refr_.filterout(refr);
+                        TS_ASSERT_LESS_THAN(relError(outl, refl, BUFSIZE),
+                                            1e-3f);
+                        TS_ASSERT_LESS_THAN(relError(outr, refr, BUFSIZE),
+                                            1e-3f);
+
+                        memcpy(outl, in[0], sizeof(outl));
+                        mono.filterout(outl);
+                        TS_ASSERT_LESS_THAN(relError(outl, refl, BUFSIZE),
+                                            1e-3f);
+                    }
+                }
+        }
+
+        //channels filtered together and on their own match the reference,
+        //also while the coefficients are interpolated
+        void testStereoInterpolation() {
+            for(int stages = 0; stages < MAX_FILTER_STAGES; ++stages) {
+                AnalogFilter l(2, 500.0f, 3.0f, stages, SRATE, BUFSIZE);
+                AnalogFilter r(2, 500.0f, 3.0f, stages, SRATE, BUFSIZE);
+                AnalogFilter mono(2, 500.0f, 3.0f, stages, SRATE, BUFSIZE);
+                Reference ref(2, 500.0f, 3.0f, stages);
+                Reference refr_(2, 500.0f, 3.0f, stages);
+                for(int block = 0; block < 20; ++block) {
+                    //jumps far enough to be interpolated
+                    const float freq = block % 2 ? 4000.0f : 500.0f;
+                    l.setfreq(freq);
+                    mono.setfreq(freq);
+                    ref.setfreq(freq);
+                    if(block % 4 < 2) {
+                        r.setfreq(freq);
+                        refr_.setfreq(freq);
+                    }
+                    memcpy(outl, in[0], sizeof(outl));
+                    memcpy(outr, in[1], sizeof(outr));
+                    memcpy(refl, in[0], sizeof(refl));
+                    memcpy(refr, in[1], sizeof(refr));
+                    l.filterout_stereo(outl, r, outr);
+                    ref.filterout(refl);
+                    refr_.filterout(refr);
+                    TS_ASSERT_LESS_THAN(relError(outl, refl, BUFSIZE), 1e-3f);
+                    TS_ASSERT_LESS_THAN(relError(outr, refr, BUFSIZE), 1e-3f);
+
+                    memcpy(outl, in[0], sizeof(outl));
+                    mono.filterout(outl);
+                    TS_ASSERT_LESS_THAN(relError(outl, refl, BUFSIZE), 1e-3f);
+                }
+            }
+        }
+
+        void testSpeed() {
+            const int blocks = 20000;
+            for(int stages = 0; stages < MAX_FILTER_STAGES; stages += 2) {
+                AnalogFilter l(2, 800.0f, 2.0f, stages, SRATE, BUFSIZE);
+                AnalogFilter r(2, 800.0f, 2.0f, stages, SRATE, BUFSIZE);
+                Reference refl_(2, 800.0f, 2.0f, stages);
+                Reference refr_(2, 800.0f, 2.0f, stages);
+
+                int t_on = clock(); // timer before calling func
+                for(int i = 0; i < blocks; ++i) {
+                    refl_.filterout(in[0]);
+                    refr_.filterout(in[1]);
+                }
+                int t_off = clock(); // timer when func returns
+                const float s = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+                t_on = clock(); // timer before calling func
+                for(int i = 0; i < blocks; ++i)
+                    l.filterout_stereo(in[0], r, in[1]);
+                t_off = clock(); // timer when func returns
+                const float k = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+                printf("AnalogFilterTest: stereo, %d stages, %f seconds "
+                       "reference, %f seconds filter (%.2fx)\n", stages + 1,
+                       s, k, k > 0 ? s / k : 0.0f);
+            }
+        }
+};
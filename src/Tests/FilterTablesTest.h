@@ -0,0 +1,154 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  FilterTablesTest.h - CxxTest for DSP/FilterTables
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <ctime>
+#include "../DSP/FilterTables.h"
+#include "../DSP/AnalogFilter.h"
+#include "../DSP/SVFilter.h"
+#include "../globals.h"
+
+using namespace std;
+using namespace zyn;
+
+#define SRATE   44100
+#define BUFSIZE 256
+
+class FilterTablesTest:public CxxTest::TestSuite
+{
+    public:
+        float in[BUFSIZE], outa[BUFSIZE], outb[BUFSIZE];
+
+        void setUp() {
+            for(int i = 0; i < BUFSIZE; ++i)
+                in[i] = sinf(i * 0.3f) + 0.5f * sinf(i * 0.011f);
+        }
+
+        //Magnitude (dB) of the stage cascade at freq, the depth of a notch is
+        //not measured below -60dB
+        static double response(const AnalogFilter::Coeff &co, int stages,
+                               float freq) {
+            const complex<double> z1 = polar(1.0, -2.0 * M_PI * freq / SRATE);
+            const complex<double> z2 = z1 * z1;
+            const complex<double> h  = ((double)co.c[0] + (double)co.c[1] * z1
+                                        + (double)co.c[2] * z2)
+                                       / (1.0 - (double)co.d[1] * z1
+                                          - (double)co.d[2] * z2);
+            return 20.0 * log10(fmax(pow(abs(h), stages + 1), 1e-3));
+        }
+
+        void testTrig() {
+            for(float freq = 0.1f; freq < SRATE / 2; freq *= 1.01f) {
+                const FilterTrig t = filterTrig(freq, SRATE);
+                const double omega = 2.0 * M_PI * freq / SRATE;
+                TS_ASSERT_DELTA(t.sn, sin(omega), 5e-5);
+                TS_ASSERT_DELTA(t.cs, cos(omega), 5e-5);
+                TS_ASSERT_DELTA(t.ex, exp(-omega), 5e-5);
+                //what the lowpass and highpass coefficients are made of
+                if(freq > 20.0f)
+                    TS_ASSERT_DELTA((1.0f - t.cs) / (1.0 - cos(omega)), 1.0,
+                                    0.02);
+            }
+        }
+
+        //the filters stay within a tenth of a dB of the exact design; below
+        //100Hz the sharpest resonances depend on the last bit of cos either way
+        void testAnalogResponse() {
+            const float qs[]    = {0.5f, 1.0f, 4.0f, 20.0f};
+            const float gains[] = {-12.0f, 0.0f, 9.0f};
+            for(int type = 0; type < 9; ++type)
+                for(int stages = 0; stages < MAX_FILTER_STAGES; stages += 2)
+                    for(float q : qs)
+                        for(float g : gains)
+                            for(float cutoff = 100.0f; cutoff < SRATE / 2;
+                                cutoff *= 1.37f) {
+                                AnalogFilter f(type, cutoff, q, stages, SRATE,
+                                               BUFSIZE);
+                                f.setgain(g);
+                                int order;
+                                const AnalogFilter::Coeff exact =
+                                    AnalogFilter::computeCoeff(type, cutoff, q,
+                                            stages, dB2rap(g), SRATE, order);
+                                double err = 0.0;
+                                for(float p = 40.0f; p < SRATE / 2; p *= 1.05f)
+                                    err = fmax(err,
+                                            fabs(response(f.coeff, stages, p)
+                                                 - response(exact, stages, p)));
+                                TS_ASSERT_LESS_THAN(err, 0.1);
+                            }
+        }
+
+        //new values of q and the stages replace the remembered ones
+        void testCachedParameters() {
+            AnalogFilter a(6, 1000.0f, 2.0f, 1, SRATE, BUFSIZE);
+            a.setgain(6.0f);
+            a.setfreq(3000.0f);
+            a.setq(5.0f);
+            a.setstages(3);
+            a.setgain(-3.0f);
+            AnalogFilter b(6, 3000.0f, 5.0f, 3, SRATE, BUFSIZE);
+            b.setgain(-3.0f);
+            for(int i = 0; i < 3; ++i) {
+                TS_ASSERT_EQUALS(a.coeff.c[i], b.coeff.c[i]);
+                TS_ASSERT_EQUALS(a.coeff.d[i], b.coeff.d[i]);
+            }
+
+            SVFilter sa(0, 1000.0f, 2.0f, 1, SRATE, BUFSIZE);
+            sa.setq(5.0f);
+            sa.setstages(3);
+            SVFilter sb(0, 1000.0f, 5.0f, 3, SRATE, BUFSIZE);
+            for(int i = 0; i < BUFSIZE; ++i)
+                outa[i] = outb[i] = in[i];
+            sa.filterout(outa);
+            sb.filterout(outb);
+            for(int i = 0; i < BUFSIZE; ++i)
+                TS_ASSERT_EQUALS(outa[i], outb[i]);
+        }
+
+        void testSpeed() {
+            const int sweeps = 20000;
+            AnalogFilter a(2, 1000.0f, 4.0f, 2, SRATE, BUFSIZE);
+            SVFilter     s(0, 1000.0f, 4.0f, 2, SRATE, BUFSIZE);
+            int   order;
+            float sum = 0.0f;
+
+            int t_on = clock(); // timer before calling func
+            for(int i = 0; i < sweeps; ++i)
+                for(int k = 0; k < 64; ++k)
+                    sum += AnalogFilter::computeCoeff(2, 200.0f + k * 50.0f,
+                            4.0f, 2, 1.0f, SRATE, order).c[0];
+            int t_off = clock(); // timer when func returns
+            const float e = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+            t_on = clock(); // timer before calling func
+            for(int i = 0; i < sweeps; ++i)
+                for(int k = 0; k < 64; ++k) {
+                    a.setfreq_and_q(200.0f + k * 50.0f, 4.0f);
+                    sum += a.coeff.c[0];
+                }
+            t_off = clock(); // timer when func returns
+            const float t = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+            t_on = clock(); // timer before calling func
+            for(int i = 0; i < sweeps; ++i)
+                for(int k = 0; k < 64; ++k)
+                    s.setfreq_and_q(200.0f + k * 50.0f, 4.0f);
+            t_off = clock(); // timer when func returns
+            const float v = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+            printf("FilterTablesTest: %d cutoffs, %f seconds exact, "
+                   "%f seconds table (%.2fx), %f seconds SVFilter (%g)\n",
+                   sweeps * 64, e, t, t > 0 ? e / t : 0.0f, v, sum);
+        }
+};
@@ -0,0 +1,44 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  KernelCompare.h - Comparisons Of Kernel Output For The Tests
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#pragma once
+#include <cmath>
+
+/*
+ * The vectorized kernels match the loops they replace exactly unless
+ * -ffast-math lets the compiler rearrange the sums of the two differently,
+ * so their output is compared within a tolerance.
+ */
+
+//Largest difference between the first n samples of a and b
+inline float maxError(const float *a, const float *b, int n)
+{
+    float err = 0.0f;
+    for(int i = 0; i < n; ++i)
+        err = fmaxf(err, fabsf(a[i] - b[i]));
+    return err;
+}
+
+//Largest magnitude within the first n samples of a
+inline float peak(const float *a, int n)
+{
+    float p = 0.0f;
+    for(int i = 0; i < n; ++i)
+        p = fmaxf(p, fabsf(a[i]));
+    return p;
+}
+
+//maxError() relative to the peak of b, for filters whose narrow resonances
+//amplify any difference in rounding
+inline float relError(const float *a, const float *b, int n)
+{
+    return maxError(a, b, n) / fmaxf(peak(b, n), 1e-3f);
+}
@@ -22,6 +22,8 @@
 #define protected public
 #include "../Synth/SynthNote.h"
 #include "../Misc/Part.h"
+#include "../Params/ADnoteParameters.h"
+#include "../Synth/OscilGen.h"
 #include "../globals.h"
 
 using namespace std;
@@ -758,6 +760,37 @@ class KitTest:public CxxTest::TestSuite
             TS_ASSERT_EQUALS(pool.ndesc[4].note, 68);
         }
 
+        //the notes' wavetable buffers go back to the realtime allocator
+        //before the part can be handed to another thread to be deleted
+        void testKillReleasesTables() {
+            part->applyparameters();
+            OscilTables *tables =
+                part->kit[0].adpars->VoicePar[0].OscilSmp->tables;
+            TS_ASSERT(tables);
+            part->NoteOn(64, 127, 0);
+            TS_ASSERT(tables->inuse());
+
+            part->kill_rt();
+            TS_ASSERT(!tables->inuse());
+        }
+
+        //the layout is measured without the wavetables, which are left with
+        //no buffer handed out, and holds the notes using them
+        void testApplyMeasuresWithoutTables() {
+            part->applyparameters();
+            ADnoteParameters *pars = part->kit[0].adpars;
+            OscilTables *tables = pars->VoicePar[0].OscilSmp->tables;
+            TS_ASSERT(tables);
+            TS_ASSERT(!tables->inuse());
+            TS_ASSERT(pars->layout.size > 0);
+
+            const size_t size = pars->layout.size;
+            part->NoteOn(64, 127, 0);
+            TS_ASSERT(tables->inuse());
+            TS_ASSERT_EQUALS(pars->layout.size, size);
+            part->kill_rt();
+        }
+
         void tearDown() {
             delete part;
             delete[] outL;
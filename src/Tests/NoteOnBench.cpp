@@ -0,0 +1,119 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  NoteOnBench.cpp - Note On Latency Benchmark
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include "../Misc/Time.h"
+#include "../Misc/Part.h"
+#include "../Misc/Allocator.h"
+#include "../Misc/Microtonal.h"
+#include "../Misc/NoteStats.h"
+#include "../DSP/FFTwrapper.h"
+#include "../globals.h"
+using namespace zyn;
+
+SYNTH_T *synth;
+AbsTime *time_;
+
+int compress = 0;
+int interp   = 1;
+Alloc      alloc;
+Microtonal microtonal(compress);
+FFTwrapper fft(1024);
+Part *p;
+
+void setup()
+{
+    synth = new SYNTH_T;
+    synth->buffersize = 256;
+    synth->samplerate = 48000;
+    synth->alias();
+    time_ = new AbsTime(*synth);
+    //for those patches that are just really big
+    alloc.addMemory(malloc(1024*1024),1024*1024);
+
+    p = new Part(alloc, *synth, *time_, compress, interp, &microtonal, &fft);
+}
+
+//Microseconds of a tick count
+double usec(uint64_t ticks)
+{
+    return 1e6 * ticks / NoteStats::ticksPerSecond();
+}
+
+void report(const char *name, std::vector<uint64_t> &t)
+{
+    if(t.empty())
+        return;
+    std::sort(t.begin(), t.end());
+    printf("%-12s %6d events  p50 %9.2f us  p99 %9.2f us  max %9.2f us\n",
+           name, (int)t.size(), usec(t[t.size() / 2]),
+           usec(t[(t.size() * 99) / 100]), usec(t.back()));
+}
+
+void report(const char *name, const LatencyHistogram &h)
+{
+    if(!h.events)
+        return;
+    printf("%-12s %6d events  p50 %9.2f us  p99 %9.2f us  max %9.2f us\n",
+           name, (int)h.events, usec(h.percentile(0.5f)),
+           usec(h.percentile(0.99f)), usec(h.max));
+}
+
+/*
+ * Replays bursts of chords against an instrument and reports the cost of
+ * Part::NoteOn() along with the note stats gathered by the part
+ */
+int main(int argc, char **argv)
+{
+    if(argc < 2) {
+        fprintf(stderr, "Usage: %s file.xiz [bursts] [chord size]\n", argv[0]);
+        return 1;
+    }
+    const int bursts = argc > 2 ? atoi(argv[2]) : 100;
+    const int chord  = argc > 3 ? atoi(argv[3]) : 8;
+
+    setup();
+    if(p->loadXMLinstrument(argv[1])) {
+        fprintf(stderr, "Failed to load '%s'\n", argv[1]);
+        return 1;
+    }
+    p->applyparameters();
+    p->initialize_rt();
+    p->notePool.stats.reset();
+
+    std::vector<uint64_t> noteon;
+    for(int b = 0; b < bursts; ++b) {
+        const int root = 40 + (b * 7) % 40;
+        for(int n = 0; n < chord; ++n) {
+            const uint64_t t = NoteStats::ticks();
+            p->NoteOn(root + 2 * n, 100, 0);
+            noteon.push_back(NoteStats::ticks() - t);
+        }
+        for(int i = 0; i < 20; ++i)
+            p->ComputePartSmps();
+        for(int n = 0; n < chord; ++n)
+            p->NoteOff(root + 2 * n);
+        for(int i = 0; i < 20; ++i)
+            p->ComputePartSmps();
+    }
+    p->AllNotesOff();
+    p->ComputePartSmps();
+
+    const NoteStats &s = p->notePool.stats;
+    report("note on", noteon);
+    report("construct", s.hist[NoteStats::Construct]);
+    report("first out", s.hist[NoteStats::FirstOut]);
+    report("kill", s.hist[NoteStats::Kill]);
+    return 0;
+}
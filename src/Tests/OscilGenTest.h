@@ -11,11 +11,13 @@
   of the License, or (at your option) any later version.
 */
 #include <cxxtest/TestSuite.h>
+#include <algorithm>
 #include <string>
 #include "../Synth/OscilGen.h"
 #include "../Misc/XMLwrapper.h"
 #include "../DSP/FFTwrapper.h"
 #include "../Misc/Util.h"
+#include "../Misc/Allocator.h"
 #include "../globals.h"
 using namespace std;
 using namespace zyn;
@@ -105,6 +107,168 @@ class OscilGenTest:public CxxTest::TestSuite
             TS_ASSERT_DELTA(outR[66], 0.001293f, 0.0001f);
         }
 
+        //the wavetables hold the output of get() for the notes with as many
+        //harmonics
+        void testTables(void)
+        {
+            oscil->Prand = 64;
+            oscil->Pamprandtype = 0;
+            oscil->Padaptiveharmonics = 0;
+            oscil->preparetables();
+            OscilTables *t = oscil->tables;
+            TS_ASSERT(t);
+            TS_ASSERT_EQUALS(t->lookup(1.0f), t->n - 1);
+            TS_ASSERT_EQUALS(t->lookup(synth->samplerate_f), -1);
+            for(int h = 1; h <= OSCIL_TABLE_EXACT; ++h)
+                TS_ASSERT_EQUALS(t->harmonics[h - 1], h);
+
+            for(int k = 0; k < t->n; ++k) {
+                const float f = t->nyqfreq / (t->harmonics[k] + 0.5f);
+                TS_ASSERT_EQUALS(t->count(f), t->harmonics[k]);
+                TS_ASSERT_EQUALS(t->lookup(f), k);
+                oscil->tables = NULL;
+                oscil->get(outL, f);
+                oscil->tables = t;
+                oscil->get(outR, f);
+                for(int i = 0; i < synth->oscilsize; ++i)
+                    TS_ASSERT_DELTA(outL[i], outR[i], 1e-6f);
+            }
+
+            //outdated by a parameter change, but left to the notes using
+            //them until new ones are handed over
+            oscil->Pbasefuncpar += 1;
+            oscil->get(outL, freq);
+            TS_ASSERT_DIFFERS(t->revision, oscil->revision);
+            TS_ASSERT(oscil->tables == t && t->src);
+        }
+
+        //notes keep every harmonic the exact computation keeps below
+        //0.9 * nyquist (nyquist / 2 for the lowest ones) and none above
+        //nyquist. Both are normalized over the harmonics they keep, so a
+        //missing harmonic raises the others a little
+        void testTablesMatchExact(void)
+        {
+            const int half = synth->oscilsize / 2;
+            const float nyq = synth->samplerate_f / 2.0f;
+            fft_t *exact = new fft_t[half], *table = new fft_t[half];
+            oscil->Prand = 64;
+            oscil->Pamprandtype = 0;
+            oscil->Padaptiveharmonics = 0;
+            oscil->preparetables();
+            OscilTables *t = oscil->tables;
+
+            for(float f = 20.0f; f < nyq; f *= 1.0123f) {
+                TS_ASSERT(t->lookup(f) >= 0);
+                oscil->tables = NULL;
+                oscil->get(outL, f);
+                oscil->tables = t;
+                oscil->get(outR, f);
+                fft->smps2freqs(outL, exact);
+                fft->smps2freqs(outR, table);
+
+                const bool  fine = t->count(f) <= OSCIL_TABLE_FINE;
+                const float kept = (fine ? 0.9f : 0.5f) * nyq;
+                fftw_real peak = 0, dot = 0, norm = 0;
+                for(int i = 1; i < half && i * f < kept; ++i) {
+                    peak  = std::max(peak, std::abs(exact[i]));
+                    dot  += std::real(std::conj(exact[i]) * table[i]);
+                    norm += std::norm(exact[i]);
+                }
+                const fftw_real gain = norm > 0 ? dot / norm : 1;
+                TS_ASSERT_DELTA(gain, 1.0, 0.01);
+                for(int i = 1; i < half; ++i) {
+                    if(i * f < kept)
+                        TS_ASSERT_DELTA(std::abs(table[i] - exact[i] * gain),
+                                        0.0, 1e-3 * peak);
+                    if(i * f > nyq)
+                        TS_ASSERT_DELTA(std::abs(table[i]), 0.0, 1e-4 * peak);
+                }
+            }
+            delete[] exact;
+            delete[] table;
+        }
+
+        //notes share the precomputed output
+        void testSharedBuffers(void)
+        {
+            Alloc memory;
+            RandomStream rng;
+            short start;
+            oscil->Prand = 64;
+            oscil->Pamprandtype = 0;
+            oscil->Padaptiveharmonics = 0;
+            oscil->preparetables();
+
+            OscilBuffer *a = oscil->getshared(freq, 0, rng, memory, 5, start);
+            OscilBuffer *b = oscil->getshared(freq, 0, rng, memory, 5, start);
+            TS_ASSERT(a);
+            TS_ASSERT_EQUALS(a, b);
+            oscil->get(outL, freq);
+            for(int i = 0; i < synth->oscilsize; ++i)
+                TS_ASSERT_EQUALS(a->smps()[i], outL[i]);
+            for(int i = 0; i < 5; ++i)
+                TS_ASSERT_EQUALS(a->smps()[synth->oscilsize + i], outL[i]);
+
+            //per note randomness
+            oscil->Prand = 127;
+            TS_ASSERT(!oscil->getshared(freq, 0, rng, memory, 5, start));
+
+            //the notes keep their buffer once the tables let go of it
+            oscil->releasetables();
+            TS_ASSERT(!oscil->tables->inuse());
+            TS_ASSERT_EQUALS(a->smps()[0], outL[0]);
+            a->unref();
+            b->unref();
+        }
+
+        //a transform there and back returns the samples (times the size);
+        //the offset buffers are not aligned like the internal ones
+        void testRoundTrip(void)
+        {
+            const int n = synth->oscilsize;
+            float *smps = new float[n + 1];
+            float *out  = new float[n + 1];
+            fft_t *freqs = new fft_t[n / 2];
+            for(int offset = 0; offset < 2; ++offset) {
+                float *s = smps + offset;
+                for(int i = 0; i < n; ++i)
+                    s[i] = 0.25f + sinf(2 * PI * 3 * i / n)
+                           + 0.5f * cosf(2 * PI * 17 * i / n);
+                fft->smps2freqs(s, freqs);
+                TS_ASSERT_DELTA(freqs[0].real(), 0.25f * n, 1e-2 * n);
+                TS_ASSERT_DELTA(std::abs(freqs[3]), 0.5f * n, 1e-2 * n);
+                TS_ASSERT_DELTA(std::abs(freqs[17]), 0.25f * n, 1e-2 * n);
+
+                fft->freqs2smps(freqs, out + offset);
+                for(int i = 0; i < n; ++i)
+                    TS_ASSERT_DELTA(out[offset + i] / n, s[i], 1e-4);
+            }
+            delete[] freqs;
+            delete[] out;
+            delete[] smps;
+        }
+
+        //wrappers of a size share the plans, which survive in the wisdom
+        void testPlanCache(void)
+        {
+            const int n = synth->oscilsize;
+            FFTwrapper other(n);
+            fft_t *a = new fft_t[n / 2], *b = new fft_t[n / 2];
+            oscil->get(outL, freq);
+            fft->smps2freqs(outL, a);
+            other.smps2freqs(outL, b);
+            for(int i = 0; i < n / 2; ++i)
+                TS_ASSERT_EQUALS(a[i], b[i]);
+            delete[] a;
+            delete[] b;
+
+            const char *file = "oscilgen-test.wisdom";
+            TS_ASSERT(FFT_saveWisdom(file));
+            TS_ASSERT(FFT_loadWisdom(file));
+            TS_ASSERT(!FFT_loadWisdom("oscilgen-test.missing"));
+            remove(file);
+        }
+
         //performance testing
         void testSpeed() {
             const int samps = 15000;
@@ -0,0 +1,111 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PadCacheTest.h - CxxTest for the PADsynth sample cache
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cxxtest/TestSuite.h>
+#include <cstdio>
+#include <string>
+#include <dirent.h>
+#include <unistd.h>
+#include "../Misc/PADcache.h"
+#include "../Misc/SampleMemory.h"
+#include "../globals.h"
+
+using namespace zyn;
+
+#define COUNT 4
+#define SIZE  1000
+
+class PadCacheTest:public CxxTest::TestSuite
+{
+    public:
+        float *smps[COUNT];
+        float  basefreqs[COUNT];
+        float  data[COUNT][SIZE];
+
+        void setUp() {
+            PADcache::setDirectory("padcache-test");
+            PADcache::setLimit(1 << 30);
+            for(int n = 0; n < COUNT; ++n)
+                for(int i = 0; i < SIZE; ++i)
+                    data[n][i] = n + i * 0.001f;
+        }
+
+        void tearDown() {
+            PADcache::setLimit(0);
+            if(DIR *d = opendir("padcache-test")) {
+                while(struct dirent *e = readdir(d))
+                    if(e->d_name[0] != '.')
+                        unlink((std::string("padcache-test/")
+                                + e->d_name).c_str());
+                closedir(d);
+            }
+            rmdir("padcache-test");
+        }
+
+        void store(uint64_t key, int count) {
+            PADcache::Writer writer(key, COUNT, SIZE);
+            for(int n = count - 1; n >= 0; --n)
+                writer.write(n, data[n], 100.0f * n);
+            writer.commit();
+        }
+
+        std::string file(uint64_t key) {
+            char name[64];
+            snprintf(name, sizeof(name), "padcache-test/%016llx.pad",
+                     (unsigned long long)key);
+            return name;
+        }
+
+        void testRoundTrip() {
+            store(1, COUNT);
+            TS_ASSERT(PADcache::load(1, COUNT, SIZE, smps, basefreqs));
+            for(int n = 0; n < COUNT; ++n) {
+                TS_ASSERT_EQUALS(basefreqs[n], 100.0f * n);
+                TS_ASSERT_EQUALS(smps[n][0], data[n][0]);
+                TS_ASSERT_EQUALS(smps[n][SIZE-1], data[n][SIZE-1]);
+                SampleMemory::dealloc(smps[n]);
+            }
+            //different layouts do not match
+            TS_ASSERT(!PADcache::load(1, COUNT, SIZE/2, smps, basefreqs));
+            TS_ASSERT(!PADcache::load(2, COUNT, SIZE, smps, basefreqs));
+            //nor do more samples than a PADsynth instrument can have
+            TS_ASSERT(!PADcache::load(1, PAD_MAX_SAMPLES + 1, SIZE, smps,
+                                      basefreqs));
+        }
+
+        void testIncomplete() {
+            store(3, COUNT - 1);
+            TS_ASSERT(!PADcache::load(3, COUNT, SIZE, smps, basefreqs));
+        }
+
+        void testCorruption() {
+            store(4, COUNT);
+            FILE *f = fopen(file(4).c_str(), "r+b");
+            TS_ASSERT(f);
+            fseek(f, -16, SEEK_END);
+            fputc(0x55, f);
+            fclose(f);
+            TS_ASSERT(!PADcache::load(4, COUNT, SIZE, smps, basefreqs));
+            //the damaged file is gone
+            TS_ASSERT(!fopen(file(4).c_str(), "rb"));
+        }
+
+        void testEviction() {
+            //room for one file
+            PADcache::setLimit(6 * 4096);
+            store(5, COUNT);
+            store(6, COUNT);
+            TS_ASSERT(!PADcache::load(5, COUNT, SIZE, smps, basefreqs));
+            TS_ASSERT(PADcache::load(6, COUNT, SIZE, smps, basefreqs));
+            for(int n = 0; n < COUNT; ++n)
+                SampleMemory::dealloc(smps[n]);
+        }
+};
@@ -0,0 +1,165 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  PadKernelTest.h - CxxTest for the vectorized PADnote interpolation
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include "../Synth/PADKernels.h"
+#include "../Params/PADnoteParameters.h"
+#include "../globals.h"
+#include "KernelCompare.h"
+
+using namespace std;
+using namespace zyn;
+
+#define SMPSIZE (1 << 18)
+#define BUFSIZE 256
+
+class PadKernelTest:public CxxTest::TestSuite
+{
+    public:
+        float    *smps;
+        uint16_t *halfs;
+        int16_t  *ints;
+        float outl[BUFSIZE], outr[BUFSIZE], refl[BUFSIZE], refr[BUFSIZE];
+
+        void setUp() {
+            smps  = new float[SMPSIZE + 5];
+            halfs = new uint16_t[SMPSIZE + 5];
+            ints  = new int16_t[SMPSIZE + 5];
+            for(int i = 0; i < SMPSIZE; ++i)
+                smps[i] = 0.3f * sinf(2.0f * PI * 11 * i / SMPSIZE)
+                          + 0.05f * sinf(2.0f * PI * 5003 * i / SMPSIZE);
+            for(int i = 0; i < 5; ++i)
+                smps[SMPSIZE + i] = smps[i];
+            for(int i = 0; i < SMPSIZE + 5; ++i) {
+                halfs[i] = float2half(smps[i]);
+                ints[i]  = (int16_t)lrintf(smps[i] * 32767.0f / PAD_INT16_RANGE);
+            }
+        }
+
+        void tearDown() {
+            delete [] smps;
+            delete [] halfs;
+            delete [] ints;
+        }
+
+        float value(int format, int i) {
+            if(format == PAD_HALF)
+                return half2float(halfs[i]);
+            if(format == PAD_INT16)
+                return ints[i] * (PAD_INT16_RANGE / 32767.0f);
+            return smps[i];
+        }
+
+        const float *data(int format) {
+            if(format == PAD_HALF)
+                return (const float *)halfs;
+            if(format == PAD_INT16)
+                return (const float *)ints;
+            return smps;
+        }
+
+        //The loops PADnote used before the kernels existed
+        void scalar(int format, PADPhase &ph, int freqhi, float freqlo,
+                    bool cubic, int n) {
+            for(int i = 0; i < n; ++i) {
+                ph.hi_l += freqhi;
+                ph.hi_r += freqhi;
+                ph.lo   += freqlo;
+                if(ph.lo >= 1.0f) {
+                    ph.hi_l += 1;
+                    ph.hi_r += 1;
+                    ph.lo   -= 1.0f;
+                }
+                if(ph.hi_l >= SMPSIZE)
+                    ph.hi_l %= SMPSIZE;
+                if(ph.hi_r >= SMPSIZE)
+                    ph.hi_r %= SMPSIZE;
+                refl[i] = interpolate(format, ph.hi_l, ph.lo, cubic);
+                refr[i] = interpolate(format, ph.hi_r, ph.lo, cubic);
+            }
+        }
+
+        float interpolate(int format, int pos, float x, bool cubic) {
+            if(!cubic)
+                return value(format, pos) * (1.0f - x)
+                       + value(format, pos + 1) * x;
+            const float xm1 = value(format, pos);
+            const float x0  = value(format, pos + 1);
+            const float x1  = value(format, pos + 2);
+            const float x2  = value(format, pos + 3);
+            const float a   = (3.0f * (x0 - x1) - xm1 + x2) * 0.5f;
+            const float b   = 2.0f * x1 + xm1 - (5.0f * x0 + x2) * 0.5f;
+            const float c   = (x1 - xm1) * 0.5f;
+            return (((a * x) + b) * x + c) * x + x0;
+        }
+
+        void testMatchesScalar() {
+            const int sizes[] = {BUFSIZE, 13, 1};
+            for(int format = PAD_FLOAT; format <= PAD_INT16; ++format)
+                for(int cubic = 0; cubic < 2; ++cubic)
+                    for(int n : sizes) {
+                        PADPhase a = {100, 100 + SMPSIZE / 2, 0.25f}, b = a;
+                        for(int block = 0; block < 40; ++block) {
+                            padInterpolate(data(format), format, SMPSIZE, a,
+                                           3, 0.37f, cubic, outl, outr, n);
+                            scalar(format, b, 3, 0.37f, cubic, n);
+                            TS_ASSERT_LESS_THAN(maxError(outl, refl, n), 1e-4f);
+                            TS_ASSERT_LESS_THAN(maxError(outr, refr, n), 1e-4f);
+                            TS_ASSERT_EQUALS(a.hi_l, b.hi_l);
+                            TS_ASSERT_EQUALS(a.hi_r, b.hi_r);
+                            TS_ASSERT_DELTA(a.lo, b.lo, 1e-4f);
+                        }
+                    }
+        }
+
+        //High notes skip through the sample and wrap around its end often
+        void testWrap() {
+            PADPhase a = {SMPSIZE - 10, SMPSIZE - 1, 0.9f}, b = a;
+            for(int block = 0; block < 40; ++block) {
+                padInterpolate(smps, PAD_FLOAT, SMPSIZE, a, 5000, 0.75f, true,
+                               outl, outr, BUFSIZE);
+                scalar(PAD_FLOAT, b, 5000, 0.75f, true, BUFSIZE);
+                TS_ASSERT_LESS_THAN(maxError(outl, refl, BUFSIZE), 1e-4f);
+                TS_ASSERT_LESS_THAN(maxError(outr, refr, BUFSIZE), 1e-4f);
+                TS_ASSERT_EQUALS(a.hi_l, b.hi_l);
+                TS_ASSERT_EQUALS(a.hi_r, b.hi_r);
+            }
+        }
+
+        void testSpeed() {
+            const int blocks = 20000;
+            for(int cubic = 0; cubic < 2; ++cubic)
+                for(int format = PAD_FLOAT; format <= PAD_INT16; ++format) {
+                    PADPhase ph = {0, SMPSIZE / 2, 0.0f};
+
+                    int t_on = clock(); // timer before calling func
+                    for(int i = 0; i < blocks; ++i)
+                        scalar(format, ph, 1, 0.37f, cubic, BUFSIZE);
+                    int t_off = clock(); // timer when func returns
+                    const float s = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+                    t_on = clock(); // timer before calling func
+                    for(int i = 0; i < blocks; ++i)
+                        padInterpolate(data(format), format, SMPSIZE, ph, 1,
+                                       0.37f, cubic, outl, outr, BUFSIZE);
+                    t_off = clock(); // timer when func returns
+                    const float k = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+                    printf("PadKernelTest: %s, format %d, %f seconds scalar, "
+                           "%f seconds kernel (%.2fx)\n",
+                           cubic ? "cubic" : "linear", format, s, k,
+                           k > 0 ? s / k : 0.0f);
+                }
+        }
+};
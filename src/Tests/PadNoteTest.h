@@ -18,11 +18,18 @@
 #include <fstream>
 #include <ctime>
 #include <string>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 #define private public
 #include "../Misc/Master.h"
 #include "../Misc/Util.h"
 #include "../Misc/Allocator.h"
 #include "../Misc/XMLwrapper.h"
+#include "../Misc/PADpool.h"
+#include "../Misc/SampleMemory.h"
 #include "../Synth/PADnote.h"
 #include "../Synth/OscilGen.h"
 #include "../Params/PADnoteParameters.h"
@@ -265,6 +272,232 @@ class PadNoteTest:public CxxTest::TestSuite
 
         }
 
+        //Samples must not depend upon the threads which computed them
+        void testPoolMatchesSerial() {
+            PADnoteParameters::Sample serial[PAD_MAX_SAMPLES];
+            for(int i = 0; i < PAD_MAX_SAMPLES; ++i) {
+                serial[i] = pars->sample[i];
+                pars->sample[i].smp = NULL;
+                pars->sample[i].key = 0;
+            }
+
+            PADpool pool(3);
+            //Twice, so that the workspaces of the pool get reused
+            for(int k = 0; k < 2; ++k) {
+                pars->applyparameters([]{return false;}, 0, &pool);
+                for(int i = 0; i < PAD_MAX_SAMPLES; ++i) {
+                    TS_ASSERT_EQUALS(pars->sample[i].size, serial[i].size);
+                    if(!serial[i].smp)
+                        continue;
+                    TS_ASSERT_EQUALS(memcmp(pars->sample[i].smp, serial[i].smp,
+                                            serial[i].size * sizeof(float)), 0);
+                }
+            }
+
+            for(int i = 0; i < PAD_MAX_SAMPLES; ++i)
+                SampleMemory::dealloc(serial[i].smp);
+        }
+
+        //The workspaces are kept between batches and freed once the pool
+        //has been idle
+        void testPoolReleasesWorkspaces() {
+            PADpool pool(3, 100);
+            int fresh = 0;
+            auto job = [&fresh](PADpool::Workspace &ws, int) {
+                fresh += ws.size == 0;
+                ws.prepare(1024);
+            };
+            pool.run(job, 4, []{return false;}, 1);
+            pool.run(job, 4, []{return false;}, 1);
+            TS_ASSERT_EQUALS(fresh, 1);
+
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            pool.run(job, 4, []{return false;}, 1);
+            TS_ASSERT_EQUALS(fresh, 2);
+        }
+
+        void testAbort() {
+            PADpool pool(3);
+            std::atomic<int> generated(0);
+            pars->sampleGenerator([&generated](int, PADnoteParameters::Sample &s)
+                    {
+                        SampleMemory::dealloc(s.smp);
+                        generated++;
+                    }, [&generated]{return generated > 0;}, 0, &pool);
+            //Samples which were already being computed may still complete
+            TS_ASSERT_LESS_THAN(0, generated.load());
+            TS_ASSERT_LESS_THAN_EQUALS(generated.load(), pool.workers() + 1);
+        }
+
+        //Previews stand in for the full samples, slot by slot
+        void testPreview() {
+            TS_ASSERT_LESS_THAN(PADnoteParameters::PREVIEW_SIZE,
+                                pars->samplesize());
+            PADnoteParameters::Sample preview[PAD_MAX_SAMPLES];
+            memset(preview, 0, sizeof(preview));
+            PADpool pool(3);
+            typedef std::chrono::steady_clock clk;
+            clk::time_point t_on = clk::now();
+            int num = pars->previewGenerator([&preview]
+                    (int N, PADnoteParameters::Sample &s) {preview[N] = s;},
+                    []{return false;}, &pool);
+            const float tpreview =
+                std::chrono::duration<float>(clk::now() - t_on).count();
+
+            //The MiddleWare thread waits for the previews, which must come
+            //well ahead of the full samples (8x longer here)
+            t_on = clk::now();
+            pars->sampleGenerator([](int, PADnoteParameters::Sample &s)
+                    {SampleMemory::dealloc(s.smp);}, []{return false;}, 1);
+            const float tfull =
+                std::chrono::duration<float>(clk::now() - t_on).count();
+            printf("PadNoteTest: %f seconds preview, %f seconds full\n",
+                   tpreview, tfull);
+            TS_ASSERT_LESS_THAN(tpreview * 4, tfull);
+
+            for(int i = 0; i < PAD_MAX_SAMPLES; ++i) {
+                TS_ASSERT_EQUALS(preview[i].smp != NULL,
+                                 pars->sample[i].smp != NULL);
+                if(i >= num)
+                    continue;
+                TS_ASSERT_EQUALS(preview[i].size,
+                                 PADnoteParameters::PREVIEW_SIZE);
+                TS_ASSERT_EQUALS(preview[i].basefreq, pars->sample[i].basefreq);
+                //extra samples for the interpolation
+                TS_ASSERT_EQUALS(preview[i].smp[preview[i].size],
+                                 preview[i].smp[0]);
+                SampleMemory::dealloc(preview[i].smp);
+            }
+        }
+
+        //Only samples whose spectrum changes are computed again
+        void testIncremental() {
+            float *before[PAD_MAX_SAMPLES];
+            for(int i = 0; i < PAD_MAX_SAMPLES; ++i)
+                before[i] = pars->sample[i].smp;
+            pars->applyparameters([]{return false;}, 1);
+            for(int i = 0; i < PAD_MAX_SAMPLES; ++i)
+                TS_ASSERT_EQUALS(pars->sample[i].smp, before[i]);
+
+            //The 40th harmonic is beyond nyquist for the highest sample
+            pars->oscilgen->Phmag[39] = 80;
+            pars->oscilgen->prepare();
+            pars->applyparameters([]{return false;}, 1);
+
+            int last = 0;
+            while(last + 1 < PAD_MAX_SAMPLES && pars->sample[last + 1].smp)
+                ++last;
+            TS_ASSERT_LESS_THAN(0, last);
+            TS_ASSERT_DIFFERS(pars->sample[0].smp, before[0]);
+            TS_ASSERT_EQUALS(pars->sample[last].smp, before[last]);
+        }
+
+        //Lazy generation computes single samples and learns the played keys
+        void testLazy() {
+            std::vector<int> generated;
+            int num = pars->sampleGenerator([&generated]
+                    (int N, PADnoteParameters::Sample &s) {
+                        generated.push_back(N);
+                        SampleMemory::dealloc(s.smp);
+                    }, []{return false;}, 1, NULL, NULL, (uint64_t)1 << 2);
+            TS_ASSERT_LESS_THAN(2, num);
+            TS_ASSERT_EQUALS(generated.size(), 1u);
+            TS_ASSERT_EQUALS(generated[0], 2);
+
+            float freqs[PAD_MAX_SAMPLES];
+            TS_ASSERT_EQUALS(pars->samplefreqs(freqs), num);
+            for(int i = 0; i < num; ++i)
+                TS_ASSERT_EQUALS(freqs[i], pars->sample[i].basefreq);
+
+            //Only notes of lazy instruments are recorded
+            TS_ASSERT_EQUALS(pars->playedkeys[0].load(), 0u);
+            TS_ASSERT_EQUALS(pars->playedkeys[1].load(), 0u);
+            pars->Plazy = true;
+            float freq = 440.0f * powf(2.0f, (testnote - 69.0f) / 12.0f);
+            SynthParams pars_{memory, *controller, *synth, *time, freq, 120,
+                              0, testnote, false};
+            PADnote n(pars, pars_, interpolation);
+            TS_ASSERT_EQUALS(pars->playedkeys[0].load(),
+                             (uint64_t)1 << testnote);
+            TS_ASSERT_EQUALS(pars->playedkeys[1].load(), 0u);
+        }
+
+        //Renders a few buffers of a note from the current samples
+        void render(float *out, int nbuffers, int interp) {
+            RandomStream rng(42); //same start position for each note
+            float freq = 440.0f * powf(2.0f, (testnote - 69.0f) / 12.0f);
+            SynthParams pars_{memory, *controller, *synth, *time, freq, 120,
+                              0, testnote, false, &rng};
+            PADnote n(pars, pars_, interp);
+            for(int k = 0; k < nbuffers; ++k) {
+                n.noteout(outL, outR);
+                memcpy(out + k * synth->buffersize, outL,
+                       synth->buffersize * sizeof(float));
+            }
+        }
+
+        //Signal to noise ratio of out with respect to ref in dB
+        static float snr(const float *ref, const float *out, int n) {
+            double sig = 0.0, err = 0.0;
+            for(int i = 0; i < n; ++i) {
+                sig += ref[i] * ref[i];
+                err += (ref[i] - out[i]) * (ref[i] - out[i]);
+            }
+            return 10.0f * log10f(sig / (err + 1e-30));
+        }
+
+        //16 bit storage has to sound like the float samples
+        void testStorage() {
+            const int nbuffers = 16;
+            const int n = nbuffers * synth->buffersize;
+            float *ref[2], *out = new float[n];
+            for(int interp = 0; interp < 2; ++interp) {
+                ref[interp] = new float[n];
+                render(ref[interp], nbuffers, interp);
+            }
+
+            const int formats[] = {PAD_HALF, PAD_INT16};
+            for(int format : formats) {
+                pars->Pquality.storage = format;
+                pars->applyparameters([]{return false;}, 1);
+                TS_ASSERT_EQUALS(pars->sample[0].format, format);
+                TS_ASSERT_DELTA(pars->sample[0].value(0), -0.057407f, 0.0005f);
+                //extra samples for the interpolation
+                TS_ASSERT_EQUALS(pars->sample[0].value(pars->sample[0].size),
+                                 pars->sample[0].value(0));
+
+                for(int interp = 0; interp < 2; ++interp) {
+                    render(out, nbuffers, interp);
+                    const float db = snr(ref[interp], out, n);
+                    printf("PadNoteTest: storage %d, interpolation %d: "
+                           "SNR %.1f dB\n", format, interp, db);
+                    TS_ASSERT_LESS_THAN(60.0f, db);
+                }
+            }
+
+            delete [] ref[0];
+            delete [] ref[1];
+            delete [] out;
+        }
+
+        //The samples are in RAM before the realtime thread reads them
+        void testSampleMemory() {
+            const SampleMemory::Stats before = SampleMemory::stats();
+            SampleMemory::Stats s = {0, 0, 0, 0, 0};
+            for(int i = 0; i < PAD_MAX_SAMPLES; ++i)
+                SampleMemory::stats(pars->sample[i].smp, s);
+            TS_ASSERT_LESS_THAN(0u, s.tables);
+            TS_ASSERT_LESS_THAN_EQUALS(s.tables, before.tables);
+            TS_ASSERT_LESS_THAN_EQUALS((uint64_t)pars->sample[0].size
+                                       * sizeof(float), s.bytes);
+            TS_ASSERT_EQUALS(s.resident, s.bytes);
+
+            pars->defaults();
+            const SampleMemory::Stats after = SampleMemory::stats();
+            TS_ASSERT_EQUALS(after.tables, before.tables - s.tables);
+            TS_ASSERT_EQUALS(after.bytes, before.bytes - s.bytes);
+        }
+
 #define OUTPUT_PROFILE
 #ifdef OUTPUT_PROFILE
         void testSpeed() {
@@ -28,4 +28,70 @@ class RandTest:public CxxTest::TestSuite
             TS_ASSERT_DELTA(RND, 0.286319, 0.00001);
             TS_ASSERT_DELTA(RND, 0.511766, 0.00001);
         }
+
+        void testStream(void) {
+            //A fresh stream follows the same pattern
+            RandomStream r(0x1234);
+            TS_ASSERT_DELTA(r.rnd(), 0.607781, 0.00001);
+            TS_ASSERT_DELTA(r.rnd(), 0.591761, 0.00001);
+
+            //bound streams advance the global state
+            sprng(0x1234);
+            RandomStream g = RandomStream::global();
+            TS_ASSERT_DELTA(g.rnd(), 0.607781, 0.00001);
+            TS_ASSERT_DELTA(RND, 0.591761, 0.00001);
+            TS_ASSERT_DELTA(g.rnd(), 0.186133, 0.00001);
+        }
+
+        void testStreamFill(void) {
+            float a[101], b[101];
+            RandomStream r1(42), r2(42);
+            r1.fill(a, 101);
+            for(int i = 0; i < 101; ++i)
+                b[i] = r2.rnd();
+            for(int i = 0; i < 101; ++i)
+                TS_ASSERT_EQUALS(a[i], b[i]);
+            TS_ASSERT_EQUALS(r1.next(), r2.next());
+        }
+
+        void testStreamWhite(void) {
+            float a[101];
+            RandomStream r1(42), r2(42);
+            r1.white(a, 101);
+            for(int i = 0; i < 101; ++i)
+                TS_ASSERT_DELTA(a[i], r2.rnd() * 2.0f - 1.0f, 1e-6);
+            TS_ASSERT_EQUALS(r1.next(), r2.next());
+        }
+
+        //the pink noise follows Paul Kellet's filter, also across calls
+        void testStreamPink(void) {
+            float a[300], state[PINK_STATE] = {0};
+            double f[7] = {0};
+            RandomStream r1(42), r2(42);
+            r1.pink(a, 101, state);
+            r1.pink(a + 101, 199, state);
+            for(int i = 0; i < 300; ++i) {
+                double white = (r2.rnd() - 0.5) / 4.0;
+                f[0] = 0.99886 * f[0] + white * 0.0555179;
+                f[1] = 0.99332 * f[1] + white * 0.0750759;
+                f[2] = 0.96900 * f[2] + white * 0.1538520;
+                f[3] = 0.86650 * f[3] + white * 0.3104856;
+                f[4] = 0.55000 * f[4] + white * 0.5329522;
+                f[5] = -0.7616 * f[5] - white * 0.0168980;
+                const double pink = f[0] + f[1] + f[2] + f[3] + f[4] + f[5]
+                                    + f[6] + white * 0.5362;
+                f[6] = white * 0.115926;
+                TS_ASSERT_DELTA(a[i], pink, 1e-5);
+            }
+            TS_ASSERT_EQUALS(r1.next(), r2.next());
+        }
+
+        void testStreamSplit(void) {
+            RandomStream r1(7), r2(7);
+            RandomStream c1 = r1.split(), c2 = r2.split();
+            TS_ASSERT_EQUALS(c1.next(), c2.next());
+            //the child does not shadow its parent
+            RandomStream d = r1.split();
+            TS_ASSERT_DIFFERS(c1.next(), d.next());
+        }
 };
@@ -0,0 +1,200 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  RenderPoolTest.h - CxxTest for parallel part rendering
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <cstring>
+#include <atomic>
+#include <algorithm>
+#include <thread>
+#include "../Misc/RenderPool.h"
+#include "../DSP/FFTwrapper.h"
+#include "../Misc/Master.h"
+#include "../Misc/Config.h"
+#include "../Misc/Util.h"
+#include "../globals.h"
+
+using namespace std;
+using namespace zyn;
+
+char *instance_name=(char*)"";
+
+#define PARTS 8
+
+class RenderPoolTest:public CxxTest::TestSuite
+{
+    public:
+        Config config;
+        SYNTH_T *synth;
+        Master  *serial;
+        Master  *threaded;
+        Master  *notes;
+        float   *outL[3], *outR[3];
+
+        void setUp() {
+            synth = new SYNTH_T;
+            synth->buffersize = 256;
+            synth->samplerate = 48000;
+            synth->alias();
+
+            //Threaded masters always use per part random streams
+            config.cfg.RandomStreams = 1;
+            config.cfg.RenderThreads = 0;
+            //The streams are seeded from prng(), so start every master alike
+            sprng(0x1234);
+            serial   = new Master(*synth, &config);
+            config.cfg.RenderThreads = 3;
+            sprng(0x1234);
+            threaded = new Master(*synth, &config);
+            config.cfg.RenderNotes   = 1;
+            sprng(0x1234);
+            notes    = new Master(*synth, &config);
+            config.cfg.RenderThreads = 0;
+            config.cfg.RenderNotes   = 0;
+            config.cfg.RandomStreams = 0;
+
+            for(int i = 0; i < 3; ++i) {
+                outL[i] = new float[synth->buffersize];
+                outR[i] = new float[synth->buffersize];
+            }
+        }
+
+        void tearDown() {
+            delete serial;
+            delete threaded;
+            delete notes;
+            for(int i = 0; i < 3; ++i) {
+                delete [] outL[i];
+                delete [] outR[i];
+            }
+            delete synth;
+        }
+
+        static void countJob(void *data, int idx)
+        {
+            ((std::atomic<int>*)data)[idx]++;
+        }
+
+        void testEveryJobRunsOnce() {
+            RenderPool pool(3);
+            std::atomic<int> counts[64];
+            for(int njobs = 0; njobs < 64; ++njobs) {
+                for(int i = 0; i < 64; ++i)
+                    counts[i] = 0;
+                pool.run(countJob, counts, njobs);
+                for(int i = 0; i < 64; ++i)
+                    TS_ASSERT_EQUALS(counts[i].load(), i < njobs ? 1 : 0);
+            }
+        }
+
+        void testSerialPool() {
+            RenderPool pool(0);
+            TS_ASSERT_EQUALS(pool.workers(), 0);
+            std::atomic<int> counts[4];
+            for(int i = 0; i < 4; ++i)
+                counts[i] = 0;
+            pool.run(countJob, counts, 4);
+            for(int i = 0; i < 4; ++i)
+                TS_ASSERT_EQUALS(counts[i].load(), 1);
+        }
+
+        //a single core is left to the audio thread
+        void testSingleCore() {
+            RenderPool pool(3, 1);
+            TS_ASSERT_EQUALS(pool.workers(), 0);
+            std::atomic<int> counts[4];
+            for(int i = 0; i < 4; ++i)
+                counts[i] = 0;
+            pool.run(countJob, counts, 4);
+            for(int i = 0; i < 4; ++i)
+                TS_ASSERT_EQUALS(counts[i].load(), 1);
+            TS_ASSERT_EQUALS(RenderPool(3, 4).workers(), 3);
+        }
+
+        struct FFTJob {
+            FFTwrapper *fft;
+            int         thread[64];
+            float       error[64];
+        };
+
+        static void fftJob(void *data, int idx)
+        {
+            FFTJob &job = *(FFTJob*)data;
+            float   smps[256], back[256];
+            fft_t   freqs[128];
+            job.thread[idx] = RenderPool::current();
+            job.error[idx]  = 0;
+            for(int k = 0; k < 50; ++k) {
+                for(int i = 0; i < 256; ++i)
+                    smps[i] = sinf(i * (idx + 1) * 2 * PI / 256);
+                job.fft->smps2freqs(smps, freqs);
+                job.fft->freqs2smps(freqs, back);
+                for(int i = 0; i < 256; ++i)
+                    job.error[idx] = std::max(job.error[idx],
+                                              fabsf(back[i] / 256 - smps[i]));
+            }
+        }
+
+        //render threads know their index and transform on buffers of their
+        //own, as do the threads outside of rendering
+        void testSharedFFT() {
+            RenderPool pool(3, 4);
+            FFTwrapper fft(256);
+            fft.shareWithRenderThreads(pool.workers());
+            FFTJob job;
+            job.fft = &fft;
+
+            std::thread([&job]{fftJob(&job, 0);}).join();
+            TS_ASSERT_EQUALS(job.thread[0], -1);
+            TS_ASSERT_LESS_THAN(job.error[0], 1e-4f);
+
+            RenderPool::audiothread();
+            pool.run(fftJob, &job, 64);
+            for(int i = 0; i < 64; ++i) {
+                TS_ASSERT(job.thread[i] >= 0 && job.thread[i] <= 3);
+                TS_ASSERT_LESS_THAN(job.error[i], 1e-4f);
+            }
+        }
+
+        //Output must not depend upon how parts were scheduled
+        void testMatchesSerialRendering() {
+            Master *m[3] = {serial, threaded, notes};
+            for(int k = 0; k < 3; ++k) {
+                sprng(0x1234);
+                for(int p = 0; p < PARTS; ++p) {
+                    m[k]->partonoff(p, 1);
+                    m[k]->noteOn(p, 40 + 5*p, 100);
+                }
+                //A chord on a single part for per note rendering
+                for(int n = 0; n < 6; ++n)
+                    m[k]->noteOn(0, 60 + 3*n, 100);
+            }
+
+            float sum = 0.0f;
+            for(int block = 0; block < 100; ++block) {
+                for(int k = 0; k < 3; ++k)
+                    m[k]->AudioOut(outL[k], outR[k]);
+                for(int i = 0; i < synth->buffersize; ++i)
+                    sum += fabs(outL[0][i]);
+                for(int k = 1; k < 3; ++k) {
+                    TS_ASSERT_EQUALS(memcmp(outL[0], outL[k],
+                                            synth->bufferbytes), 0);
+                    TS_ASSERT_EQUALS(memcmp(outR[0], outR[k],
+                                            synth->bufferbytes), 0);
+                }
+                if(block == 50)
+                    for(int k = 0; k < 3; ++k)
+                        for(int p = 0; p < PARTS; ++p)
+                            m[k]->noteOff(p, 40 + 5*p);
+            }
+            TS_ASSERT_LESS_THAN(0.1f, sum);
+        }
+};
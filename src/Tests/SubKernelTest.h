@@ -0,0 +1,201 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  SubKernelTest.h - CxxTest for the vectorized SUBnote filter banks
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include "../Synth/SUBKernels.h"
+#include "../globals.h"
+#include "KernelCompare.h"
+
+using namespace std;
+using namespace zyn;
+
+#define BUFSIZE 256
+#define HARMONICS 64
+#define NBANKS (HARMONICS / SUB_LANES)
+
+class SubKernelTest:public CxxTest::TestSuite
+{
+    public:
+        //the filters as SUBnote kept them before the banks
+        struct Filter {
+            float b0, b2, a1, a2, xn1, xn2, yn1, yn2;
+        };
+
+        SUBBank *banks;
+        Filter ref[HARMONICS][SUB_MAX_STAGES];
+        float   gain[HARMONICS];
+        float   in[BUFSIZE], out[BUFSIZE], refout[BUFSIZE], tmp[BUFSIZE];
+
+        void setUp() {
+            banks = new SUBBank[NBANKS]();
+            for(int h = 0; h < HARMONICS; ++h) {
+                const float freq  = 110.0f * (h + 1);
+                const float bw    = 0.001f * (1 + h % 7);
+                const float omega = 2.0f * PI * freq / 44100.0f;
+                const float sn    = sinf(omega);
+                const float cs    = cosf(omega);
+                float alpha = sn * sinh(LOG_2 / 2.0f * bw * omega / sn);
+                if(alpha > bw)
+                    alpha = bw;
+                gain[h] = 1.0f / (h + 1);
+                for(int s = 0; s < SUB_MAX_STAGES; ++s) {
+                    Filter &f = ref[h][s];
+                    f.b0  = alpha / (1.0f + alpha) * 2.0f;
+                    f.b2  = -f.b0;
+                    f.a1  = -2.0f * cs / (1.0f + alpha);
+                    f.a2  = (1.0f - alpha) / (1.0f + alpha);
+                    f.xn1 = f.xn2 = f.yn1 = f.yn2 = 0.0f;
+
+                    SUBBank &b = banks[h / SUB_LANES];
+                    const int l = h % SUB_LANES;
+                    b.b0[s][l] = f.b0;
+                    b.b2[s][l] = f.b2;
+                    b.a1[s][l] = f.a1;
+                    b.a2[s][l] = f.a2;
+                }
+                banks[h / SUB_LANES].gain[h % SUB_LANES] = gain[h];
+            }
+            srand(7);
+            for(int i = 0; i < BUFSIZE; ++i)
+                in[i] = rand() / (RAND_MAX + 1.0f) * 2.0f - 1.0f;
+        }
+
+        void tearDown() {
+            delete[] banks;
+        }
+
+        void scalar(const float *src, int nharmonics, int nstages, int n) {
+            for(int i = 0; i < n; ++i)
+                refout[i] = 0.0f;
+            for(int h = 0; h < nharmonics; ++h) {
+                for(int i = 0; i < n; ++i)
+                    tmp[i] = src[i];
+                for(int s = 0; s < nstages; ++s) {
+                    Filter &f = ref[h][s];
+                    for(int i = 0; i < n; ++i) {
+                        const float y = tmp[i] * f.b0 + f.b2 * f.xn2
+                                        - f.a1 * f.yn1 - f.a2 * f.yn2;
+                        f.xn2  = f.xn1;
+                        f.xn1  = tmp[i];
+                        f.yn2  = f.yn1;
+                        f.yn1  = y;
+                        tmp[i] = y;
+                    }
+                }
+                for(int i = 0; i < n; ++i)
+                    refout[i] += tmp[i] * gain[h];
+            }
+        }
+
+        void testMatchesScalar() {
+            const int sizes[] = {BUFSIZE, 45, 1};
+            //an odd number of banks has one filtered on its own
+            const int counts[] = {NBANKS, 3, 1};
+            for(int nb : counts)
+                for(int n : sizes) {
+                    tearDown();
+                    setUp();
+                    for(int block = 0; block < 40; ++block) {
+                        for(int i = 0; i < n; ++i)
+                            out[i] = 0.0f;
+                        subFilterBanks(banks, nb, SUB_MAX_STAGES, in, out, n);
+                        scalar(in, nb * SUB_LANES, SUB_MAX_STAGES, n);
+                        const float tol = 1e-3f * fmaxf(1.0f, peak(refout, n));
+                        TS_ASSERT_LESS_THAN(maxError(out, refout, n), tol);
+                    }
+                }
+        }
+
+        //lanes without gain do not reach the output
+        void testSilentLanes() {
+            for(int l = 0; l < SUB_LANES; ++l)
+                banks[0].gain[l] = 0.0f;
+            for(int i = 0; i < BUFSIZE; ++i)
+                out[i] = 0.0f;
+            subFilterBanks(banks, 1, 3, in, out, BUFSIZE);
+            for(int i = 0; i < BUFSIZE; ++i)
+                TS_ASSERT_EQUALS(out[i], 0.0f);
+        }
+
+        //ramped coefficients step once per sub-block and end on the targets
+        void testRamp() {
+            const int steps = 2 * BUFSIZE / SUB_BLOCK;
+            Filter from[HARMONICS][SUB_MAX_STAGES];
+            for(int h = 0; h < HARMONICS; ++h)
+                for(int s = 0; s < SUB_MAX_STAGES; ++s)
+                    from[h][s] = ref[h][s];
+            for(int k = 0; k < NBANKS; ++k)
+                subRampBank(banks[k], SUB_MAX_STAGES, steps, [&]() {
+                    for(int l = 0; l < SUB_LANES; ++l)
+                        for(int s = 0; s < SUB_MAX_STAGES; ++s) {
+                            banks[k].b0[s][l] *= 0.5f;
+                            banks[k].b2[s][l] *= 0.5f;
+                            banks[k].a1[s][l] *= 0.99f;
+                        }
+                });
+
+            for(int block = 0; block < 3; ++block) {
+                for(int i = 0; i < BUFSIZE; ++i)
+                    out[i] = 0.0f;
+                subFilterBanks(banks, NBANKS, SUB_MAX_STAGES, in, out,
+                               BUFSIZE);
+                float all[BUFSIZE];
+                for(int j = 0; j < BUFSIZE; j += SUB_BLOCK) {
+                    const int step = block * BUFSIZE / SUB_BLOCK
+                                     + j / SUB_BLOCK + 1;
+                    const float t = step < steps ? (float)step / steps : 1;
+                    for(int h = 0; h < HARMONICS; ++h)
+                        for(int s = 0; s < SUB_MAX_STAGES; ++s) {
+                            const Filter &f = from[h][s];
+                            ref[h][s].b0 = f.b0 + (f.b0 * 0.5f - f.b0) * t;
+                            ref[h][s].b2 = f.b2 + (f.b2 * 0.5f - f.b2) * t;
+                            ref[h][s].a1 = f.a1 + (f.a1 * 0.99f - f.a1) * t;
+                        }
+                    scalar(in + j, HARMONICS, SUB_MAX_STAGES, SUB_BLOCK);
+                    for(int i = 0; i < SUB_BLOCK; ++i)
+                        all[j + i] = refout[i];
+                }
+                const float tol = 1e-3f * peak(all, BUFSIZE);
+                TS_ASSERT_LESS_THAN(maxError(out, all, BUFSIZE), tol);
+            }
+
+            for(int k = 0; k < NBANKS; ++k) {
+                TS_ASSERT_EQUALS(banks[k].ramp, 0);
+                TS_ASSERT_EQUALS(banks[k].b0[0][0], from[k * SUB_LANES][0].b0
+                                                    * 0.5f);
+            }
+        }
+
+        void testSpeed() {
+            const int blocks = 5000;
+
+            int t_on = clock(); // timer before calling func
+            for(int i = 0; i < blocks; ++i)
+                scalar(in, HARMONICS, SUB_MAX_STAGES, BUFSIZE);
+            int t_off = clock(); // timer when func returns
+            const float s = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+            t_on = clock(); // timer before calling func
+            for(int i = 0; i < blocks; ++i)
+                subFilterBanks(banks, NBANKS, SUB_MAX_STAGES, in, out,
+                               BUFSIZE);
+            t_off = clock(); // timer when func returns
+            const float k = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+            printf("SubKernelTest: %d harmonics, %f seconds scalar, "
+                   "%f seconds kernel (%.2fx)\n", HARMONICS, s, k,
+                   k > 0 ? s / k : 0.0f);
+        }
+};
@@ -0,0 +1,358 @@
+/*
+  ZynAddSubFX - a software synthesizer
+
+  UnisonKernelTest.h - CxxTest for the vectorized unison oscillator
+  Copyright (C) 2026 agent
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+*/
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include "../Synth/OscilKernels.h"
+#include "../globals.h"
+#include "KernelCompare.h"
+
+using namespace std;
+using namespace zyn;
+
+#define OSCILSIZE 1024
+#define BUFSIZE   256
+#define MAXVOICES 11
+
+class UnisonKernelTest:public CxxTest::TestSuite
+{
+    public:
+        float *smps;
+        float *out[MAXVOICES], *ref[MAXVOICES];
+        float outl[BUFSIZE], outr[BUFSIZE], refl[BUFSIZE], refr[BUFSIZE];
+
+        void setUp() {
+            smps = new float[OSCILSIZE + 1];
+            for(int i = 0; i < OSCILSIZE; ++i)
+                smps[i] = sinf(2.0f * PI * i / OSCILSIZE)
+                          + 0.3f * sinf(2.0f * PI * 7 * i / OSCILSIZE);
+            smps[OSCILSIZE] = smps[0];
+            for(int k = 0; k < MAXVOICES; ++k) {
+                out[k] = new float[BUFSIZE];
+                ref[k] = new float[BUFSIZE];
+            }
+        }
+
+        void tearDown() {
+            delete [] smps;
+            for(int k = 0; k < MAXVOICES; ++k) {
+                delete [] out[k];
+                delete [] ref[k];
+            }
+        }
+
+        //The loop ADnote used before the kernels existed
+        void scalarOscil(UnisonPhase &ph, int nvoices, float **dst) {
+            for(int k = 0; k < nvoices; ++k) {
+                int poshi = ph.hi[k], poslo = ph.lo[k];
+                for(int i = 0; i < BUFSIZE; ++i) {
+                    dst[k][i] = (smps[poshi] * ((1<<24) - poslo)
+                                 + smps[poshi + 1] * poslo)/(1.0f*(1<<24));
+                    poslo += ph.freqlo[k];
+                    poshi += ph.freqhi[k] + (poslo>>24);
+                    poslo &= 0xffffff;
+                    poshi &= OSCILSIZE - 1;
+                }
+                ph.hi[k] = poshi;
+                ph.lo[k] = poslo;
+            }
+        }
+
+        void initPhase(UnisonPhase &ph, int nvoices) {
+            for(int k = 0; k < nvoices; ++k) {
+                ph.hi[k]     = (k * 97) % OSCILSIZE;
+                ph.lo[k]     = (k * 0x12345) & 0xffffff;
+                ph.freqhi[k] = 3 + k % 4;
+                ph.freqlo[k] = (0x7654321 * (k + 1)) & 0xffffff;
+            }
+        }
+
+        void testOscilMatchesScalar() {
+            for(int nvoices = 1; nvoices <= OSCIL_LANES; ++nvoices) {
+                UnisonPhase a, b;
+                initPhase(a, nvoices);
+                initPhase(b, nvoices);
+                for(int block = 0; block < 20; ++block) {
+                    oscilLinear(smps, OSCILSIZE - 1, a, nvoices, out, BUFSIZE);
+                    scalarOscil(b, nvoices, ref);
+                    for(int k = 0; k < nvoices; ++k) {
+                        TS_ASSERT_LESS_THAN(maxError(out[k], ref[k], BUFSIZE),
+                                            1e-4f);
+                        TS_ASSERT_EQUALS(a.hi[k], b.hi[k]);
+                        TS_ASSERT_EQUALS(a.lo[k], b.lo[k]);
+                    }
+                }
+            }
+        }
+
+        //ADnote's phase modulated carrier loop
+        void scalarModulated(UnisonPhase &ph, const int32_t *offset,
+                             int nvoices, float **tw) {
+            for(int k = 0; k < nvoices; ++k) {
+                int poshi = ph.hi[k], poslo = ph.lo[k];
+                for(int i = 0; i < BUFSIZE; ++i) {
+                    int FMmodfreqhi = 0;
+                    F2I(tw[k][i], FMmodfreqhi);
+                    float FMmodfreqlo = tw[k][i]-FMmodfreqhi;
+                    if(FMmodfreqhi < 0)
+                        FMmodfreqlo++;
+
+                    int carposhi = poshi + FMmodfreqhi;
+                    int carposlo = poslo + FMmodfreqlo;
+                    carposhi += offset[k];
+                    if(carposlo >= (1<<24)) {
+                        carposhi++;
+                        carposlo &= 0xffffff;
+                    }
+                    carposhi &= (OSCILSIZE - 1);
+
+                    tw[k][i] = (smps[carposhi] * ((1<<24) - carposlo)
+                                + smps[carposhi + 1] * carposlo)/(1.0f*(1<<24));
+
+                    poslo += ph.freqlo[k];
+                    if(poslo >= (1<<24)) {
+                        poslo &= 0xffffff;
+                        poshi++;
+                    }
+                    poshi += ph.freqhi[k];
+                    poshi &= OSCILSIZE - 1;
+                }
+                ph.hi[k] = poshi;
+                ph.lo[k] = poslo;
+            }
+        }
+
+        //ADnote's MIX and RING_MOD loops
+        void scalarModulator(ModulatorPhase &ph, int nvoices, float **tw,
+                             float ampold, float ampnew, bool ring) {
+            for(int k = 0; k < nvoices; ++k) {
+                int   poshiFM = ph.hi[k];
+                float posloFM = ph.lo[k];
+                for(int i = 0; i < BUFSIZE; ++i) {
+                    float amp = INTERPOLATE_AMPLITUDE(ampold, ampnew, i,
+                                                      BUFSIZE);
+                    if(ring)
+                        tw[k][i] *= (smps[poshiFM] * (1.0f - posloFM)
+                                     + smps[poshiFM + 1] * posloFM) * amp
+                                    + (1.0f - amp);
+                    else
+                        tw[k][i] = tw[k][i] * (1.0f - amp) + amp
+                                   * (smps[poshiFM] * (1 - posloFM)
+                                      + smps[poshiFM + 1] * posloFM);
+                    posloFM += ph.freqlo[k];
+                    if(posloFM >= 1.0f) {
+                        posloFM -= 1.0f;
+                        poshiFM++;
+                    }
+                    poshiFM += ph.freqhi[k];
+                    poshiFM &= OSCILSIZE - 1;
+                }
+                ph.hi[k] = poshiFM;
+                ph.lo[k] = posloFM;
+            }
+        }
+
+        //Modulation of a few samples, both signs and whole numbers
+        void fillModulation(int nvoices) {
+            for(int k = 0; k < nvoices; ++k)
+                for(int i = 0; i < BUFSIZE; ++i)
+                    out[k][i] = ref[k][i] = (i % 37 == 0) ? (float)(i % 5 - 2)
+                        : 40.0f * sinf(0.03f * i + k);
+        }
+
+        void testModulatedMatchesScalar() {
+            const int32_t offset[OSCIL_LANES] = {0, 300, 0, 300,
+                                                 0, 300, 0, 300};
+            for(int nvoices = 1; nvoices <= OSCIL_LANES; ++nvoices) {
+                UnisonPhase a, b;
+                initPhase(a, nvoices);
+                initPhase(b, nvoices);
+                for(int block = 0; block < 20; ++block) {
+                    fillModulation(nvoices);
+                    oscilModulated(smps, OSCILSIZE - 1, a, offset, nvoices,
+                                   out, BUFSIZE);
+                    scalarModulated(b, offset, nvoices, ref);
+                    for(int k = 0; k < nvoices; ++k) {
+                        TS_ASSERT_LESS_THAN(maxError(out[k], ref[k], BUFSIZE),
+                                            1e-4f);
+                        TS_ASSERT_EQUALS(a.hi[k], b.hi[k]);
+                        TS_ASSERT_EQUALS(a.lo[k], b.lo[k]);
+                    }
+                }
+            }
+        }
+
+        void testModulatorMatchesScalar() {
+            for(int ring = 0; ring < 2; ++ring)
+                for(int nvoices = 1; nvoices <= OSCIL_LANES; ++nvoices) {
+                    ModulatorPhase a, b;
+                    for(int k = 0; k < nvoices; ++k) {
+                        a.hi[k]     = b.hi[k]     = (k * 131) % OSCILSIZE;
+                        a.lo[k]     = b.lo[k]     = 0.1f * k;
+                        a.freqhi[k] = b.freqhi[k] = 2 + k % 3;
+                        a.freqlo[k] = b.freqlo[k] = 0.37f + 0.05f * k;
+                    }
+                    for(int block = 0; block < 20; ++block) {
+                        fillModulation(nvoices);
+                        modulatorMix(smps, OSCILSIZE - 1, a, nvoices, out,
+                                     BUFSIZE, 0.2f, 0.9f, ring);
+                        scalarModulator(b, nvoices, ref, 0.2f, 0.9f, ring);
+                        for(int k = 0; k < nvoices; ++k) {
+                            TS_ASSERT_LESS_THAN(maxError(out[k], ref[k],
+                                                         BUFSIZE), 1e-4f);
+                            TS_ASSERT_EQUALS(a.hi[k], b.hi[k]);
+                            TS_ASSERT_EQUALS(a.lo[k], b.lo[k]);
+                        }
+                    }
+                }
+        }
+
+        void testFmIntegrate() {
+            const float normalize = OSCILSIZE / 262144.0f;
+            //Large enough to wrap around a few times
+            for(int i = 0; i < BUFSIZE; ++i)
+                out[0][i] = ref[0][i] = 2e6f * sinf(0.05f * i);
+            float a = 3.0f, b = 3.0f;
+            fmIntegrate(out[0], a, normalize, OSCILSIZE, BUFSIZE);
+            for(int i = 0; i < BUFSIZE; ++i) {
+                b = fmod(b + ref[0][i] * normalize, OSCILSIZE);
+                ref[0][i] = b;
+            }
+            TS_ASSERT_LESS_THAN(maxError(out[0], ref[0], BUFSIZE), 1e-3f);
+            TS_ASSERT_DELTA(a, b, 1e-3f);
+        }
+
+        void testMixMatchesScalar() {
+            float lvol[MAXVOICES], rvol[MAXVOICES];
+            for(int k = 0; k < MAXVOICES; ++k) {
+                lvol[k] = 1.0f - k * 0.1f;
+                rvol[k] = (k % 2 ? -1.0f : 1.0f) * k * 0.1f;
+                for(int i = 0; i < BUFSIZE; ++i)
+                    out[k][i] = sinf(0.01f * i * (k + 1));
+            }
+
+            //A length which is not a multiple of the block size
+            const int n = BUFSIZE - 3;
+            for(int nvoices = 1; nvoices <= MAXVOICES; ++nvoices) {
+                memset(outl, 0, sizeof(outl));
+                memset(outr, 0, sizeof(outr));
+                memset(refl, 0, sizeof(refl));
+                memset(refr, 0, sizeof(refr));
+                unisonMix(out, lvol, rvol, nvoices, outl, outr, n);
+                for(int k = 0; k < nvoices; ++k) {
+                    for(int i = 0; i < n; ++i)
+                        refl[i] += out[k][i] * lvol[k];
+                    for(int i = 0; i < n; ++i)
+                        refr[i] += out[k][i] * rvol[k];
+                }
+                TS_ASSERT_LESS_THAN(maxError(outl, refl, n), 1e-4f);
+                TS_ASSERT_LESS_THAN(maxError(outr, refr, n), 1e-4f);
+
+                //Mono output leaves the right channel alone
+                memset(outl, 0, sizeof(outl));
+                unisonMix(out, lvol, rvol, nvoices, outl, NULL, n);
+                TS_ASSERT_LESS_THAN(maxError(outl, refl, n), 1e-4f);
+            }
+        }
+
+        static void report(const char *what, float scalar, float kernel) {
+            printf("UnisonKernelTest: %d voices, %f seconds scalar%s, "
+                   "%f seconds kernel%s (%.2fx)\n", OSCIL_LANES, scalar, what,
+                   kernel, what, kernel > 0 ? scalar / kernel : 0.0f);
+        }
+
+        void testSpeed() {
+            const int blocks = 20000;
+            UnisonPhase ph;
+            initPhase(ph, OSCIL_LANES);
+
+            int t_on = clock(); // timer before calling func
+            for(int i = 0; i < blocks; ++i)
+                scalarOscil(ph, OSCIL_LANES, ref);
+            int t_off = clock(); // timer when func returns
+            const float scalar = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+            t_on = clock(); // timer before calling func
+            for(int i = 0; i < blocks; ++i)
+                oscilLinear(smps, OSCILSIZE - 1, ph, OSCIL_LANES, out, BUFSIZE);
+            t_off = clock(); // timer when func returns
+            const float kernel = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+            report("", scalar, kernel);
+
+            const int32_t offset[OSCIL_LANES] = {0};
+            fillModulation(OSCIL_LANES);
+            t_on = clock(); // timer before calling func
+            for(int i = 0; i < blocks; ++i)
+                scalarModulated(ph, offset, OSCIL_LANES, ref);
+            t_off = clock(); // timer when func returns
+            const float scalarpm = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+            t_on = clock(); // timer before calling func
+            for(int i = 0; i < blocks; ++i)
+                oscilModulated(smps, OSCILSIZE - 1, ph, offset, OSCIL_LANES,
+                               out, BUFSIZE);
+            t_off = clock(); // timer when func returns
+            const float kernelpm = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+            report(" PM", scalarpm, kernelpm);
+
+            ModulatorPhase mph;
+            for(int k = 0; k < OSCIL_LANES; ++k) {
+                mph.hi[k]     = 0;
+                mph.lo[k]     = 0.0f;
+                mph.freqhi[k] = 2 + k % 3;
+                mph.freqlo[k] = 0.37f + 0.05f * k;
+            }
+            t_on = clock(); // timer before calling func
+            for(int i = 0; i < blocks; ++i)
+                scalarModulator(mph, OSCIL_LANES, ref, 0.2f, 0.9f, true);
+            t_off = clock(); // timer when func returns
+            const float scalarring = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+            t_on = clock(); // timer before calling func
+            for(int i = 0; i < blocks; ++i)
+                modulatorMix(smps, OSCILSIZE - 1, mph, OSCIL_LANES, out,
+                             BUFSIZE, 0.2f, 0.9f, true);
+            t_off = clock(); // timer when func returns
+            const float kernelring = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+            report(" ring", scalarring, kernelring);
+
+            float lvol[OSCIL_LANES], rvol[OSCIL_LANES];
+            for(int k = 0; k < OSCIL_LANES; ++k) {
+                lvol[k] = 0.5f;
+                rvol[k] = -0.25f;
+            }
+
+            t_on = clock(); // timer before calling func
+            for(int i = 0; i < blocks; ++i)
+                for(int k = 0; k < OSCIL_LANES; ++k) {
+                    for(int j = 0; j < BUFSIZE; ++j)
+                        refl[j] += out[k][j] * lvol[k];
+                    for(int j = 0; j < BUFSIZE; ++j)
+                        refr[j] += out[k][j] * rvol[k];
+                }
+            t_off = clock(); // timer when func returns
+            const float scalarmix = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+            t_on = clock(); // timer before calling func
+            for(int i = 0; i < blocks; ++i)
+                unisonMix(out, lvol, rvol, OSCIL_LANES, outl, outr, BUFSIZE);
+            t_off = clock(); // timer when func returns
+            const float kernelmix = (t_off - t_on) / (float)CLOCKS_PER_SEC;
+
+            report(" mix", scalarmix, kernelmix);
+        }
+};
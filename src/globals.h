@@ -60,10 +60,12 @@ struct WatchManager;
 class  LFO;
 class  Envelope;
 class  OscilGen;
+class  OscilBuffer;
 
 class  Controller;
 class  Master;
 class  Part;
+class  PADpool;
 
 class  Filter;
 class  AnalogFilter;
@@ -71,7 +73,13 @@ class  SVFilter;
 class  FormantFilter;
 class  ModFilter;
 
+//Precision of the spectra (see FFTwrapper); the single precision build
+//halves the memory the biggest transforms pass through
+#ifdef FFTW_SINGLE_PRECISION
+typedef float fftw_real;
+#else
 typedef double fftw_real;
+#endif
 typedef std::complex<fftw_real> fft_t;
 
 /**
@@ -267,6 +267,9 @@ int main(int argc, char *argv[])
         {
             "oscil-size", 2, NULL, 'o'
         },
+        {
+            "render-threads", 1, NULL, 'R'
+        },
         {
             "swap", 2, NULL, 'S'
         },
@@ -330,7 +333,7 @@ int wmidi = -1;
         /**\todo check this process for a small memory leak*/
         opt = getopt_long(argc,
                           argv,
-                          "l:L:M:r:b:o:I:O:N:e:P:A:d:D:hvapSDUYZ",
+                          "l:L:M:r:b:o:R:I:O:N:e:P:A:d:D:hvapSDUYZ",
                           opts,
                           &option_index);
         char *optarguments = optarg;
@@ -400,6 +403,14 @@ int wmidi = -1;
                     "synth.oscilsize is wrong (must be 2^n) or too small. Adjusting to "
                     << synth.oscilsize << "." << endl;
                 break;
+            case 'R':
+                GETOPNUM(config.cfg.RenderThreads);
+                if(config.cfg.RenderThreads < 0) {
+                    cerr << "ERROR:Incorrect number of render threads: "
+                         << optarguments << endl;
+                    exit(1);
+                }
+                break;
             case 'S':
                 swaplr = 1;
                 break;
@@ -480,6 +491,8 @@ int wmidi = -1;
              <<
         "  -b BS, --buffer-size=SR\t\t Set the buffer size (granularity)\n"
              << "  -o OS, --oscil-size=OS\t\t Set the ADsynth oscil. size\n"
+             << "  -R N, --render-threads=N\t\t Render parts with N helper threads\n"
+             << "\t\t\t\t\t (0 renders within the audio thread)\n"
              << "  -S , --swap\t\t\t\t Swap Left <--> Right\n"
              <<
         "  -U , --no-gui\t\t\t\t Run ZynAddSubFX without user interface\n"
@@ -506,6 +519,8 @@ int wmidi = -1;
     cerr << "Sound Buffer Size = \t" << synth.buffersize << " samples" << endl;
     cerr << "Internal latency = \t" << synth.dt() * 1000.0f << " ms" << endl;
     cerr << "ADsynth Oscil.Size = \t" << synth.oscilsize << " samples" << endl;
+    if(config.cfg.RenderThreads)
+        cerr << "Render Threads = \t" << config.cfg.RenderThreads << endl;
 
     initprogram(std::move(synth), &config, prefered_port);
 